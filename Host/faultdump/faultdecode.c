@@ -0,0 +1,314 @@
+/*
+ * faultdecode.c
+ *
+ * Print a fault record (Library/FaultDump.h) for post-mortem analysis.
+ *
+ * The input is what the robot sends on the backchannel UART when it is
+ * reset with S2 held (the flight log and, if there is one, the fault record
+ * of the last crash), or a memory save of fault_record from the debugger.
+ * With the .map file of the same build the PC, LR and every word on the
+ * stack that points into code are named:
+ *
+ *   stty -F /dev/ttyACM0 460800 raw -echo; cat /dev/ttyACM0 > log.bin
+ *   (hold S2, press reset, release S2 once the LEDs come on, Ctrl-C)
+ *   build/faultdecode -m ../Lab9/Release/Lab9.map log.bin
+ *
+ * Functions are found in the map's section allocation (".text:name" input
+ * sections, statics included, as CCS compiles each function into its own
+ * subsection) and its global symbol list, where Thumb functions are the
+ * odd addresses.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <ctype.h>
+#include <unistd.h>
+#include "FaultDump.h"
+
+#define MAX_INPUT       (1024 * 1024)
+#define MAX_SYMBOLS     8192
+#define MAX_NAME        64
+#define NEAR_SYMBOL     0x1000      // furthest a global symbol is used for an address past it
+
+#define RECORD_WORDS    (sizeof(fault_record_t) / 4)
+
+typedef struct
+{
+    uint32_t start;
+    uint32_t length;                // 0 for a global symbol
+    char name[MAX_NAME];
+} symbol_t;
+
+static symbol_t symbols[MAX_SYMBOLS];
+static unsigned numSymbols;
+
+typedef struct
+{
+    unsigned bit;
+    const char *name;
+    const char *meaning;
+} fault_bit_t;
+
+static const fault_bit_t cfsrBits[] =
+{
+    { 0,  "IACCVIOL",    "instruction fetch from a no-execute or protected region" },
+    { 1,  "DACCVIOL",    "data access to a protected region, see MMFAR" },
+    { 3,  "MUNSTKERR",   "MPU fault unstacking on exception return" },
+    { 4,  "MSTKERR",     "MPU fault stacking on exception entry, stack overflow?" },
+    { 5,  "MLSPERR",     "MPU fault during lazy FPU state saving" },
+    { 8,  "IBUSERR",     "bus error on instruction fetch" },
+    { 9,  "PRECISERR",   "precise data bus error, see BFAR" },
+    { 10, "IMPRECISERR", "imprecise data bus error, the PC is past the access" },
+    { 11, "UNSTKERR",    "bus error unstacking on exception return" },
+    { 12, "STKERR",      "bus error stacking on exception entry, stack overflow?" },
+    { 13, "LSPERR",      "bus error during lazy FPU state saving" },
+    { 16, "UNDEFINSTR",  "undefined instruction" },
+    { 17, "INVSTATE",    "invalid state, a call through a pointer without the Thumb bit?" },
+    { 18, "INVPC",       "invalid EXC_RETURN on exception return" },
+    { 19, "NOCP",        "coprocessor access with the FPU disabled" },
+    { 24, "UNALIGNED",   "unaligned access" },
+    { 25, "DIVBYZERO",   "integer divide by zero" },
+};
+
+static const fault_bit_t hfsrBits[] =
+{
+    { 1,  "VECTTBL",     "bus error reading the vector table" },
+    { 30, "FORCED",      "escalated from a configurable fault, see CFSR" },
+    { 31, "DEBUGEVT",    "debug event" },
+};
+
+static const char *exceptionNames[] =
+{
+    "?", "Reset", "NMI", "HardFault", "MemManage", "BusFault", "UsageFault"
+};
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "usage: %s [options] [file]\n"
+            "  -m file         .map file of the build that faulted\n"
+            "Reads stdin if no file is given.\n",
+            prog);
+    exit(1);
+}
+
+static uint32_t get32(const uint8_t *p)
+{
+    return p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void add_symbol(uint32_t start, uint32_t length, const char *name)
+{
+    symbol_t *s;
+
+    if (numSymbols >= MAX_SYMBOLS)
+        return;
+
+    s = &symbols[numSymbols++];
+    s->start = start & ~1u;         // Thumb bit
+    s->length = length;
+    snprintf(s->name, sizeof(s->name), "%.63s", name);
+}
+
+/*
+ * TI linker map:
+ *                   00001234    00000056     main.obj (.text:start_move)
+ *   00001235  main
+ */
+static bool load_map(const char *file)
+{
+    char line[512], name[256];
+    unsigned start, length;
+    const char *sub;
+    FILE *f = fopen(file, "r");
+
+    if (!f)
+    {
+        perror(file);
+        return false;
+    }
+
+    while (fgets(line, sizeof(line), f))
+    {
+        if ((sub = strstr(line, "(.text:")) || (sub = strstr(line, "(.TI.ramfunc:")))
+        {
+            if ((sscanf(line, " %x %x", &start, &length) == 2) &&
+                (sscanf(strchr(sub, ':') + 1, "%255[^)]", name) == 1))
+                add_symbol(start, length, name);
+        }
+        else if ((line[0] != ' ') && (strlen(line) > 10) && (line[8] == ' ') &&
+                 (sscanf(line, "%8x %255s", &start, name) == 2) &&
+                 (start & 1) && (name[0] == '_' || isalpha((unsigned char)name[0])))
+        {
+            add_symbol(start, 0, name);
+        }
+    }
+
+    fclose(f);
+    return true;
+}
+
+/* Name of the code at addr, NULL if it is not in any function */
+static const char *symbolize(uint32_t addr, char *buf, size_t size)
+{
+    const symbol_t *best = NULL;
+    unsigned i;
+
+    addr &= ~1u;
+
+    for (i = 0; i < numSymbols; i++)
+    {
+        const symbol_t *s = &symbols[i];
+
+        if (s->length && (addr >= s->start) && (addr < s->start + s->length))
+        {
+            best = s;
+            break;
+        }
+
+        if (!s->length && (addr >= s->start) && (addr - s->start < NEAR_SYMBOL) &&
+            (!best || (s->start > best->start)))
+            best = s;
+    }
+
+    if (!best)
+        return NULL;
+
+    snprintf(buf, size, "%s+0x%X", best->name, (unsigned)(addr - best->start));
+    return buf;
+}
+
+static void print_address(const char *label, uint32_t value)
+{
+    char buf[128];
+    const char *name = symbolize(value, buf, sizeof(buf));
+
+    printf("  %-5s 0x%08X%s%s\n", label, value, name ? "  " : "", name ? name : "");
+}
+
+static void print_bits(const char *label, uint32_t value, const fault_bit_t *bits, unsigned n)
+{
+    unsigned i;
+
+    printf("  %-5s 0x%08X\n", label, value);
+    for (i = 0; i < n; i++)
+        if (value & (1u << bits[i].bit))
+            printf("          %-12s %s\n", bits[i].name, bits[i].meaning);
+}
+
+static void print_record(const fault_record_t *r)
+{
+    char buf[128];
+    const char *name;
+    unsigned i;
+
+    printf("fault %u since power-on: %s", r->count,
+           (r->exception < sizeof(exceptionNames) / sizeof(exceptionNames[0])) ? exceptionNames[r->exception] : "?");
+    printf(", %s stack%s\n", (r->flags & FAULT_FLAG_PSP) ? "process" : "main",
+           (r->flags & FAULT_FLAG_FP_FRAME) ? ", FPU registers stacked" : "");
+
+    if (r->flags & FAULT_FLAG_BAD_SP)
+    {
+        printf("  stack pointer 0x%08X is outside SRAM, no registers\n", r->sp);
+    }
+    else if (r->flags & FAULT_FLAG_NO_FRAME)
+    {
+        printf("  the exception frame could not be pushed, stack overflow? No registers\n");
+        printf("  SP    0x%08X\n", r->sp);
+    }
+    else
+    {
+        print_address("PC", r->pc);
+        print_address("LR", r->lr);
+        printf("  xPSR  0x%08X\n", r->xpsr);
+        printf("  r0    0x%08X  r1 0x%08X  r2 0x%08X  r3 0x%08X  r12 0x%08X\n",
+               r->r0, r->r1, r->r2, r->r3, r->r12);
+        printf("  SP    0x%08X\n", r->sp);
+    }
+
+    print_bits("CFSR", r->cfsr, cfsrBits, sizeof(cfsrBits) / sizeof(cfsrBits[0]));
+    if (r->cfsr & 0x80)
+        printf("  MMFAR 0x%08X\n", r->mmfar);
+    if (r->cfsr & 0x8000)
+        printf("  BFAR  0x%08X\n", r->bfar);
+    print_bits("HFSR", r->hfsr, hfsrBits, sizeof(hfsrBits) / sizeof(hfsrBits[0]));
+
+    if (r->flags & FAULT_FLAG_BAD_SP)
+        return;
+
+    printf("stack above the frame%s:\n", numSymbols ? ", code addresses named" : "");
+    for (i = 0; i < FAULT_STACK_WORDS; i++)
+    {
+        name = symbolize(r->stack[i], buf, sizeof(buf));
+        printf("  0x%08X  0x%08X%s%s\n", r->sp + 4 * i, r->stack[i], name ? "  " : "", name ? name : "");
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    static uint8_t buf[MAX_INPUT];
+    uint32_t words[RECORD_WORDS];
+    fault_record_t record;
+    const fault_record_t *found = NULL;
+    FILE *in = stdin;
+    size_t len, pos;
+    uint32_t sum;
+    unsigned i;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "m:h")) != -1)
+    {
+        switch (opt)
+        {
+        case 'm':
+            if (!load_map(optarg))
+                return 1;
+            break;
+        default:  usage(argv[0]);
+        }
+    }
+
+    if (optind + 1 < argc)
+        usage(argv[0]);
+
+    if (optind < argc && !(in = fopen(argv[optind], "rb")))
+    {
+        perror(argv[optind]);
+        return 1;
+    }
+
+    len = fread(buf, 1, sizeof(buf), in);
+
+    /* The last valid record in the input */
+    for (pos = 0; pos + sizeof(fault_record_t) <= len; pos++)
+    {
+        if (get32(buf + pos) != FAULT_MAGIC)
+            continue;
+
+        for (i = 0, sum = 0; i < RECORD_WORDS; i++)
+        {
+            words[i] = get32(buf + pos + 4 * i);
+            if (i < RECORD_WORDS - 1)
+                sum += words[i];
+        }
+
+        if (sum == words[RECORD_WORDS - 1])
+        {
+            memcpy(&record, words, sizeof(record));
+            found = &record;
+        }
+    }
+
+    if (!found)
+    {
+        fprintf(stderr, "no fault record found\n");
+        return 1;
+    }
+
+    print_record(found);
+
+    return 0;
+}
@@ -0,0 +1,305 @@
+/*
+ * fldecode.c
+ *
+ * Print a Lab9 flight log (Library/FlightLog.h) as a time line.
+ *
+ * The input is either what the robot sends on the backchannel UART when it
+ * is reset with S2 held, or a raw read of the FLIGHT_LOG flash region (both
+ * slots).  The file is searched for valid logs and the newest one is shown,
+ * or all of them with -a.
+ *
+ *   stty -F /dev/ttyACM0 460800 raw -echo; cat /dev/ttyACM0 > log.bin
+ *   (hold S2, press reset, release S2 once the LEDs come on, Ctrl-C)
+ *   build/fldecode log.bin
+ *
+ * State, event and supervisor task numbers are named after Lab9's main.c by
+ * default; -s, -e and -w give other names as comma separated lists in enum
+ * order.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+#include "FlightLog.h"
+
+#define HEADER_SIZE     16
+#define ENTRY_SIZE      16
+#define MAX_NAMES       64
+#define MAX_INPUT       (1024 * 1024)
+
+static const char *stateNames[MAX_NAMES] =
+{
+    "START", "WAIT", "DRIVEFORWARD", "TURNLEFT", "TURN1", "BACKWARDS", "ALL_DONE"
+};
+
+static const char *eventNames[MAX_NAMES] =
+{
+    "GO", "STOP", "BUMP0", "BUMP1", "BUMP2", "BUMP3", "BUMP4", "BUMP5", "DONE",
+    "STALL", "WHEEL_FAULT"
+};
+
+static const char *clockNames[] =
+{
+    "3 MHz DCO, clock not started", "3 MHz DCO, crystal starting", "48 MHz crystal",
+    "48 MHz DCO, CRYSTAL FAILED", "3 MHz DCO, VCORE1 FAILED"
+};
+
+static const char *reasonNames[] =
+{
+    "?", "end of run", "emergency stop", "fault", "request", "watchdog"
+};
+
+static const char *wheelNames[] =
+{
+    "wheels ok", "STALL", "ENCODER FAULT", "slip"
+};
+
+static const char *taskNames[MAX_NAMES] =
+{
+    "main loop"
+};
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "usage: %s [options] [file]\n"
+            "  -a              show every valid log found, oldest first\n"
+            "  -s a,b,...      state names\n"
+            "  -e a,b,...      event names\n"
+            "  -w a,b,...      supervisor task names\n"
+            "Reads stdin if no file is given.\n",
+            prog);
+    exit(1);
+}
+
+static void parse_names(const char **names, char *list)
+{
+    unsigned n = 0;
+    char *name;
+
+    memset(names, 0, MAX_NAMES * sizeof(names[0]));
+
+    for (name = strtok(list, ","); name && n < MAX_NAMES; name = strtok(NULL, ","))
+        names[n++] = name;
+}
+
+static uint32_t get32(const uint8_t *p)
+{
+    return p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint16_t get16(const uint8_t *p)
+{
+    return p[0] | (p[1] << 8);
+}
+
+static const char *name(const char **names, unsigned n, char *buf)
+{
+    if (n < MAX_NAMES && names[n])
+        return names[n];
+
+    sprintf(buf, "%u", n);
+    return buf;
+}
+
+/* Length of a valid log at p, 0 if there is none */
+static size_t valid_log(const uint8_t *p, size_t avail)
+{
+    uint32_t sum = 0;
+    unsigned count;
+    size_t length, i;
+
+    if (avail < HEADER_SIZE || get32(p) != FLIGHT_LOG_MAGIC)
+        return 0;
+
+    count = p[7];
+    length = HEADER_SIZE + (size_t)count * ENTRY_SIZE;
+    if (avail < length)
+        return 0;
+
+    for (i = 0; i < 12; i += 4)
+        sum += get32(p + i);
+    for (i = HEADER_SIZE; i < length; i += 4)
+        sum += get32(p + i);
+
+    return (sum == get32(p + 12)) ? length : 0;
+}
+
+static void print_entry(const uint8_t *e)
+{
+    char b0[16], b1[16], b2[16];
+    uint32_t time = get32(e);
+    uint8_t p0 = e[5], p1 = e[6], p2 = e[7];
+    int32_t v0 = (int32_t)get32(e + 8);
+    int32_t v1 = (int32_t)get32(e + 12);
+    unsigned i;
+
+    printf("%4u.%03u  ", time / 1000, time % 1000);
+
+    switch (e[4])
+    {
+    case FL_BOOT:
+        printf("boot, previous flush %d\n", v0);
+        break;
+    case FL_TRANSITION:
+        if (p2 == 0xFF)
+            printf("%s -> %s\n", name(stateNames, p0, b0), name(stateNames, p1, b1));
+        else
+            printf("%s -> %s on %s\n", name(stateNames, p0, b0), name(stateNames, p1, b1),
+                   name(eventNames, p2, b2));
+        break;
+    case FL_BUMP:
+        printf("bump");
+        if (!p0)
+            printf(" released");
+        for (i = 0; i < 6; i++)
+            if (p0 & (1 << i))
+                printf(" %u", i);
+        printf("\n");
+        break;
+    case FL_BUTTON:
+        printf("button S%u\n", p0);
+        break;
+    case FL_ENCODER:
+        printf("encoders L %d R %d\n", v0, v1);
+        break;
+    case FL_MOVE_ERROR:
+        printf("move done, past target L %+d R %+d\n", v0, v1);
+        break;
+    case FL_FAULT:
+        printf("FAULT exception %u at PC 0x%08X, CFSR 0x%08X\n", p0, (uint32_t)v0, (uint32_t)v1);
+        break;
+    case FL_BOOT_REPORT:
+        printf("ready %u.%03u ms after reset, %s", (uint32_t)v0 / 1000, (uint32_t)v0 % 1000,
+               (p0 < sizeof(clockNames) / sizeof(clockNames[0])) ? clockNames[p0] : "?");
+        if (v1)
+            printf(" (started in %u us)", (uint32_t)v1);
+        printf("\n");
+        break;
+    case FL_WATCHDOG:
+        if (p0 == FL_WATCHDOG_RESET)
+            printf("WATCHDOG reset the device\n");
+        else
+            printf("WATCHDOG: %s silent for %d ms\n", name(taskNames, p0, b0), v0);
+        break;
+    case FL_STACK:
+        printf("stack high-water mark %d of %d bytes\n", v0, v1);
+        break;
+    case FL_WHEEL:
+        printf("%s%s%s, L %d R %d counts/s\n",
+               (p0 < sizeof(wheelNames) / sizeof(wheelNames[0])) ? wheelNames[p0] : "?",
+               (p1 & 1) ? " left" : "", (p1 & 2) ? " right" : "", v0, v1);
+        break;
+    case FL_MOTOR_MODEL:
+        if (p0 > 1)
+            printf("motor calibration failed\n");
+        else
+            printf("motor model %s: dead band %.3f, %d counts/s per duty, tau %u ms\n",
+                   p0 ? "right" : "left", v0 / 1000.0, v1, p1);
+        break;
+    case FL_PID_TUNE:
+        if (p0 < 2)
+            printf("relay %s: Ku %.3f, Tu %u calls, amplitude %d counts\n",
+                   p0 ? "right" : "left", v0 / 1000.0, p1, v1);
+        else if (p0 == 2)
+            printf("PI gains P %.3f I %.6f\n", v0 / 1000.0, v1 / 1000000.0);
+        else
+            printf("PI autotune failed\n");
+        break;
+    case FL_FLUSH:
+        printf("flush, %s\n", (p0 < sizeof(reasonNames) / sizeof(reasonNames[0])) ? reasonNames[p0] : "?");
+        break;
+    default:
+        printf("event %u: %u %u %u %d %d\n", e[4], p0, p1, p2, v0, v1);
+        break;
+    }
+}
+
+static void print_log(const uint8_t *p)
+{
+    unsigned count = p[7];
+    uint32_t recorded = get32(p + 8);
+    unsigned reason = p[6];
+    unsigned i;
+
+    printf("flush %u, %s, %u events", get16(p + 4),
+           (reason < sizeof(reasonNames) / sizeof(reasonNames[0])) ? reasonNames[reason] : "?", count);
+    if (recorded > count)
+        printf(" (the first %u since boot were overwritten)", recorded - count);
+    printf("\n");
+
+    for (i = 0; i < count; i++)
+        print_entry(p + HEADER_SIZE + i * ENTRY_SIZE);
+}
+
+int main(int argc, char *argv[])
+{
+    static uint8_t buf[MAX_INPUT];
+    const uint8_t *logs[64];
+    unsigned numLogs = 0, newest = 0, i, j;
+    bool all = false;
+    FILE *in = stdin;
+    size_t len, pos, n;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "as:e:w:h")) != -1)
+    {
+        switch (opt)
+        {
+        case 'a': all = true; break;
+        case 's': parse_names(stateNames, optarg); break;
+        case 'e': parse_names(eventNames, optarg); break;
+        case 'w': parse_names(taskNames, optarg); break;
+        default:  usage(argv[0]);
+        }
+    }
+
+    if (optind + 1 < argc)
+        usage(argv[0]);
+
+    if (optind < argc && !(in = fopen(argv[optind], "rb")))
+    {
+        perror(argv[optind]);
+        return 1;
+    }
+
+    len = fread(buf, 1, sizeof(buf), in);
+
+    for (pos = 0; pos < len && numLogs < 64; pos++)
+    {
+        if ((n = valid_log(buf + pos, len - pos)))
+        {
+            logs[numLogs++] = buf + pos;
+            pos += n - 1;
+        }
+    }
+
+    if (!numLogs)
+    {
+        fprintf(stderr, "no flight log found\n");
+        return 1;
+    }
+
+    /* Sort by flush number, which wraps at 16 bits */
+    for (i = 1; i < numLogs; i++)
+        for (j = i; j > 0 && (int16_t)(get16(logs[j] + 4) - get16(logs[j - 1] + 4)) < 0; j--)
+        {
+            const uint8_t *t = logs[j];
+            logs[j] = logs[j - 1];
+            logs[j - 1] = t;
+        }
+
+    newest = numLogs - 1;
+
+    for (i = all ? 0 : newest; i < numLogs; i++)
+    {
+        print_log(logs[i]);
+        if (i != newest)
+            printf("\n");
+    }
+
+    return 0;
+}
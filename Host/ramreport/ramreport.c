@@ -0,0 +1,277 @@
+/*
+ * ramreport.c
+ *
+ * RAM budget of a CCS build, from its linker .map file.
+ *
+ * Lists every output section in the MSP432's 64 KB of SRAM (both the
+ * SRAM_DATA and the SRAM_CODE alias of it) with its size, what is left, and
+ * the largest variables, so buffers can be sized against what is free:
+ *
+ *   build/ramreport ../Lab9/Debug/Lab9.map
+ *   build/ramreport -s 344 ../Lab9/Debug/Lab9.map
+ *
+ * -s gives the stack high-water mark the robot measured (the flight log's
+ * "stack high-water mark" entry, or stack_monitor.high_water in the
+ * debugger) to show the stack's headroom as well.  Sizes are bytes.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+#include "StackMonitor.h"
+
+#define SRAM_SIZE           0x10000
+#define SRAM_DATA_START     0x20000000
+#define SRAM_CODE_START     0x01000000
+
+#define MAX_SECTIONS        64
+#define MAX_OBJECTS         4096
+#define MAX_NAME            64
+#define MAX_DESCRIPTION     96
+
+typedef struct
+{
+    char name[MAX_NAME];
+    uint32_t origin;
+    uint32_t length;
+} section_t;
+
+typedef struct
+{
+    unsigned section;
+    uint32_t length;
+    char description[MAX_DESCRIPTION];
+} object_t;
+
+static section_t sections[MAX_SECTIONS];
+static unsigned numSections;
+static object_t objects[MAX_OBJECTS];
+static unsigned numObjects;
+
+static const struct
+{
+    const char *name;
+    const char *use;
+} sectionUses[] =
+{
+    { ".vtable",     "interrupt vectors in RAM" },
+    { ".data",       "initialised variables" },
+    { ".bss",        "zeroed variables" },
+    { ".sysmem",     "heap, malloc()" },
+    { ".TI.noinit",  "kept over a reset" },
+    { ".stack",      "stack" },
+    { ".TI.ramfunc", "code run from SRAM" },
+};
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "usage: %s [options] file.map\n"
+            "  -n count        largest variables to list, default 10\n"
+            "  -s bytes        stack high-water mark measured on the robot\n",
+            prog);
+    exit(1);
+}
+
+static bool in_sram(uint32_t address)
+{
+    return ((address >= SRAM_DATA_START) && (address < SRAM_DATA_START + SRAM_SIZE)) ||
+           ((address >= SRAM_CODE_START) && (address < SRAM_CODE_START + SRAM_SIZE));
+}
+
+static const char *section_use(const char *name)
+{
+    unsigned i;
+
+    for (i = 0; i < sizeof(sectionUses) / sizeof(sectionUses[0]); i++)
+        if (!strcmp(name, sectionUses[i].name))
+            return sectionUses[i].use;
+
+    return "";
+}
+
+static void add_section(const char *name, uint32_t origin, uint32_t length)
+{
+    section_t *s;
+
+    if (numSections >= MAX_SECTIONS)
+        return;
+
+    s = &sections[numSections++];
+    snprintf(s->name, sizeof(s->name), "%.63s", name);
+    s->origin = origin;
+    s->length = length;
+}
+
+static void add_object(uint32_t length, const char *description)
+{
+    object_t *o;
+    size_t n;
+
+    if ((numObjects >= MAX_OBJECTS) || !numSections || strstr(description, "--HOLE--"))
+        return;
+
+    o = &objects[numObjects++];
+    o->section = numSections - 1;
+    o->length = length;
+    snprintf(o->description, sizeof(o->description), "%.95s", description);
+
+    n = strlen(o->description);
+    while (n && (o->description[n - 1] == '\n' || o->description[n - 1] == '\r' || o->description[n - 1] == ' '))
+        o->description[--n] = 0;
+}
+
+/*
+ * TI linker map, section allocation:
+ *
+ *   .bss       0    20000000    000003ac     UNINITIALIZED
+ *                     20000000    00000200     main.obj (.bss:buf)
+ *   .TI.ramfunc
+ *   *          0    00004f00    00000060     RUN ADDR = 01000000
+ *
+ * Only sections that run from SRAM are kept, with their input sections.
+ */
+static bool load_map(const char *file)
+{
+    char line[512], name[256] = "";
+    unsigned page, origin, length;
+    const char *run, *description;
+    bool inMap = false, keep = false;
+    int used;
+    FILE *f = fopen(file, "r");
+
+    if (!f)
+    {
+        perror(file);
+        return false;
+    }
+
+    while (fgets(line, sizeof(line), f))
+    {
+        if (!strncmp(line, "SECTION ALLOCATION MAP", 22))
+        {
+            inMap = true;
+            continue;
+        }
+
+        if (!inMap)
+            continue;
+
+        if (!strncmp(line, "MODULE SUMMARY", 14) || !strncmp(line, "LINKER GENERATED", 16) ||
+            !strncmp(line, "GLOBAL SYMBOLS", 14))
+            break;
+
+        if (line[0] == '.' || line[0] == '*')
+        {
+            // A long name is on a line of its own, the rest follows after "*"
+            if (line[0] == '.')
+            {
+                if (sscanf(line, "%255s", name) != 1)
+                    continue;
+                if (sscanf(line, "%*s %u %x %x", &page, &origin, &length) != 3)
+                {
+                    keep = false;
+                    continue;
+                }
+            }
+            else if (sscanf(line, "* %u %x %x", &page, &origin, &length) != 3)
+            {
+                continue;
+            }
+
+            if ((run = strstr(line, "RUN ADDR = ")))
+                sscanf(run + 11, "%x", &origin);
+
+            keep = in_sram(origin);
+            if (keep)
+                add_section(name, origin, length);
+        }
+        else if (keep && (line[0] == ' ') && (sscanf(line, " %x %x %n", &origin, &length, &used) == 2))
+        {
+            description = line + used;
+            add_object(length, description);
+        }
+    }
+
+    fclose(f);
+    return inMap;
+}
+
+static int by_length(const void *a, const void *b)
+{
+    const object_t *x = a, *y = b;
+
+    return (x->length < y->length) - (x->length > y->length);
+}
+
+int main(int argc, char *argv[])
+{
+    uint32_t used = 0, stackSize = 0;
+    long highWater = -1;
+    unsigned count = 10, listed, i;
+    const section_t *s;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:s:h")) != -1)
+    {
+        switch (opt)
+        {
+        case 'n': count = atoi(optarg); break;
+        case 's': highWater = atol(optarg); break;
+        default:  usage(argv[0]);
+        }
+    }
+
+    if (optind + 1 != argc)
+        usage(argv[0]);
+
+    if (!load_map(argv[optind]))
+    {
+        fprintf(stderr, "%s: no section allocation map\n", argv[optind]);
+        return 1;
+    }
+
+    for (i = 0; i < numSections; i++)
+    {
+        used += sections[i].length;
+        if (!strcmp(sections[i].name, ".stack"))
+            stackSize = sections[i].length;
+    }
+
+    printf("SRAM %u bytes: %u used, %u free\n", SRAM_SIZE, used, SRAM_SIZE - used);
+    for (i = 0; i < numSections; i++)
+    {
+        s = &sections[i];
+        printf("  %-14s 0x%08X %6u  %s\n", s->name, s->origin, s->length, section_use(s->name));
+    }
+
+    if (stackSize)
+    {
+        printf("stack %u bytes, %u above the MPU guard", stackSize,
+               (stackSize > STACK_GUARD_BYTES) ? stackSize - STACK_GUARD_BYTES : 0);
+        if (highWater >= 0)
+            printf(", high-water mark %ld, %ld to spare", highWater,
+                   (long)stackSize - STACK_GUARD_BYTES - highWater);
+        printf("\n");
+    }
+
+    qsort(objects, numObjects, sizeof(objects[0]), by_length);
+
+    printf("largest variables:\n");
+    for (i = 0, listed = 0; (i < numObjects) && (listed < count); i++)
+    {
+        s = &sections[objects[i].section];
+
+        // The stack and the heap are one block each, already shown above
+        if (!strcmp(s->name, ".stack") || !strcmp(s->name, ".sysmem"))
+            continue;
+
+        printf("  %6u  %-12s %s\n", objects[i].length, s->name, objects[i].description);
+        listed++;
+    }
+
+    return 0;
+}
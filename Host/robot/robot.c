@@ -0,0 +1,275 @@
+/*
+ * robot.c
+ *
+ * Differential drive robot model.  See robot.h.
+ */
+
+#include <math.h>
+#include <string.h>
+#include "sim.h"
+#include "robot.h"
+
+#define STEP_S          (ROBOT_STEP_US * 1e-6)
+#define BUMP_HALF_WIDTH (18.0 * M_PI / 180.0)
+#define CONTACT_GAP     0.002       /* m, bumper travel before a switch closes */
+
+static const uint8_t bumpPin[6] = { 0x01, 0x04, 0x08, 0x20, 0x40, 0x80 };
+static const double bumpAngle[6] = { -72, -42, -12, 12, 42, 72 };    /* degrees, 0 = straight ahead */
+
+/* Encoder pins per side: A on P5, B on P10 */
+static const uint8_t encoderA[2] = { 0x04, 0x01 };
+static const uint8_t encoderB[2] = { 0x20, 0x10 };
+
+/* Quadrature states in forward order, A rises with B low going forward */
+static const uint8_t quadA[4] = { 0, 1, 1, 0 };
+static const uint8_t quadB[4] = { 0, 0, 1, 1 };
+
+static struct
+{
+    robot_params_t p;
+    const world_t *world;
+    robot_state_t s;
+    double alpha;                   /* first order lag per step */
+    double quarter[2];              /* encoder position in quarter cycles */
+    int64_t quad[2];                /* last quarter cycle driven onto the pins */
+
+    uint32_t random;
+
+    uint8_t qtrDir;                 /* P7 DIR last seen by the sensor model */
+    uint64_t qtrDecayEnd[8];
+} robot;
+
+void robot_default_params(robot_params_t *p)
+{
+    p->wheelDiameter = 0.070;
+    p->track = 0.140;
+    p->bodyRadius = 0.082;
+    p->countsPerRev = 360;
+    p->maxRpm[ROBOT_LEFT] = 150;
+    p->maxRpm[ROBOT_RIGHT] = 150;
+    p->deadband = 0.03;
+    p->tau = 0.050;
+    p->qtrOffset = 0.065;
+    p->qtrPitch = 0.009525;
+    p->qtrWhiteUs = 250;
+    p->qtrBlackUs = 2500;
+    p->edgeGlitch = 0.0;
+    p->grip = false;
+    p->encoderFail[ROBOT_LEFT] = -1;
+    p->encoderFail[ROBOT_RIGHT] = -1;
+    p->seed = 1;
+}
+
+const robot_state_t *robot_state(void)
+{
+    return &robot.s;
+}
+
+/* Encoder position in A channel cycles, positive forward */
+double robot_wheel_counts(unsigned side)
+{
+    return robot.quarter[side] / 4.0;
+}
+
+static double robot_wheel_target(unsigned side)
+{
+    static const unsigned ccr[2] = { 4, 3 };
+    static const uint8_t dirPin[2] = { 0x10, 0x20 };
+    double duty = sim_timer_a_duty(0, ccr[side]);
+    double speed;
+
+    if (duty <= robot.p.deadband)
+        return 0.0;
+
+    speed = (duty - robot.p.deadband) / (1.0 - robot.p.deadband) * robot.p.maxRpm[side] * 2 * M_PI / 60;
+
+    return (sim_gpio_output(5) & dirPin[side]) ? -speed : speed;
+}
+
+/* Uniform in [0, 1), xorshift32 */
+static double robot_random(void)
+{
+    robot.random ^= robot.random << 13;
+    robot.random ^= robot.random >> 17;
+    robot.random ^= robot.random << 5;
+
+    return robot.random / 4294967296.0;
+}
+
+/* Step the encoder pins through every quadrature state the wheel passed */
+static void robot_encoder(unsigned side)
+{
+    int64_t target = (int64_t)floor(robot.quarter[side]);
+    bool dead = (robot.p.encoderFail[side] >= 0) && (sim_seconds() >= robot.p.encoderFail[side]);
+    unsigned state;
+
+    while (robot.quad[side] != target)
+    {
+        robot.quad[side] += (target > robot.quad[side]) ? 1 : -1;
+        state = (unsigned)(robot.quad[side] & 3);
+
+        sim_gpio_drive(10, encoderB[side], quadB[state] ? encoderB[side] : 0);
+        if (dead)
+            continue;
+        sim_gpio_drive(5, encoderA[side], quadA[state] ? encoderA[side] : 0);
+
+        /* A bounce on A adds a rising edge unless it merges with a real one */
+        if ((robot.p.edgeGlitch > 0.0) && (robot_random() < robot.p.edgeGlitch))
+        {
+            sim_gpio_drive(5, encoderA[side], quadA[state] ? 0 : encoderA[side]);
+            sim_gpio_drive(5, encoderA[side], quadA[state] ? encoderA[side] : 0);
+        }
+    }
+}
+
+static uint8_t robot_bumps(void)
+{
+    double cx, cy, d, angle;
+    uint8_t pressed = 0;
+    unsigned i;
+
+    d = world_wall_distance(robot.world, robot.s.x, robot.s.y, &cx, &cy);
+    if (d > robot.p.bodyRadius + CONTACT_GAP)
+        return 0;
+
+    angle = atan2(cy - robot.s.y, cx - robot.s.x) - robot.s.heading;
+    angle = remainder(angle, 2 * M_PI);
+
+    for (i = 0; i < 6; i++)
+    {
+        if (fabs(angle - bumpAngle[i] * M_PI / 180.0) <= BUMP_HALF_WIDTH)
+            pressed |= 1u << i;
+    }
+
+    return pressed;
+}
+
+static void robot_step(void *ctx)
+{
+    double r = robot.p.wheelDiameter / 2;
+    double v, w, nx, ny, cx, cy, dNew;
+    uint8_t bumps, changed;
+    unsigned side, i;
+
+    (void)ctx;
+
+    for (side = 0; side < 2; side++)
+        robot.s.omega[side] += (robot_wheel_target(side) - robot.s.omega[side]) * robot.alpha;
+
+    v = (robot.s.omega[ROBOT_LEFT] + robot.s.omega[ROBOT_RIGHT]) / 2 * r;
+    w = (robot.s.omega[ROBOT_RIGHT] - robot.s.omega[ROBOT_LEFT]) * r / robot.p.track;
+
+    nx = robot.s.x + v * cos(robot.s.heading) * STEP_S;
+    ny = robot.s.y + v * sin(robot.s.heading) * STEP_S;
+
+    /* A wall stops any move that takes the body further into it */
+    dNew = world_wall_distance(robot.world, nx, ny, &cx, &cy);
+    if ((dNew >= robot.p.bodyRadius) ||
+        (dNew > world_wall_distance(robot.world, robot.s.x, robot.s.y, &cx, &cy)))
+    {
+        robot.s.distance += fabs(v) * STEP_S;
+        robot.s.x = nx;
+        robot.s.y = ny;
+    }
+    else if (robot.p.grip && (v != 0.0))
+    {
+        /* Pinned: the wheels stall rather than spin */
+        robot.s.omega[ROBOT_LEFT] = robot.s.omega[ROBOT_RIGHT] = 0.0;
+        w = 0.0;
+    }
+
+    for (side = 0; side < 2; side++)
+    {
+        robot.quarter[side] += robot.s.omega[side] * STEP_S / (2 * M_PI) * robot.p.countsPerRev * 4;
+        robot_encoder(side);
+    }
+
+    robot.s.heading = remainder(robot.s.heading + w * STEP_S, 2 * M_PI);
+
+    bumps = robot_bumps();
+    changed = bumps ^ robot.s.bumps;
+    for (i = 0; i < 6; i++)
+    {
+        if (!(changed & (1u << i)))
+            continue;
+
+        if (bumps & (1u << i))
+        {
+            sim_gpio_drive(4, bumpPin[i], 0);
+            robot.s.wallContacts++;
+        }
+        else
+        {
+            sim_gpio_release(4, bumpPin[i]);
+        }
+    }
+    robot.s.bumps = bumps;
+}
+
+/*
+ * QTR-8RC: the firmware charges each sensor's capacitor by driving the pin
+ * high, then makes it an input and times how long it reads 1.  Reflective
+ * floor discharges it quickly; black tape, or the IR LEDs being off, slowly.
+ */
+static void robot_qtr(void *ctx, unsigned port)
+{
+    uint8_t dir = sim_gpio_dir(7);
+    uint8_t released = robot.qtrDir & ~dir;
+    uint8_t charged = sim_gpio_output(7);
+    bool ledOn = (sim_gpio_output(5) & 0x08) != 0;
+    double c = cos(robot.s.heading), s = sin(robot.s.heading);
+    double offset, sx, sy, us;
+    uint8_t levels = 0;
+    unsigned i;
+
+    (void)ctx;
+    (void)port;
+
+    for (i = 0; i < 8; i++)
+    {
+        uint8_t bit = 1u << i;
+
+        if (released & bit)
+        {
+            /* P7.0 is the rightmost sensor */
+            offset = ((double)i - 3.5) * robot.p.qtrPitch;
+            sx = robot.s.x + robot.p.qtrOffset * c + offset * s;
+            sy = robot.s.y + robot.p.qtrOffset * s - offset * c;
+
+            us = (ledOn && !world_is_tape(robot.world, sx, sy)) ? robot.p.qtrWhiteUs : robot.p.qtrBlackUs;
+            robot.qtrDecayEnd[i] = sim_now() + (uint64_t)(us * SIM_TICKS_PER_US);
+        }
+        else if (charged & bit)
+        {
+            robot.qtrDecayEnd[i] = UINT64_MAX;
+        }
+
+        if (sim_now() < robot.qtrDecayEnd[i])
+            levels |= bit;
+    }
+
+    robot.qtrDir = dir;
+    sim_gpio_drive(7, 0xFF, levels);
+}
+
+/*
+ * Put the robot at the map's start pose and hook it into the simulator.
+ * Call after sim_reset().
+ */
+void robot_attach(const robot_params_t *p, const world_t *world)
+{
+    memset(&robot, 0, sizeof(robot));
+    robot.p = *p;
+    robot.world = world;
+    robot.alpha = 1.0 - exp(-STEP_S / p->tau);
+    robot.random = p->seed ? p->seed : 1;
+
+    robot.s.x = world->startX;
+    robot.s.y = world->startY;
+    robot.s.heading = world->startHeading;
+
+    sim_gpio_drive(5, encoderA[0] | encoderA[1], 0);
+    sim_gpio_drive(10, encoderB[0] | encoderB[1], 0);
+    sim_gpio_attach_model(7, robot_qtr, NULL);
+    sim_add_hook(ROBOT_STEP_US * SIM_TICKS_PER_US, robot_step, NULL);
+}
@@ -0,0 +1,67 @@
+/*
+ * robot.h
+ *
+ * Differential drive model of the TI-RSLK (Romi chassis) wired to the
+ * simulated MSP432 exactly as the Library expects:
+ *
+ *   motors     PWM duty from TIMER_A0 CCR4 (left) and CCR3 (right),
+ *              direction on P5.4 / P5.5 (low = forward)
+ *   encoders   A on P5.2 / P5.0, B on P10.5 / P10.4, so PORT5_IRQHandler
+ *              sees the rising edges of A
+ *   bumpers    six switches on P4.0, 4.2, 4.3, 4.5, 4.6, 4.7 (bump0 on the
+ *              right), active low, closed by walls in the world map
+ *   QTR-8RC    RC decay on P7.0 (right) to P7.7 (left) against the tape in
+ *              the world map, IR LEDs on P5.3
+ *
+ * Each motor is a first order lag from duty to wheel speed with a dead
+ * band.  Walls stop the robot's translation but not the wheels, so the
+ * encoders keep counting while it pushes against a wall, like wheel slip
+ * on the real floor.  With grip set the wheels stall against the wall
+ * instead.  An encoder can be made to fail part way through a run: its A
+ * channel stops changing and PORT5 sees no more edges from it.
+ */
+#ifndef ROBOT_H_
+#define ROBOT_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "world.h"
+
+#define ROBOT_LEFT      0
+#define ROBOT_RIGHT     1
+#define ROBOT_STEP_US   100         /* physics step */
+
+typedef struct
+{
+    double wheelDiameter;           /* m */
+    double track;                   /* m, wheel to wheel */
+    double bodyRadius;              /* m, bumper ring */
+    double countsPerRev;            /* A channel rising edges per wheel turn */
+    double maxRpm[2];               /* wheel speed at 100% duty */
+    double deadband;                /* duty the motor needs before it turns */
+    double tau;                     /* s, motor time constant */
+    double qtrOffset;               /* m, sensor bar ahead of the axle */
+    double qtrPitch;                /* m, between sensors */
+    double qtrWhiteUs;              /* decay time over white floor */
+    double qtrBlackUs;              /* decay time over tape or with the LEDs off */
+    double edgeGlitch;              /* chance of a contact bounce on each encoder edge */
+    bool grip;                      /* a wall stalls the wheels instead of letting them slip */
+    double encoderFail[2];          /* s, when each encoder's A channel dies, < 0 never */
+    uint32_t seed;                  /* for the noise above */
+} robot_params_t;
+
+typedef struct
+{
+    double x, y, heading;           /* m, m, rad */
+    double omega[2];                /* wheel speed, rad/s */
+    double distance;                /* m travelled by the centre */
+    uint8_t bumps;                  /* bit n set while bump n is pressed */
+    uint32_t wallContacts;          /* bumper closures */
+} robot_state_t;
+
+void robot_default_params(robot_params_t *p);
+void robot_attach(const robot_params_t *p, const world_t *world);
+const robot_state_t *robot_state(void);
+double robot_wheel_counts(unsigned side);
+
+#endif /* ROBOT_H_ */
@@ -0,0 +1,165 @@
+/*
+ * world.c
+ *
+ * Arena map loading and geometry queries.  See world.h.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <float.h>
+#include "world.h"
+
+#define MM  0.001
+
+void world_init(world_t *w)
+{
+    memset(w, 0, sizeof(*w));
+    w->startHeading = M_PI / 2;
+}
+
+/* Closest point to (px, py) on the segment, returns the distance */
+static double segment_distance(double x1, double y1, double x2, double y2,
+                               double px, double py, double *cx, double *cy)
+{
+    double dx = x2 - x1, dy = y2 - y1;
+    double len2 = dx * dx + dy * dy;
+    double t = 0.0;
+
+    if (len2 > 0.0)
+    {
+        t = ((px - x1) * dx + (py - y1) * dy) / len2;
+        if (t < 0.0)
+            t = 0.0;
+        if (t > 1.0)
+            t = 1.0;
+    }
+
+    *cx = x1 + t * dx;
+    *cy = y1 + t * dy;
+
+    return hypot(px - *cx, py - *cy);
+}
+
+/*
+ * Distance from (x, y) to the nearest wall, DBL_MAX if there are none.
+ * The closest wall point is returned in (cx, cy).
+ */
+double world_wall_distance(const world_t *w, double x, double y, double *cx, double *cy)
+{
+    double best = DBL_MAX, d, px, py;
+    unsigned i;
+
+    for (i = 0; i < w->numWalls; i++)
+    {
+        const world_wall_t *s = &w->walls[i];
+
+        d = segment_distance(s->x1, s->y1, s->x2, s->y2, x, y, &px, &py);
+        if (d < best)
+        {
+            best = d;
+            *cx = px;
+            *cy = py;
+        }
+    }
+
+    return best;
+}
+
+/* True if the floor at (x, y) is black tape */
+bool world_is_tape(const world_t *w, double x, double y)
+{
+    double px, py, d;
+    unsigned i;
+
+    for (i = 0; i < w->numLines; i++)
+    {
+        const world_line_t *l = &w->lines[i];
+
+        if (l->circle)
+            d = fabs(hypot(x - l->x1, y - l->y1) - l->x2);
+        else
+            d = segment_distance(l->x1, l->y1, l->x2, l->y2, x, y, &px, &py);
+
+        if (d <= l->width / 2)
+            return true;
+    }
+
+    return false;
+}
+
+bool world_load(world_t *w, const char *path)
+{
+    char buf[256], kind[16];
+    double v[5];
+    unsigned lineNo = 0;
+    int n;
+    FILE *f = fopen(path, "r");
+
+    if (f == NULL)
+    {
+        perror(path);
+        return false;
+    }
+
+    world_init(w);
+
+    while (fgets(buf, sizeof(buf), f))
+    {
+        char *hash = strchr(buf, '#');
+
+        lineNo++;
+        if (hash)
+            *hash = '\0';
+
+        n = sscanf(buf, "%15s %lf %lf %lf %lf %lf", kind, &v[0], &v[1], &v[2], &v[3], &v[4]);
+        if (n <= 0)
+            continue;
+
+        if (!strcmp(kind, "wall") && (n == 5) && (w->numWalls < WORLD_MAX_WALLS))
+        {
+            world_wall_t *s = &w->walls[w->numWalls++];
+
+            s->x1 = v[0] * MM;
+            s->y1 = v[1] * MM;
+            s->x2 = v[2] * MM;
+            s->y2 = v[3] * MM;
+        }
+        else if (!strcmp(kind, "line") && (n >= 5) && (w->numLines < WORLD_MAX_LINES))
+        {
+            world_line_t *l = &w->lines[w->numLines++];
+
+            l->circle = false;
+            l->x1 = v[0] * MM;
+            l->y1 = v[1] * MM;
+            l->x2 = v[2] * MM;
+            l->y2 = v[3] * MM;
+            l->width = (n == 6) ? v[4] * MM : WORLD_TAPE_WIDTH;
+        }
+        else if (!strcmp(kind, "circle") && (n >= 4) && (w->numLines < WORLD_MAX_LINES))
+        {
+            world_line_t *l = &w->lines[w->numLines++];
+
+            l->circle = true;
+            l->x1 = v[0] * MM;
+            l->y1 = v[1] * MM;
+            l->x2 = v[2] * MM;
+            l->width = (n == 5) ? v[3] * MM : WORLD_TAPE_WIDTH;
+        }
+        else if (!strcmp(kind, "start") && (n == 4))
+        {
+            w->startX = v[0] * MM;
+            w->startY = v[1] * MM;
+            w->startHeading = v[2] * M_PI / 180.0;
+        }
+        else
+        {
+            fprintf(stderr, "%s:%u: bad or too many map items\n", path, lineNo);
+            fclose(f);
+            return false;
+        }
+    }
+
+    fclose(f);
+    return true;
+}
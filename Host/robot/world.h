@@ -0,0 +1,54 @@
+/*
+ * world.h
+ *
+ * 2D arena for the robot model: walls the bumper can hit and black tape the
+ * line sensor can see.
+ *
+ * Map files are plain text, one item per line, lengths in millimetres and
+ * angles in degrees measured counter-clockwise from the +x axis:
+ *
+ *   wall   x1 y1 x2 y2             wall segment
+ *   line   x1 y1 x2 y2 [width]     straight tape, default width 19 mm
+ *   circle cx cy r [width]         tape ring
+ *   start  x y heading             robot pose at reset
+ *
+ * Anything after '#' is a comment.
+ */
+#ifndef WORLD_H_
+#define WORLD_H_
+
+#include <stdbool.h>
+
+#define WORLD_MAX_WALLS     64
+#define WORLD_MAX_LINES     64
+#define WORLD_TAPE_WIDTH    0.019       /* 3/4" electrical tape, m */
+
+typedef struct
+{
+    double x1, y1, x2, y2;
+} world_wall_t;
+
+typedef struct
+{
+    bool circle;
+    double x1, y1, x2, y2;      /* segment ends, or centre and (radius, unused) */
+    double width;
+} world_line_t;
+
+typedef struct
+{
+    world_wall_t walls[WORLD_MAX_WALLS];
+    unsigned numWalls;
+    world_line_t lines[WORLD_MAX_LINES];
+    unsigned numLines;
+
+    double startX, startY, startHeading;    /* m, m, rad */
+} world_t;
+
+void world_init(world_t *w);
+bool world_load(world_t *w, const char *path);
+
+double world_wall_distance(const world_t *w, double x, double y, double *cx, double *cy);
+bool world_is_tape(const world_t *w, double x, double y);
+
+#endif /* WORLD_H_ */
@@ -0,0 +1,342 @@
+/*
+ * msp.h
+ *
+ * Host stand-in for the MSP432P401R device header.
+ *
+ * Every peripheral the Library touches is modelled as a plain structure in
+ * a simulated register file (see sim_core.c).  Register names and bit
+ * definitions match the TI header so the Library compiles unchanged; only
+ * the registers and bits that the Library actually uses are provided.
+ *
+ * Peripheral pointers (P1, PCM, TIMER_A0, ...) go through an accessor that
+ * charges one bus cycle of simulated time and brings the model up to date,
+ * so polling loops on a register see the hardware move on.
+ */
+#ifndef SIM_MSP_H_
+#define SIM_MSP_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*-------------------------------------------------------------------------
+ * Digital I/O.  The real part packs odd/even ports into 16-bit registers;
+ * the model keeps one 8-bit register set per port.
+ *-----------------------------------------------------------------------*/
+typedef struct {
+    volatile uint8_t IN;
+    volatile uint8_t OUT;
+    volatile uint8_t DIR;
+    volatile uint8_t REN;
+    volatile uint8_t DS;
+    volatile uint8_t SEL0;
+    volatile uint8_t SEL1;
+    volatile uint8_t SELC;
+    volatile uint8_t IES;
+    volatile uint8_t IE;
+    volatile uint8_t IFG;
+    volatile uint16_t IV;
+} DIO_PORT_Type;
+
+#define SIM_NUM_PORTS 12                /* index 0 unused, 1-10, 11 = PJ */
+extern DIO_PORT_Type sim_port[SIM_NUM_PORTS];
+DIO_PORT_Type *sim_port_reg(unsigned port);
+
+#define P1  (sim_port_reg(1))
+#define P2  (sim_port_reg(2))
+#define P3  (sim_port_reg(3))
+#define P4  (sim_port_reg(4))
+#define P5  (sim_port_reg(5))
+#define P6  (sim_port_reg(6))
+#define P7  (sim_port_reg(7))
+#define P8  (sim_port_reg(8))
+#define P9  (sim_port_reg(9))
+#define P10 (sim_port_reg(10))
+#define PJ  (sim_port_reg(11))
+
+/*-------------------------------------------------------------------------
+ * Power control manager
+ *-----------------------------------------------------------------------*/
+typedef struct {
+    volatile uint32_t CTL0;
+    volatile uint32_t CTL1;
+    volatile uint32_t IE;
+    volatile uint32_t IFG;
+    volatile uint32_t CLRIFG;
+} PCM_Type;
+
+extern PCM_Type sim_pcm;
+PCM_Type *sim_pcm_reg(void);
+#define PCM (sim_pcm_reg())
+
+#define PCM_CTL0_KEY_VAL        ((uint32_t)0x695A0000)
+#define PCM_CTL0_AMR_MASK       ((uint32_t)0x0000000F)
+#define PCM_CTL0_AMR_0          ((uint32_t)0x00000000)    /* LDO, VCORE0 */
+#define PCM_CTL0_AMR_1          ((uint32_t)0x00000001)    /* LDO, VCORE1 */
+#define PCM_CTL0_AMR_4          ((uint32_t)0x00000004)    /* DC-DC, VCORE0 */
+#define PCM_CTL0_AMR_5          ((uint32_t)0x00000005)    /* DC-DC, VCORE1 */
+#define PCM_CTL0_CPM_OFS        (8)
+#define PCM_CTL0_CPM_MASK       ((uint32_t)0x00003F00)
+#define PCM_CTL1_PMR_BUSY       ((uint32_t)0x00000100)
+#define PCM_IFG_AM_INVALID_TR_IFG       ((uint32_t)0x00000004)
+#define PCM_IFG_DCDC_ERROR_IFG          ((uint32_t)0x00000040)
+#define PCM_CLRIFG_CLR_AM_INVALID_TR_IFG ((uint32_t)0x00000004)
+#define PCM_CLRIFG_CLR_DCDC_ERROR_IFG   ((uint32_t)0x00000040)
+
+/*-------------------------------------------------------------------------
+ * Clock system
+ *-----------------------------------------------------------------------*/
+typedef struct {
+    volatile uint32_t KEY;
+    volatile uint32_t CTL0;
+    volatile uint32_t CTL1;
+    volatile uint32_t CTL2;
+    volatile uint32_t CTL3;
+    volatile uint32_t CLKEN;
+    volatile uint32_t STAT;
+    volatile uint32_t IE;
+    volatile uint32_t IFG;
+    volatile uint32_t CLRIFG;
+    volatile uint32_t SETIFG;
+} CS_Type;
+
+extern CS_Type sim_cs;
+CS_Type *sim_cs_reg(void);
+#define CS (sim_cs_reg())
+
+#define CS_KEY_VAL              ((uint32_t)0x0000695A)
+#define CS_IFG_HFXTIFG          ((uint32_t)0x00000002)
+#define CS_CLRIFG_CLR_HFXTIFG   ((uint32_t)0x00000002)
+
+/*-------------------------------------------------------------------------
+ * Flash controller
+ *-----------------------------------------------------------------------*/
+typedef struct {
+    volatile uint32_t POWER_STAT;
+    volatile uint32_t BANK0_RDCTL;
+    volatile uint32_t BANK1_RDCTL;
+    volatile uint32_t RDBRST_CTLSTAT;
+    volatile uint32_t PRG_CTLSTAT;
+    volatile uint32_t IFG;
+    volatile uint32_t CLRIFG;
+} FLCTL_Type;
+
+extern FLCTL_Type sim_flctl;
+FLCTL_Type *sim_flctl_reg(void);
+#define FLCTL (sim_flctl_reg())
+
+#define FLCTL_BANK0_RDCTL_BUFI      ((uint32_t)0x00000010)
+#define FLCTL_BANK0_RDCTL_BUFD      ((uint32_t)0x00000020)
+#define FLCTL_BANK0_RDCTL_WAIT_MASK ((uint32_t)0x0000F000)
+#define FLCTL_BANK0_RDCTL_WAIT_0    ((uint32_t)0x00000000)
+#define FLCTL_BANK0_RDCTL_WAIT_1    ((uint32_t)0x00001000)
+#define FLCTL_BANK0_RDCTL_WAIT_2    ((uint32_t)0x00002000)
+#define FLCTL_BANK1_RDCTL_BUFI      ((uint32_t)0x00000010)
+#define FLCTL_BANK1_RDCTL_BUFD      ((uint32_t)0x00000020)
+#define FLCTL_BANK1_RDCTL_WAIT_MASK ((uint32_t)0x0000F000)
+#define FLCTL_BANK1_RDCTL_WAIT_0    ((uint32_t)0x00000000)
+#define FLCTL_BANK1_RDCTL_WAIT_1    ((uint32_t)0x00001000)
+#define FLCTL_BANK1_RDCTL_WAIT_2    ((uint32_t)0x00002000)
+
+/*-------------------------------------------------------------------------
+ * Timer_A
+ *-----------------------------------------------------------------------*/
+typedef struct {
+    volatile uint16_t CTL;
+    volatile uint16_t CCTL[7];
+    volatile uint16_t R;
+    volatile uint16_t CCR[7];
+    volatile uint16_t EX0;
+    volatile uint16_t IV;
+} Timer_A_Type;
+
+extern Timer_A_Type sim_timer_a[4];
+Timer_A_Type *sim_timer_a_reg(unsigned n);
+#define TIMER_A0 (sim_timer_a_reg(0))
+#define TIMER_A1 (sim_timer_a_reg(1))
+#define TIMER_A2 (sim_timer_a_reg(2))
+#define TIMER_A3 (sim_timer_a_reg(3))
+
+/*-------------------------------------------------------------------------
+ * eUSCI_B (I2C)
+ *-----------------------------------------------------------------------*/
+typedef struct {
+    volatile uint16_t CTLW0;
+    volatile uint16_t CTLW1;
+    volatile uint16_t BRW;
+    volatile uint16_t STATW;
+    volatile uint16_t TBCNT;
+    volatile uint16_t RXBUF;
+    volatile uint16_t TXBUF;
+    volatile uint16_t I2COA0;
+    volatile uint16_t ADDRX;
+    volatile uint16_t ADDMASK;
+    volatile uint16_t I2CSA;
+    volatile uint16_t IE;
+    volatile uint16_t IFG;
+    volatile uint16_t IV;
+} EUSCI_B_Type;
+
+extern EUSCI_B_Type sim_eusci_b[4];
+EUSCI_B_Type *sim_eusci_b_reg(unsigned n);
+#define EUSCI_B0 (sim_eusci_b_reg(0))
+#define EUSCI_B1 (sim_eusci_b_reg(1))
+#define EUSCI_B2 (sim_eusci_b_reg(2))
+#define EUSCI_B3 (sim_eusci_b_reg(3))
+
+#define EUSCI_B_CTLW0_SWRST     ((uint16_t)0x0001)
+#define EUSCI_B_CTLW0_TXSTT     ((uint16_t)0x0002)
+#define EUSCI_B_CTLW0_TXSTP     ((uint16_t)0x0004)
+#define EUSCI_B_CTLW0_TXNACK    ((uint16_t)0x0008)
+#define EUSCI_B_CTLW0_TR        ((uint16_t)0x0010)
+#define EUSCI_B_STATW_BBUSY     ((uint16_t)0x0010)
+#define EUSCI_B_IFG_RXIFG0      ((uint16_t)0x0001)
+#define EUSCI_B_IFG_TXIFG0      ((uint16_t)0x0002)
+#define EUSCI_B_IFG_STTIFG      ((uint16_t)0x0004)
+#define EUSCI_B_IFG_STPIFG      ((uint16_t)0x0008)
+#define EUSCI_B_IFG_ALIFG       ((uint16_t)0x0010)
+#define EUSCI_B_IFG_NACKIFG     ((uint16_t)0x0020)
+#define EUSCI_B_IFG_CLTOIFG     ((uint16_t)0x0080)
+
+/*-------------------------------------------------------------------------
+ * Watchdog
+ *-----------------------------------------------------------------------*/
+typedef struct {
+    volatile uint16_t CTL;
+} WDT_A_Type;
+
+extern WDT_A_Type sim_wdt_a;
+WDT_A_Type *sim_wdt_a_reg(void);
+#define WDT_A (sim_wdt_a_reg())
+
+#define WDT_A_CTL_PW            ((uint16_t)0x5A00)
+#define WDT_A_CTL_HOLD          ((uint16_t)0x0080)
+#define WDT_A_CTL_SSEL_MASK     ((uint16_t)0x0060)
+#define WDT_A_CTL_TMSEL         ((uint16_t)0x0010)
+#define WDT_A_CTL_CNTCL         ((uint16_t)0x0008)
+#define WDT_A_CTL_IS_MASK       ((uint16_t)0x0007)
+
+/*-------------------------------------------------------------------------
+ * Cortex-M4 core peripherals
+ *-----------------------------------------------------------------------*/
+typedef struct {
+    volatile uint32_t CTRL;
+    volatile uint32_t LOAD;
+    volatile uint32_t VAL;
+    volatile uint32_t CALIB;
+} SysTick_Type;
+
+extern SysTick_Type sim_systick;
+SysTick_Type *sim_systick_reg(void);
+#define SysTick (sim_systick_reg())
+
+#define SysTick_CTRL_ENABLE_Msk     (1UL << 0)
+#define SysTick_CTRL_TICKINT_Msk    (1UL << 1)
+#define SysTick_CTRL_COUNTFLAG_Msk  (1UL << 16)
+#define SysTick_LOAD_RELOAD_Msk     (0xFFFFFFUL)
+
+typedef struct {
+    volatile uint32_t CTRL;
+    volatile uint32_t CYCCNT;
+} DWT_Type;
+
+extern DWT_Type sim_dwt;
+DWT_Type *sim_dwt_reg(void);
+#define DWT (sim_dwt_reg())
+
+#define DWT_CTRL_CYCCNTENA_Msk      (1UL << 0)
+
+typedef struct {
+    volatile uint32_t DHCSR;
+    volatile uint32_t DCRSR;
+    volatile uint32_t DCRDR;
+    volatile uint32_t DEMCR;
+} CoreDebug_Type;
+
+extern CoreDebug_Type sim_coredebug;
+CoreDebug_Type *sim_coredebug_reg(void);
+#define CoreDebug (sim_coredebug_reg())
+
+#define CoreDebug_DEMCR_TRCENA_Msk  (1UL << 24)
+
+typedef struct {
+    volatile uint32_t CPUID;
+    volatile uint32_t ICSR;
+    volatile uint32_t VTOR;
+    volatile uint32_t AIRCR;
+    volatile uint32_t SCR;
+    volatile uint32_t CCR;
+    volatile uint8_t  SHP[12];
+    volatile uint32_t SHCSR;
+    volatile uint32_t CFSR;
+    volatile uint32_t HFSR;
+    volatile uint32_t DFSR;
+    volatile uint32_t MMFAR;
+    volatile uint32_t BFAR;
+    volatile uint32_t AFSR;
+} SCB_Type;
+
+extern SCB_Type sim_scb;
+SCB_Type *sim_scb_reg(void);
+#define SCB (sim_scb_reg())
+
+#define SCB_ICSR_VECTACTIVE_Msk     (0x1FFUL)
+#define SCB_CCR_DIV_0_TRP_Msk       (1UL << 4)
+#define SCB_SHCSR_MEMFAULTENA_Msk   (1UL << 16)
+#define SCB_SHCSR_BUSFAULTENA_Msk   (1UL << 17)
+#define SCB_SHCSR_USGFAULTENA_Msk   (1UL << 18)
+#define SCB_ICSR_ISRPENDING_Msk     (1UL << 22)
+
+/* Registers only, accesses are not checked against the regions */
+typedef struct {
+    volatile uint32_t TYPE;
+    volatile uint32_t CTRL;
+    volatile uint32_t RNR;
+    volatile uint32_t RBAR;
+    volatile uint32_t RASR;
+} MPU_Type;
+
+extern MPU_Type sim_mpu;
+MPU_Type *sim_mpu_reg(void);
+#define MPU (sim_mpu_reg())
+
+#define MPU_CTRL_ENABLE_Msk         (1UL << 0)
+#define MPU_CTRL_PRIVDEFENA_Msk     (1UL << 2)
+#define MPU_RASR_ENABLE_Msk         (1UL << 0)
+#define MPU_RASR_SIZE_Pos           1
+#define MPU_RASR_AP_Pos             24
+#define MPU_RASR_XN_Msk             (1UL << 28)
+
+/*-------------------------------------------------------------------------
+ * CMSIS intrinsics.  Interrupt masking is tracked so the simulator only
+ * dispatches interrupts while they are enabled; the remaining intrinsics
+ * only cost simulated time.
+ *-----------------------------------------------------------------------*/
+void sim_enable_irq(void);
+void sim_disable_irq(void);
+uint32_t sim_get_primask(void);
+void sim_set_primask(uint32_t primask);
+void sim_cycles(uint32_t cycles);
+void sim_wfi(void);
+
+#define __enable_irq()      sim_enable_irq()
+#define __disable_irq()     sim_disable_irq()
+#define __get_PRIMASK()     sim_get_primask()
+#define __set_PRIMASK(x)    sim_set_primask(x)
+#define __NOP()             sim_cycles(1)
+#define __WFI()             sim_wfi()
+#define __DSB()             ((void)0)
+#define __ISB()             ((void)0)
+#define __DMB()             ((void)0)
+
+/* TI compiler intrinsic: busy-wait for the given number of MCLK cycles */
+void __delay_cycles(uint32_t cycles);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SIM_MSP_H_ */
@@ -0,0 +1,6 @@
+/*
+ * msp432.h
+ *
+ * Host stand-in: the Library includes either msp.h or msp432.h.
+ */
+#include "msp.h"
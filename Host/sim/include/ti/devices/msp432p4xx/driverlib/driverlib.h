@@ -0,0 +1,564 @@
+/*
+ * driverlib.h
+ *
+ * Host stand-in for the MSP432 DriverLib.  Prototypes and constants follow
+ * the SimpleLink MSP432P4 SDK; the implementations in sim_driverlib.c act
+ * on the simulated register file.  MAP_ (ROM) variants resolve to the same
+ * functions.
+ */
+#ifndef SIM_DRIVERLIB_H_
+#define SIM_DRIVERLIB_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "msp.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*-------------------------------------------------------------------------
+ * GPIO
+ *-----------------------------------------------------------------------*/
+#define GPIO_PORT_P1        1
+#define GPIO_PORT_P2        2
+#define GPIO_PORT_P3        3
+#define GPIO_PORT_P4        4
+#define GPIO_PORT_P5        5
+#define GPIO_PORT_P6        6
+#define GPIO_PORT_P7        7
+#define GPIO_PORT_P8        8
+#define GPIO_PORT_P9        9
+#define GPIO_PORT_P10       10
+#define GPIO_PORT_PJ        11
+
+#define GPIO_PIN0           (0x0001)
+#define GPIO_PIN1           (0x0002)
+#define GPIO_PIN2           (0x0004)
+#define GPIO_PIN3           (0x0008)
+#define GPIO_PIN4           (0x0010)
+#define GPIO_PIN5           (0x0020)
+#define GPIO_PIN6           (0x0040)
+#define GPIO_PIN7           (0x0080)
+#define GPIO_PIN_ALL8       (0x00FF)
+
+#define GPIO_PRIMARY_MODULE_FUNCTION    (0x01)
+#define GPIO_SECONDARY_MODULE_FUNCTION  (0x02)
+#define GPIO_TERTIARY_MODULE_FUNCTION   (0x03)
+
+#define GPIO_LOW_TO_HIGH_TRANSITION     (0x00)
+#define GPIO_HIGH_TO_LOW_TRANSITION     (0x01)
+
+#define GPIO_INPUT_PIN_HIGH (0x01)
+#define GPIO_INPUT_PIN_LOW  (0x00)
+
+void GPIO_setAsOutputPin(uint_fast8_t selectedPort, uint_fast16_t selectedPins);
+void GPIO_setOutputHighOnPin(uint_fast8_t selectedPort, uint_fast16_t selectedPins);
+void GPIO_setOutputLowOnPin(uint_fast8_t selectedPort, uint_fast16_t selectedPins);
+void GPIO_toggleOutputOnPin(uint_fast8_t selectedPort, uint_fast16_t selectedPins);
+void GPIO_setAsInputPin(uint_fast8_t selectedPort, uint_fast16_t selectedPins);
+void GPIO_setAsInputPinWithPullUpResistor(uint_fast8_t selectedPort, uint_fast16_t selectedPins);
+void GPIO_setAsInputPinWithPullDownResistor(uint_fast8_t selectedPort, uint_fast16_t selectedPins);
+void GPIO_setAsPeripheralModuleFunctionOutputPin(uint_fast8_t selectedPort, uint_fast16_t selectedPins, uint_fast8_t mode);
+void GPIO_setAsPeripheralModuleFunctionInputPin(uint_fast8_t selectedPort, uint_fast16_t selectedPins, uint_fast8_t mode);
+uint8_t GPIO_getInputPinValue(uint_fast8_t selectedPort, uint_fast16_t selectedPins);
+void GPIO_interruptEdgeSelect(uint_fast8_t selectedPort, uint_fast16_t selectedPins, uint_fast8_t edgeSelect);
+void GPIO_enableInterrupt(uint_fast8_t selectedPort, uint_fast16_t selectedPins);
+void GPIO_disableInterrupt(uint_fast8_t selectedPort, uint_fast16_t selectedPins);
+void GPIO_clearInterruptFlag(uint_fast8_t selectedPort, uint_fast16_t selectedPins);
+uint_fast16_t GPIO_getInterruptStatus(uint_fast8_t selectedPort, uint_fast16_t selectedPins);
+uint_fast16_t GPIO_getEnabledInterruptStatus(uint_fast8_t selectedPort);
+
+#define MAP_GPIO_setAsOutputPin                     GPIO_setAsOutputPin
+#define MAP_GPIO_setOutputHighOnPin                 GPIO_setOutputHighOnPin
+#define MAP_GPIO_setOutputLowOnPin                  GPIO_setOutputLowOnPin
+#define MAP_GPIO_toggleOutputOnPin                  GPIO_toggleOutputOnPin
+#define MAP_GPIO_setAsInputPin                      GPIO_setAsInputPin
+#define MAP_GPIO_setAsInputPinWithPullUpResistor    GPIO_setAsInputPinWithPullUpResistor
+#define MAP_GPIO_setAsInputPinWithPullDownResistor  GPIO_setAsInputPinWithPullDownResistor
+#define MAP_GPIO_setAsPeripheralModuleFunctionOutputPin GPIO_setAsPeripheralModuleFunctionOutputPin
+#define MAP_GPIO_setAsPeripheralModuleFunctionInputPin  GPIO_setAsPeripheralModuleFunctionInputPin
+#define MAP_GPIO_getInputPinValue                   GPIO_getInputPinValue
+#define MAP_GPIO_interruptEdgeSelect                GPIO_interruptEdgeSelect
+#define MAP_GPIO_enableInterrupt                    GPIO_enableInterrupt
+#define MAP_GPIO_disableInterrupt                   GPIO_disableInterrupt
+#define MAP_GPIO_clearInterruptFlag                 GPIO_clearInterruptFlag
+#define MAP_GPIO_getInterruptStatus                 GPIO_getInterruptStatus
+#define MAP_GPIO_getEnabledInterruptStatus          GPIO_getEnabledInterruptStatus
+
+/*-------------------------------------------------------------------------
+ * Interrupt controller
+ *-----------------------------------------------------------------------*/
+#define FAULT_SYSTICK       (15)
+#define INT_PSS             (16)
+#define INT_CS              (17)
+#define INT_PCM             (18)
+#define INT_WDT_A           (19)
+#define INT_FPU             (20)
+#define INT_FLCTL           (21)
+#define INT_TA0_0           (24)
+#define INT_TA0_N           (25)
+#define INT_TA1_0           (26)
+#define INT_TA1_N           (27)
+#define INT_TA2_0           (28)
+#define INT_TA2_N           (29)
+#define INT_TA3_0           (30)
+#define INT_TA3_N           (31)
+#define INT_EUSCIA0         (32)
+#define INT_EUSCIA1         (33)
+#define INT_EUSCIA2         (34)
+#define INT_EUSCIA3         (35)
+#define INT_EUSCIB0         (36)
+#define INT_EUSCIB1         (37)
+#define INT_EUSCIB2         (38)
+#define INT_EUSCIB3         (39)
+#define INT_ADC14           (40)
+#define INT_T32_INT1        (41)
+#define INT_T32_INT2        (42)
+#define INT_T32_INTC        (43)
+#define INT_AES256          (44)
+#define INT_RTC_C           (45)
+#define INT_DMA_ERR         (46)
+#define INT_DMA_INT3        (47)
+#define INT_DMA_INT2        (48)
+#define INT_DMA_INT1        (49)
+#define INT_DMA_INT0        (50)
+#define INT_PORT1           (51)
+#define INT_PORT2           (52)
+#define INT_PORT3           (53)
+#define INT_PORT4           (54)
+#define INT_PORT5           (55)
+#define INT_PORT6           (56)
+#define NUM_INTERRUPTS      (57)
+
+void Interrupt_enableInterrupt(uint32_t interruptNumber);
+void Interrupt_disableInterrupt(uint32_t interruptNumber);
+bool Interrupt_isEnabled(uint32_t interruptNumber);
+void Interrupt_setPriority(uint32_t interruptNumber, uint8_t priority);
+uint8_t Interrupt_getPriority(uint32_t interruptNumber);
+bool Interrupt_enableMaster(void);
+bool Interrupt_disableMaster(void);
+
+#define MAP_Interrupt_enableInterrupt   Interrupt_enableInterrupt
+#define MAP_Interrupt_disableInterrupt  Interrupt_disableInterrupt
+#define MAP_Interrupt_isEnabled         Interrupt_isEnabled
+#define MAP_Interrupt_setPriority       Interrupt_setPriority
+#define MAP_Interrupt_getPriority       Interrupt_getPriority
+#define MAP_Interrupt_enableMaster      Interrupt_enableMaster
+#define MAP_Interrupt_disableMaster     Interrupt_disableMaster
+
+/*-------------------------------------------------------------------------
+ * SysTick
+ *-----------------------------------------------------------------------*/
+void SysTick_enableModule(void);
+void SysTick_disableModule(void);
+void SysTick_setPeriod(uint32_t period);
+uint32_t SysTick_getPeriod(void);
+uint32_t SysTick_getValue(void);
+void SysTick_enableInterrupt(void);
+void SysTick_disableInterrupt(void);
+
+#define MAP_SysTick_enableModule        SysTick_enableModule
+#define MAP_SysTick_disableModule       SysTick_disableModule
+#define MAP_SysTick_setPeriod           SysTick_setPeriod
+#define MAP_SysTick_getPeriod           SysTick_getPeriod
+#define MAP_SysTick_getValue            SysTick_getValue
+#define MAP_SysTick_enableInterrupt     SysTick_enableInterrupt
+#define MAP_SysTick_disableInterrupt    SysTick_disableInterrupt
+
+/*-------------------------------------------------------------------------
+ * Clock system.  Frequencies come from the CS registers as on the part.
+ *-----------------------------------------------------------------------*/
+uint32_t CS_getMCLK(void);
+uint32_t CS_getHSMCLK(void);
+uint32_t CS_getSMCLK(void);
+
+#define MAP_CS_getMCLK                  CS_getMCLK
+#define MAP_CS_getHSMCLK                CS_getHSMCLK
+#define MAP_CS_getSMCLK                 CS_getSMCLK
+
+/*-------------------------------------------------------------------------
+ * Watchdog, system control
+ *-----------------------------------------------------------------------*/
+#define WDT_A_CLOCKSOURCE_SMCLK         (0x00)
+#define WDT_A_CLOCKSOURCE_ACLK          (0x20)
+#define WDT_A_CLOCKSOURCE_VLOCLK        (0x40)
+#define WDT_A_CLOCKSOURCE_BCLK          (0x60)
+
+#define WDT_A_CLOCKITERATIONS_2G        (0x00)
+#define WDT_A_CLOCKITERATIONS_128M      (0x01)
+#define WDT_A_CLOCKITERATIONS_8192K     (0x02)
+#define WDT_A_CLOCKITERATIONS_512K      (0x03)
+#define WDT_A_CLOCKITERATIONS_32K       (0x04)
+#define WDT_A_CLOCKITERATIONS_8192      (0x05)
+#define WDT_A_CLOCKITERATIONS_512       (0x06)
+#define WDT_A_CLOCKITERATIONS_64        (0x07)
+
+#define WDT_A_SOFT_RESET                (0x00)
+#define WDT_A_HARD_RESET                (0x01)
+
+void WDT_A_holdTimer(void);
+void WDT_A_startTimer(void);
+void WDT_A_clearTimer(void);
+void WDT_A_initWatchdogTimer(uint_fast8_t clockSelect, uint_fast8_t clockDivider);
+void WDT_A_setTimeoutReset(uint_fast8_t resetType);
+
+#define MAP_WDT_A_holdTimer             WDT_A_holdTimer
+#define MAP_WDT_A_startTimer            WDT_A_startTimer
+#define MAP_WDT_A_clearTimer            WDT_A_clearTimer
+#define MAP_WDT_A_initWatchdogTimer     WDT_A_initWatchdogTimer
+#define MAP_WDT_A_setTimeoutReset       WDT_A_setTimeoutReset
+
+#define RESET_SRC_1         (0x0002)    /* hard reset source: WDT_A time-out */
+
+void ResetCtl_initiateHardReset(void);
+uint32_t ResetCtl_getHardResetSource(void);
+void ResetCtl_clearHardResetSource(uint32_t mask);
+
+#define MAP_ResetCtl_initiateHardReset      ResetCtl_initiateHardReset
+#define MAP_ResetCtl_getHardResetSource     ResetCtl_getHardResetSource
+#define MAP_ResetCtl_clearHardResetSource   ResetCtl_clearHardResetSource
+
+#define SYSCTL_SRAM_BANK1   (0x01)
+
+void SysCtl_enableSRAMBankRetention(uint_fast8_t sramBank);
+void SysCtl_rebootDevice(void);
+
+#define MAP_SysCtl_enableSRAMBankRetention  SysCtl_enableSRAMBankRetention
+#define MAP_SysCtl_rebootDevice             SysCtl_rebootDevice
+
+/*-------------------------------------------------------------------------
+ * Timer_A
+ *-----------------------------------------------------------------------*/
+#define TIMER_A0_BASE   (0x40000000)
+#define TIMER_A1_BASE   (0x40000400)
+#define TIMER_A2_BASE   (0x40000800)
+#define TIMER_A3_BASE   (0x40000C00)
+
+#define TIMER_A_CLOCKSOURCE_EXTERNAL_TXCLK  (0x0000)
+#define TIMER_A_CLOCKSOURCE_ACLK            (0x0100)
+#define TIMER_A_CLOCKSOURCE_SMCLK           (0x0200)
+
+#define TIMER_A_CLOCKSOURCE_DIVIDER_1       (0x01)
+#define TIMER_A_CLOCKSOURCE_DIVIDER_2       (0x02)
+#define TIMER_A_CLOCKSOURCE_DIVIDER_3       (0x03)
+#define TIMER_A_CLOCKSOURCE_DIVIDER_4       (0x04)
+#define TIMER_A_CLOCKSOURCE_DIVIDER_5       (0x05)
+#define TIMER_A_CLOCKSOURCE_DIVIDER_6       (0x06)
+#define TIMER_A_CLOCKSOURCE_DIVIDER_7       (0x07)
+#define TIMER_A_CLOCKSOURCE_DIVIDER_8       (0x08)
+#define TIMER_A_CLOCKSOURCE_DIVIDER_10      (0x0A)
+#define TIMER_A_CLOCKSOURCE_DIVIDER_12      (0x0C)
+#define TIMER_A_CLOCKSOURCE_DIVIDER_14      (0x0E)
+#define TIMER_A_CLOCKSOURCE_DIVIDER_16      (0x10)
+#define TIMER_A_CLOCKSOURCE_DIVIDER_20      (0x14)
+#define TIMER_A_CLOCKSOURCE_DIVIDER_24      (0x18)
+#define TIMER_A_CLOCKSOURCE_DIVIDER_28      (0x1C)
+#define TIMER_A_CLOCKSOURCE_DIVIDER_32      (0x20)
+#define TIMER_A_CLOCKSOURCE_DIVIDER_40      (0x28)
+#define TIMER_A_CLOCKSOURCE_DIVIDER_48      (0x30)
+#define TIMER_A_CLOCKSOURCE_DIVIDER_56      (0x38)
+#define TIMER_A_CLOCKSOURCE_DIVIDER_64      (0x40)
+
+#define TIMER_A_CAPTURECOMPARE_REGISTER_0   (0x02)
+#define TIMER_A_CAPTURECOMPARE_REGISTER_1   (0x04)
+#define TIMER_A_CAPTURECOMPARE_REGISTER_2   (0x06)
+#define TIMER_A_CAPTURECOMPARE_REGISTER_3   (0x08)
+#define TIMER_A_CAPTURECOMPARE_REGISTER_4   (0x0A)
+#define TIMER_A_CAPTURECOMPARE_REGISTER_5   (0x0C)
+#define TIMER_A_CAPTURECOMPARE_REGISTER_6   (0x0E)
+
+#define TIMER_A_OUTPUTMODE_OUTBITVALUE      (0x00E0)
+#define TIMER_A_OUTPUTMODE_SET              (0x0020)
+#define TIMER_A_OUTPUTMODE_TOGGLE_RESET     (0x0040)
+#define TIMER_A_OUTPUTMODE_SET_RESET        (0x0060)
+#define TIMER_A_OUTPUTMODE_TOGGLE           (0x0080)
+#define TIMER_A_OUTPUTMODE_RESET            (0x00A0)
+#define TIMER_A_OUTPUTMODE_TOGGLE_SET       (0x00C0)
+#define TIMER_A_OUTPUTMODE_RESET_SET        (0x00E0)
+
+#define TIMER_A_CONTINUOUS_MODE             (0x0020)
+#define TIMER_A_UP_MODE                     (0x0010)
+
+typedef struct _Timer_A_PWMConfig
+{
+    uint_fast16_t clockSource;
+    uint_fast16_t clockSourceDivider;
+    uint_fast16_t timerPeriod;
+    uint_fast16_t compareRegister;
+    uint_fast16_t compareOutputMode;
+    uint_fast16_t dutyCycle;
+} Timer_A_PWMConfig;
+
+typedef struct _Timer_A_ContinuousModeConfig
+{
+    uint_fast16_t clockSource;
+    uint_fast16_t clockSourceDivider;
+    uint_fast16_t timerInterruptEnable_TAIE;
+    uint_fast16_t timerClear;
+} Timer_A_ContinuousModeConfig;
+
+void Timer_A_generatePWM(uint32_t timer, const Timer_A_PWMConfig *config);
+void Timer_A_setCompareValue(uint32_t timer, uint_fast16_t compareRegister, uint_fast16_t compareValue);
+void Timer_A_configureContinuousMode(uint32_t timer, const Timer_A_ContinuousModeConfig *config);
+void Timer_A_startCounter(uint32_t timer, uint_fast16_t timerMode);
+void Timer_A_stopTimer(uint32_t timer);
+uint_fast16_t Timer_A_getCounterValue(uint32_t timer);
+
+#define MAP_Timer_A_generatePWM             Timer_A_generatePWM
+#define MAP_Timer_A_setCompareValue         Timer_A_setCompareValue
+#define MAP_Timer_A_configureContinuousMode Timer_A_configureContinuousMode
+#define MAP_Timer_A_startCounter            Timer_A_startCounter
+#define MAP_Timer_A_stopTimer               Timer_A_stopTimer
+#define MAP_Timer_A_getCounterValue         Timer_A_getCounterValue
+
+/*-------------------------------------------------------------------------
+ * eUSCI_B I2C master
+ *-----------------------------------------------------------------------*/
+#define EUSCI_B0_BASE   (0x40002000)
+#define EUSCI_B1_BASE   (0x40002400)
+#define EUSCI_B2_BASE   (0x40002800)
+#define EUSCI_B3_BASE   (0x40002C00)
+
+#define EUSCI_B_I2C_NO_AUTO_STOP                (0x0000)
+#define EUSCI_B_I2C_SET_BYTECOUNT_THRESHOLD_FLAG (0x0004)
+#define EUSCI_B_I2C_SEND_STOP_AUTOMATICALLY_ON_BYTECOUNT_THRESHOLD (0x0008)
+
+#define EUSCI_B_I2C_SET_DATA_RATE_1MBPS         1000000
+#define EUSCI_B_I2C_SET_DATA_RATE_400KBPS       400000
+#define EUSCI_B_I2C_SET_DATA_RATE_100KBPS       100000
+
+#define EUSCI_B_I2C_CLOCKSOURCE_ACLK            (0x0040)
+#define EUSCI_B_I2C_CLOCKSOURCE_SMCLK           (0x00C0)
+
+#define EUSCI_B_I2C_TRANSMIT_MODE               EUSCI_B_CTLW0_TR
+#define EUSCI_B_I2C_RECEIVE_MODE                (0x0000)
+
+#define EUSCI_B_I2C_NAK_INTERRUPT               EUSCI_B_IFG_NACKIFG
+#define EUSCI_B_I2C_ARBITRATIONLOST_INTERRUPT   EUSCI_B_IFG_ALIFG
+#define EUSCI_B_I2C_STOP_INTERRUPT              EUSCI_B_IFG_STPIFG
+#define EUSCI_B_I2C_START_INTERRUPT             EUSCI_B_IFG_STTIFG
+#define EUSCI_B_I2C_TRANSMIT_INTERRUPT0         EUSCI_B_IFG_TXIFG0
+#define EUSCI_B_I2C_RECEIVE_INTERRUPT0          EUSCI_B_IFG_RXIFG0
+#define EUSCI_B_I2C_CLOCK_LOW_TIMEOUT_INTERRUPT EUSCI_B_IFG_CLTOIFG
+
+#define EUSCI_B_I2C_BUS_BUSY                    EUSCI_B_STATW_BBUSY
+#define EUSCI_B_I2C_BUS_NOT_BUSY                (0x00)
+
+typedef struct
+{
+    uint_fast8_t selectClockSource;
+    uint32_t i2cClk;
+    uint32_t dataRate;
+    uint_fast8_t byteCounterThreshold;
+    uint_fast8_t autoSTOPGeneration;
+} eUSCI_I2C_MasterConfig;
+
+void I2C_initMaster(uint32_t moduleInstance, const eUSCI_I2C_MasterConfig *config);
+void I2C_enableModule(uint32_t moduleInstance);
+void I2C_disableModule(uint32_t moduleInstance);
+void I2C_setSlaveAddress(uint32_t moduleInstance, uint_fast16_t slaveAddress);
+void I2C_setMode(uint32_t moduleInstance, uint_fast8_t mode);
+uint_fast8_t I2C_getMode(uint32_t moduleInstance);
+uint_fast16_t I2C_isBusBusy(uint32_t moduleInstance);
+void I2C_masterSendStart(uint32_t moduleInstance);
+void I2C_masterSendSingleByte(uint32_t moduleInstance, uint8_t txData);
+void I2C_masterSendMultiByteStart(uint32_t moduleInstance, uint8_t txData);
+void I2C_masterSendMultiByteNext(uint32_t moduleInstance, uint8_t txData);
+void I2C_masterSendMultiByteFinish(uint32_t moduleInstance, uint8_t txData);
+void I2C_masterSendMultiByteStop(uint32_t moduleInstance);
+void I2C_masterReceiveStart(uint32_t moduleInstance);
+uint8_t I2C_masterReceiveMultiByteNext(uint32_t moduleInstance);
+uint8_t I2C_masterReceiveMultiByteFinish(uint32_t moduleInstance);
+void I2C_masterReceiveMultiByteStop(uint32_t moduleInstance);
+uint8_t I2C_masterReceiveSingle(uint32_t moduleInstance);
+uint_fast8_t I2C_masterIsStopSent(uint32_t moduleInstance);
+void I2C_enableInterrupt(uint32_t moduleInstance, uint_fast16_t mask);
+void I2C_disableInterrupt(uint32_t moduleInstance, uint_fast16_t mask);
+void I2C_clearInterruptFlag(uint32_t moduleInstance, uint_fast16_t mask);
+uint_fast16_t I2C_getInterruptStatus(uint32_t moduleInstance, uint16_t mask);
+uint_fast16_t I2C_getEnabledInterruptStatus(uint32_t moduleInstance);
+
+#define MAP_I2C_initMaster                  I2C_initMaster
+#define MAP_I2C_enableModule                I2C_enableModule
+#define MAP_I2C_disableModule               I2C_disableModule
+#define MAP_I2C_setSlaveAddress             I2C_setSlaveAddress
+#define MAP_I2C_setMode                     I2C_setMode
+#define MAP_I2C_getMode                     I2C_getMode
+#define MAP_I2C_isBusBusy                   I2C_isBusBusy
+#define MAP_I2C_masterSendStart             I2C_masterSendStart
+#define MAP_I2C_masterSendSingleByte        I2C_masterSendSingleByte
+#define MAP_I2C_masterSendMultiByteStart    I2C_masterSendMultiByteStart
+#define MAP_I2C_masterSendMultiByteNext     I2C_masterSendMultiByteNext
+#define MAP_I2C_masterSendMultiByteFinish   I2C_masterSendMultiByteFinish
+#define MAP_I2C_masterSendMultiByteStop     I2C_masterSendMultiByteStop
+#define MAP_I2C_masterReceiveStart          I2C_masterReceiveStart
+#define MAP_I2C_masterReceiveMultiByteNext  I2C_masterReceiveMultiByteNext
+#define MAP_I2C_masterReceiveMultiByteFinish I2C_masterReceiveMultiByteFinish
+#define MAP_I2C_masterReceiveMultiByteStop  I2C_masterReceiveMultiByteStop
+#define MAP_I2C_masterReceiveSingle         I2C_masterReceiveSingle
+#define MAP_I2C_masterIsStopSent            I2C_masterIsStopSent
+#define MAP_I2C_enableInterrupt             I2C_enableInterrupt
+#define MAP_I2C_disableInterrupt            I2C_disableInterrupt
+#define MAP_I2C_clearInterruptFlag          I2C_clearInterruptFlag
+#define MAP_I2C_getInterruptStatus          I2C_getInterruptStatus
+#define MAP_I2C_getEnabledInterruptStatus   I2C_getEnabledInterruptStatus
+
+/*-------------------------------------------------------------------------
+ * eUSCI_A UART.  Transmit only.
+ *-----------------------------------------------------------------------*/
+#define EUSCI_A0_BASE   (0x40001000)
+#define EUSCI_A1_BASE   (0x40001400)
+#define EUSCI_A2_BASE   (0x40001800)
+#define EUSCI_A3_BASE   (0x40001C00)
+
+#define EUSCI_A_UART_CLOCKSOURCE_ACLK           (0x0040)
+#define EUSCI_A_UART_CLOCKSOURCE_SMCLK          (0x0080)
+
+#define EUSCI_A_UART_NO_PARITY                  (0x00)
+#define EUSCI_A_UART_ODD_PARITY                 (0x01)
+#define EUSCI_A_UART_EVEN_PARITY                (0x02)
+
+#define EUSCI_A_UART_MSB_FIRST                  (0x2000)
+#define EUSCI_A_UART_LSB_FIRST                  (0x00)
+
+#define EUSCI_A_UART_ONE_STOP_BIT               (0x00)
+#define EUSCI_A_UART_TWO_STOP_BITS              (0x0800)
+
+#define EUSCI_A_UART_MODE                       (0x0000)
+
+#define EUSCI_A_UART_OVERSAMPLING_BAUDRATE_GENERATION   (0x01)
+#define EUSCI_A_UART_LOW_FREQUENCY_BAUDRATE_GENERATION  (0x00)
+
+#define EUSCI_A_UART_RECEIVE_INTERRUPT_FLAG     (0x0001)
+#define EUSCI_A_UART_TRANSMIT_INTERRUPT_FLAG    (0x0002)
+
+#define EUSCI_A_UART_BUSY                       (0x0001)
+
+typedef struct
+{
+    uint_fast8_t selectClockSource;
+    uint_fast16_t clockPrescalar;
+    uint_fast8_t firstModReg;
+    uint_fast8_t secondModReg;
+    uint_fast8_t parity;
+    uint_fast16_t msborLsbFirst;
+    uint_fast16_t numberofStopBits;
+    uint_fast16_t uartMode;
+    uint_fast8_t overSampling;
+} eUSCI_UART_Config;
+
+bool UART_initModule(uint32_t moduleInstance, const eUSCI_UART_Config *config);
+void UART_enableModule(uint32_t moduleInstance);
+void UART_disableModule(uint32_t moduleInstance);
+void UART_transmitData(uint32_t moduleInstance, uint_fast8_t transmitData);
+uint_fast8_t UART_getInterruptStatus(uint32_t moduleInstance, uint8_t mask);
+uint_fast8_t UART_queryStatusFlags(uint32_t moduleInstance, uint_fast8_t mask);
+uint32_t UART_getTransmitBufferAddressForDMA(uint32_t moduleInstance);
+
+#define MAP_UART_initModule                 UART_initModule
+#define MAP_UART_enableModule               UART_enableModule
+#define MAP_UART_disableModule              UART_disableModule
+#define MAP_UART_transmitData               UART_transmitData
+#define MAP_UART_getInterruptStatus         UART_getInterruptStatus
+#define MAP_UART_queryStatusFlags           UART_queryStatusFlags
+#define MAP_UART_getTransmitBufferAddressForDMA UART_getTransmitBufferAddressForDMA
+
+/*-------------------------------------------------------------------------
+ * uDMA.  Basic mode transfers triggered by a peripheral or by software.
+ *-----------------------------------------------------------------------*/
+typedef struct
+{
+    volatile void *srcEndAddr;
+    volatile void *dstEndAddr;
+    volatile uint32_t control;
+    volatile uint32_t spare;
+} DMA_ControlTable;
+
+#define DMA_CH0_EUSCIA0TX           0x01000000
+
+#define UDMA_PRI_SELECT             0x00000000
+#define UDMA_ALT_SELECT             0x00000008
+
+#define UDMA_ATTR_USEBURST          0x00000001
+#define UDMA_ATTR_ALTSELECT         0x00000002
+#define UDMA_ATTR_HIGH_PRIORITY     0x00000004
+#define UDMA_ATTR_REQMASK           0x00000008
+#define UDMA_ATTR_ALL               0x0000000F
+
+#define UDMA_DST_INC_8              0x00000000
+#define UDMA_DST_INC_16             0x40000000
+#define UDMA_DST_INC_32             0x80000000
+#define UDMA_DST_INC_NONE           0xc0000000
+#define UDMA_SRC_INC_8              0x00000000
+#define UDMA_SRC_INC_16             0x04000000
+#define UDMA_SRC_INC_32             0x08000000
+#define UDMA_SRC_INC_NONE           0x0c000000
+#define UDMA_SIZE_8                 0x00000000
+#define UDMA_SIZE_16                0x11000000
+#define UDMA_SIZE_32                0x22000000
+#define UDMA_ARB_1                  0x00000000
+
+#define UDMA_MODE_STOP              0x00000000
+#define UDMA_MODE_BASIC             0x00000001
+
+void DMA_enableModule(void);
+void DMA_disableModule(void);
+void DMA_setControlBase(void *controlTable);
+void DMA_assignChannel(uint32_t mapping);
+void DMA_enableChannelAttribute(uint32_t channelNum, uint32_t attr);
+void DMA_disableChannelAttribute(uint32_t channelNum, uint32_t attr);
+void DMA_setChannelControl(uint32_t channelStructIndex, uint32_t control);
+void DMA_setChannelTransfer(uint32_t channelStructIndex, uint32_t mode,
+                            void *srcAddr, void *dstAddr, uint32_t transferSize);
+void DMA_enableChannel(uint32_t channelNum);
+void DMA_disableChannel(uint32_t channelNum);
+bool DMA_isChannelEnabled(uint32_t channelNum);
+uint32_t DMA_getChannelMode(uint32_t channelStructIndex);
+void DMA_requestSoftwareTransfer(uint32_t channel);
+
+#define MAP_DMA_enableModule                DMA_enableModule
+#define MAP_DMA_disableModule               DMA_disableModule
+#define MAP_DMA_setControlBase              DMA_setControlBase
+#define MAP_DMA_assignChannel               DMA_assignChannel
+#define MAP_DMA_enableChannelAttribute      DMA_enableChannelAttribute
+#define MAP_DMA_disableChannelAttribute     DMA_disableChannelAttribute
+#define MAP_DMA_setChannelControl           DMA_setChannelControl
+#define MAP_DMA_setChannelTransfer          DMA_setChannelTransfer
+#define MAP_DMA_enableChannel               DMA_enableChannel
+#define MAP_DMA_disableChannel              DMA_disableChannel
+#define MAP_DMA_isChannelEnabled            DMA_isChannelEnabled
+#define MAP_DMA_getChannelMode              DMA_getChannelMode
+#define MAP_DMA_requestSoftwareTransfer     DMA_requestSoftwareTransfer
+
+/*-------------------------------------------------------------------------
+ * Flash controller.  Erase and program only.
+ *
+ * FlashCtl_eraseSector() takes the sector address as an integer.  On the
+ * host the "flash" is an ordinary 64 bit pointer, so here it is a uintptr_t,
+ * which is uint32_t on target.  Cast the address with (uintptr_t).
+ *-----------------------------------------------------------------------*/
+#define FLASH_MAIN_MEMORY_SPACE_BANK0   0x01
+#define FLASH_MAIN_MEMORY_SPACE_BANK1   0x02
+#define FLASH_INFO_MEMORY_SPACE_BANK0   0x03
+#define FLASH_INFO_MEMORY_SPACE_BANK1   0x04
+
+#define FLASH_SECTOR29                  0x20000000
+#define FLASH_SECTOR30                  0x40000000
+#define FLASH_SECTOR31                  0x80000000
+
+bool FlashCtl_protectSector(uint_fast8_t memorySpace, uint32_t sectorMask);
+bool FlashCtl_unprotectSector(uint_fast8_t memorySpace, uint32_t sectorMask);
+bool FlashCtl_eraseSector(uintptr_t addr);
+bool FlashCtl_programMemory(void *src, void *dest, uint32_t length);
+
+#define MAP_FlashCtl_protectSector          FlashCtl_protectSector
+#define MAP_FlashCtl_unprotectSector        FlashCtl_unprotectSector
+#define MAP_FlashCtl_eraseSector            FlashCtl_eraseSector
+#define MAP_FlashCtl_programMemory          FlashCtl_programMemory
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SIM_DRIVERLIB_H_ */
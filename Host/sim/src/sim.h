@@ -0,0 +1,122 @@
+/*
+ * sim.h
+ *
+ * Host simulator of the MSP432P401R as used by the robot labs.
+ *
+ * Simulated time only moves when the firmware touches the hardware: every
+ * register access, DriverLib call and __delay_cycles() charges MCLK cycles.
+ * While time advances the peripheral models run (SysTick, Timer_A, eUSCI_B,
+ * the OPT3001) along with any hooks registered by the environment, and
+ * pending interrupts are dispatched to the firmware handlers.
+ *
+ * Time is kept in ticks of SIM_TICK_HZ so MCLK can change at run time.
+ */
+#ifndef SIM_H_
+#define SIM_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define SIM_TICK_HZ         48000000ULL     /* simulated time base */
+#define SIM_TICKS_PER_MS    (SIM_TICK_HZ / 1000)
+#define SIM_TICKS_PER_US    (SIM_TICK_HZ / 1000000)
+
+/*-------------------------------------------------------------------------
+ * Core: time, clocks, run control
+ *-----------------------------------------------------------------------*/
+void sim_reset(void);
+int sim_run(int (*firmware)(void), double seconds);
+void sim_stop(void);
+void sim_fault(const char *fmt, ...);
+void sim_device_reset(const char *cause);  /* ends the run, sim_run() returns 4 */
+void sim_hang(void);                    /* the firmware's main context stops making progress */
+
+uint64_t sim_now(void);
+double sim_seconds(void);
+uint32_t sim_mclk_hz(void);
+uint32_t sim_hsmclk_hz(void);
+uint32_t sim_smclk_hz(void);
+uint32_t sim_power_mode(void);      /* PCM active mode: 0 LDO VCORE0, 1 LDO VCORE1, 4/5 DC-DC */
+void sim_hfxt_set_broken(bool broken);  /* the 48 MHz crystal never starts, survives sim_reset() */
+
+/* Hooks called every period_ticks of simulated time, in registration order */
+typedef void (*sim_hook_t)(void *ctx);
+void sim_add_hook(uint64_t period_ticks, sim_hook_t hook, void *ctx);
+
+/* Peripheral models report their next event so time steps stop there */
+void sim_schedule(uint64_t when);
+
+/*-------------------------------------------------------------------------
+ * Interrupts
+ *-----------------------------------------------------------------------*/
+typedef void (*sim_isr_t)(void);
+
+bool sim_irq_enabled(uint32_t interruptNumber);
+void sim_irq_set_enabled(uint32_t interruptNumber, bool enabled);
+void sim_systick_pend(void);
+bool sim_in_isr(void);
+
+/*-------------------------------------------------------------------------
+ * GPIO environment.  External drive overrides pull resistors on input pins.
+ *-----------------------------------------------------------------------*/
+void sim_gpio_drive(unsigned port, uint8_t pins, uint8_t levels);
+void sim_gpio_release(unsigned port, uint8_t pins);
+void sim_gpio_sync(unsigned port);
+uint8_t sim_gpio_output(unsigned port);     /* OUT, masked by DIR */
+uint8_t sim_gpio_dir(unsigned port);
+bool sim_gpio_irq_pending(unsigned port);
+
+/*
+ * An input model is called whenever the port is sampled, including right
+ * after the firmware writes to it, so it can drive pins whose level depends
+ * on exactly when the firmware changed DIR or OUT (e.g. RC decay sensors).
+ */
+typedef void (*sim_gpio_model_t)(void *ctx, unsigned port);
+void sim_gpio_attach_model(unsigned port, sim_gpio_model_t model, void *ctx);
+
+/*-------------------------------------------------------------------------
+ * Timer_A
+ *-----------------------------------------------------------------------*/
+float sim_timer_a_duty(unsigned timer, unsigned ccr);
+void sim_timer_a_step(void);
+
+/*-------------------------------------------------------------------------
+ * eUSCI_B I2C bus and slaves
+ *-----------------------------------------------------------------------*/
+typedef struct
+{
+    uint8_t address;
+    void *ctx;
+    bool (*start)(void *ctx, bool read);    /* returns ACK of the address byte */
+    void (*write)(void *ctx, uint8_t data);
+    uint8_t (*read)(void *ctx);
+    void (*stop)(void *ctx);
+} sim_i2c_slave_t;
+
+void sim_i2c_attach(unsigned module, const sim_i2c_slave_t *slave);
+void sim_i2c_step(void);
+bool sim_i2c_irq_pending(unsigned module);
+uint32_t sim_i2c_bit_rate(unsigned module);
+
+/*-------------------------------------------------------------------------
+ * eUSCI_A UART transmitters and the uDMA
+ *-----------------------------------------------------------------------*/
+typedef void (*sim_uart_sink_t)(void *ctx, uint8_t data);
+
+/* The sink gets every byte as its stop bit ends */
+void sim_uart_attach(unsigned module, sim_uart_sink_t sink, void *ctx);
+uint32_t sim_uart_baud_rate(unsigned module);
+void sim_uart_step(void);
+
+void sim_dma_step(void);
+uint32_t sim_dma_transfers(void);
+
+/*-------------------------------------------------------------------------
+ * OPT3001 ambient light sensor on eUSCI_B1, INT on P4.1
+ *-----------------------------------------------------------------------*/
+void sim_opt3001_reset(void);
+void sim_opt3001_set_lux(double lux);
+void sim_opt3001_set_present(bool present);
+uint32_t sim_opt3001_transfers(void);
+
+#endif /* SIM_H_ */
@@ -0,0 +1,687 @@
+/*
+ * sim_core.c
+ *
+ * Simulated register file, clock system, time base, SysTick and interrupt
+ * dispatch.  See sim.h.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <setjmp.h>
+#include "msp.h"
+#include "ti/devices/msp432p4xx/driverlib/driverlib.h"
+#include "sim.h"
+#include "sim_internal.h"
+
+/* Register file */
+DIO_PORT_Type sim_port[SIM_NUM_PORTS];
+PCM_Type sim_pcm;
+CS_Type sim_cs;
+FLCTL_Type sim_flctl;
+Timer_A_Type sim_timer_a[4];
+EUSCI_B_Type sim_eusci_b[4];
+WDT_A_Type sim_wdt_a;
+SysTick_Type sim_systick;
+DWT_Type sim_dwt;
+CoreDebug_Type sim_coredebug;
+SCB_Type sim_scb;
+MPU_Type sim_mpu;
+
+#define SIM_MAX_HOOKS       16
+#define SIM_NEVER           UINT64_MAX
+#define SIM_STORM_LIMIT     100000      /* back to back interrupts without time passing */
+#define SIM_HFXT_START_US   2000        /* 48 MHz crystal start-up */
+
+typedef struct
+{
+    uint64_t period;
+    uint64_t next;
+    sim_hook_t hook;
+    void *ctx;
+} sim_hook_entry_t;
+
+static uint64_t now;
+static uint64_t limit = SIM_NEVER;
+static uint64_t nextModelEvent = SIM_NEVER;
+static uint32_t cycleTicks = SIM_TICK_HZ / 3000000;    /* ticks per MCLK cycle */
+static uint64_t cycleRemainder;                        /* ticks not yet counted as a whole cycle */
+static uint32_t mclkHz, hsmclkHz, smclkHz;
+static uint32_t pcmMode;                               /* current active mode, CPM */
+static bool hfxtOn;                                    /* HFXT_EN seen set */
+static uint64_t hfxtStable;                            /* when the crystal has started */
+static bool hfxtBroken;                                /* environment: the crystal never starts */
+
+static sim_hook_entry_t hooks[SIM_MAX_HOOKS];
+static unsigned numHooks;
+
+static bool primask;
+static bool inIsr;
+static bool inModel;
+static bool systickPending;
+static bool nvicEnabled[NUM_INTERRUPTS];
+static bool running;
+static bool hangPending;
+static jmp_buf exitJump;
+
+/*-------------------------------------------------------------------------
+ * Clock system
+ *-----------------------------------------------------------------------*/
+static uint32_t sim_clock_source_hz(uint32_t sel)
+{
+    static const uint32_t dcoHz[8] =
+    {
+        1500000, 3000000, 6000000, 12000000, 24000000, 48000000, 48000000, 48000000
+    };
+    uint32_t dco = dcoHz[(sim_cs.CTL0 >> 16) & 0x7];
+
+    switch (sel)
+    {
+    case 0:  return 32768;                                      /* LFXT */
+    case 1:  return 9400;                                       /* VLO */
+    case 2:  return 32768;                                      /* REFO */
+    case 4:  return 24000000;                                   /* MODOSC */
+    case 5:                                                     /* HFXT */
+        if (!(sim_cs.CTL2 & 0x01000000))
+            return dco;
+        if (sim_cs.IFG & CS_IFG_HFXTIFG)
+            sim_fault("HFXT selected while its fault flag is set");
+        return 48000000;
+    default: return dco;                                        /* DCO */
+    }
+}
+
+/*
+ * The crystal starts SIM_HFXT_START_US after HFXT_EN is set.  Until then,
+ * or for ever if it is broken, HFXTIFG comes straight back after a clear.
+ */
+static void sim_hfxt_update(void)
+{
+    bool enabled = (sim_cs.CTL2 & 0x01000000) != 0;
+
+    if (enabled && !hfxtOn)
+        hfxtStable = now + SIM_HFXT_START_US * SIM_TICKS_PER_US;
+    hfxtOn = enabled;
+
+    sim_cs.IFG &= ~sim_cs.CLRIFG;
+    sim_cs.CLRIFG = 0;
+    if (hfxtOn && (hfxtBroken || (now < hfxtStable)))
+        sim_cs.IFG |= CS_IFG_HFXTIFG;
+}
+
+void sim_hfxt_set_broken(bool broken)
+{
+    hfxtBroken = broken;
+}
+
+static void sim_clock_sync(void)
+{
+    uint32_t ctl1 = sim_cs.CTL1;
+
+    mclkHz = sim_clock_source_hz(ctl1 & 0x7) >> ((ctl1 >> 16) & 0x7);
+    hsmclkHz = sim_clock_source_hz((ctl1 >> 4) & 0x7) >> ((ctl1 >> 20) & 0x7);
+    smclkHz = sim_clock_source_hz((ctl1 >> 4) & 0x7) >> ((ctl1 >> 28) & 0x7);
+
+    cycleTicks = (uint32_t)(SIM_TICK_HZ / mclkHz);
+    if (cycleTicks == 0)
+        cycleTicks = 1;
+
+    /* Active modes with an even number run at VCORE0 */
+    if (!(pcmMode & 1) && (mclkHz > 24000000))
+        sim_fault("MCLK at %u Hz in VCORE0, the limit is 24 MHz", mclkHz);
+}
+
+uint32_t sim_mclk_hz(void)
+{
+    sim_clock_sync();
+    return mclkHz;
+}
+
+uint32_t sim_hsmclk_hz(void)
+{
+    sim_clock_sync();
+    return hsmclkHz;
+}
+
+uint32_t sim_smclk_hz(void)
+{
+    sim_clock_sync();
+    return smclkHz;
+}
+
+uint32_t sim_power_mode(void)
+{
+    return pcmMode;
+}
+
+/*-------------------------------------------------------------------------
+ * Interrupts
+ *-----------------------------------------------------------------------*/
+bool sim_irq_enabled(uint32_t interruptNumber)
+{
+    return (interruptNumber < NUM_INTERRUPTS) && nvicEnabled[interruptNumber];
+}
+
+void sim_irq_set_enabled(uint32_t interruptNumber, bool enabled)
+{
+    if (interruptNumber < NUM_INTERRUPTS)
+        nvicEnabled[interruptNumber] = enabled;
+}
+
+void sim_systick_pend(void)
+{
+    systickPending = true;
+}
+
+bool sim_in_isr(void)
+{
+    return inIsr;
+}
+
+static bool sim_irq_pending(uint32_t n)
+{
+    if (!nvicEnabled[n])
+        return false;
+
+    if ((n >= INT_PORT1) && (n <= INT_PORT6))
+        return sim_gpio_irq_pending(n - INT_PORT1 + 1);
+
+    if ((n >= INT_EUSCIB0) && (n <= INT_EUSCIB3))
+        return sim_i2c_irq_pending(n - INT_EUSCIB0);
+
+    return sim_peripheral_irq_pending(n);
+}
+
+static void sim_run_isr(uint32_t n)
+{
+    inIsr = true;
+    sim_cycles(12);                     /* exception entry */
+    sim_vector(n)();
+    sim_cycles(10);                     /* exception return */
+    inIsr = false;
+}
+
+/* Run every pending interrupt, SysTick first then by vector number */
+static void sim_dispatch(void)
+{
+    uint32_t n, storm = 0;
+    bool found;
+
+    if (primask || inIsr)
+        return;
+
+    do
+    {
+        found = false;
+
+        if (systickPending)
+        {
+            systickPending = false;
+            sim_run_isr(FAULT_SYSTICK);
+            found = true;
+        }
+        else
+        {
+            for (n = 16; n < NUM_INTERRUPTS; n++)
+            {
+                if (sim_irq_pending(n))
+                {
+                    sim_run_isr(n);
+                    found = true;
+                    break;
+                }
+            }
+        }
+
+        if (found && (++storm >= SIM_STORM_LIMIT))
+            sim_fault("interrupt storm, a handler is not clearing its flag");
+    }
+    while (found && !primask);
+}
+
+/*-------------------------------------------------------------------------
+ * SysTick and the cycle counter
+ *-----------------------------------------------------------------------*/
+static uint64_t sim_systick_cycles_to_wrap(void)
+{
+    return sim_systick.VAL ? sim_systick.VAL : (uint64_t)(sim_systick.LOAD & SysTick_LOAD_RELOAD_Msk) + 1;
+}
+
+static void sim_count_cycles(uint64_t cycles)
+{
+    uint64_t toWrap;
+
+    if ((sim_coredebug.DEMCR & CoreDebug_DEMCR_TRCENA_Msk) && (sim_dwt.CTRL & DWT_CTRL_CYCCNTENA_Msk))
+        sim_dwt.CYCCNT += (uint32_t)cycles;
+
+    if (!(sim_systick.CTRL & SysTick_CTRL_ENABLE_Msk))
+        return;
+
+    while (cycles)
+    {
+        toWrap = sim_systick_cycles_to_wrap();
+
+        if (cycles >= toWrap)
+        {
+            cycles -= toWrap;
+            sim_systick.VAL = 0;
+            sim_systick.CTRL |= SysTick_CTRL_COUNTFLAG_Msk;
+            if (sim_systick.CTRL & SysTick_CTRL_TICKINT_Msk)
+                systickPending = true;
+        }
+        else
+        {
+            sim_systick.VAL = (uint32_t)(toWrap - cycles);
+            cycles = 0;
+        }
+    }
+}
+
+/*-------------------------------------------------------------------------
+ * Time
+ *-----------------------------------------------------------------------*/
+uint64_t sim_now(void)
+{
+    return now;
+}
+
+double sim_seconds(void)
+{
+    return (double)now / SIM_TICK_HZ;
+}
+
+void sim_schedule(uint64_t when)
+{
+    if (when < nextModelEvent)
+        nextModelEvent = when;
+}
+
+void sim_add_hook(uint64_t period_ticks, sim_hook_t hook, void *ctx)
+{
+    if (numHooks >= SIM_MAX_HOOKS)
+    {
+        sim_fault("too many hooks");
+        return;
+    }
+
+    hooks[numHooks].period = period_ticks ? period_ticks : 1;
+    hooks[numHooks].next = now + hooks[numHooks].period;
+    hooks[numHooks].hook = hook;
+    hooks[numHooks].ctx = ctx;
+    numHooks++;
+}
+
+static uint64_t sim_next_event(uint64_t target)
+{
+    uint64_t next = target;
+    uint64_t t;
+    unsigned i;
+
+    if (nextModelEvent < next)
+        next = nextModelEvent;
+
+    if (limit < next)
+        next = limit;
+
+    for (i = 0; i < numHooks; i++)
+    {
+        if (hooks[i].next < next)
+            next = hooks[i].next;
+    }
+
+    if ((sim_systick.CTRL & SysTick_CTRL_ENABLE_Msk))
+    {
+        t = now + (sim_systick_cycles_to_wrap() * cycleTicks) - cycleRemainder;
+        if (t < next)
+            next = t;
+    }
+
+    return (next > now) ? next : now + 1;
+}
+
+/* Run the models for everything that happens up to 'now' */
+static void sim_models(void)
+{
+    unsigned i, p;
+
+    inModel = true;
+
+    nextModelEvent = SIM_NEVER;
+    sim_i2c_step();
+    sim_uart_step();
+    sim_dma_step();
+    sim_timer_a_step();
+    sim_peripheral_step();
+
+    for (i = 0; i < numHooks; i++)
+    {
+        while (hooks[i].next <= now)
+        {
+            hooks[i].hook(hooks[i].ctx);
+            hooks[i].next += hooks[i].period;
+        }
+    }
+
+    for (p = 1; p < SIM_NUM_PORTS; p++)
+        sim_gpio_sync(p);
+
+    inModel = false;
+}
+
+static void sim_advance_to(uint64_t target)
+{
+    uint64_t next, elapsed;
+
+    while (now < target)
+    {
+        next = sim_next_event(target);
+        if (next > target)
+            next = target;
+
+        elapsed = next - now + cycleRemainder;
+        now = next;
+        cycleRemainder = elapsed % cycleTicks;
+        sim_count_cycles(elapsed / cycleTicks);
+
+        if (now >= limit)
+            sim_stop();
+
+        sim_models();
+        sim_dispatch();
+    }
+}
+
+/* Spend MCLK cycles.  Called for every register access and DriverLib call. */
+void sim_cycles(uint32_t cycles)
+{
+    if (inModel)
+        return;
+
+    sim_gpio_flush();
+    sim_clock_sync();
+    sim_advance_to(now + (uint64_t)cycles * cycleTicks);
+
+    /* Stuck in a busy-wait for good, interrupts still taken */
+    if (hangPending && !inIsr)
+    {
+        hangPending = false;
+        while (1)
+            sim_advance_to(now + SIM_TICKS_PER_MS);
+    }
+}
+
+void sim_hang(void)
+{
+    hangPending = true;
+}
+
+void __delay_cycles(uint32_t cycles)
+{
+    sim_cycles(cycles);
+}
+
+/* Sleep until the next event wakes the CPU */
+void sim_wfi(void)
+{
+    uint64_t start = now;
+
+    sim_gpio_flush();
+    sim_clock_sync();
+    while (now == start)
+        sim_advance_to(sim_next_event(now + SIM_TICKS_PER_MS));
+}
+
+void sim_enable_irq(void)
+{
+    primask = false;
+    sim_dispatch();
+}
+
+void sim_disable_irq(void)
+{
+    primask = true;
+}
+
+uint32_t sim_get_primask(void)
+{
+    return primask;
+}
+
+void sim_set_primask(uint32_t mask)
+{
+    primask = (mask != 0);
+    if (!primask)
+        sim_dispatch();
+}
+
+/*-------------------------------------------------------------------------
+ * Register accessors
+ *-----------------------------------------------------------------------*/
+DIO_PORT_Type *sim_port_reg(unsigned port)
+{
+    sim_cycles(1);
+    sim_gpio_sync(port);
+    sim_gpio_touch(port);
+    return &sim_port[port];
+}
+
+/* Active mode requests the PCM accepts from each mode (TRM state diagram) */
+static bool sim_pcm_valid_transition(uint32_t from, uint32_t to)
+{
+    if (from == to)
+        return true;
+
+    switch (from)
+    {
+    case 0:  return (to == 1) || (to == 4) || (to == 8);
+    case 1:  return (to == 0) || (to == 5) || (to == 9);
+    case 4:
+    case 8:  return to == 0;
+    case 5:
+    case 9:  return to == 1;
+    default: return false;
+    }
+}
+
+PCM_Type *sim_pcm_reg(void)
+{
+    uint32_t amr;
+
+    sim_cycles(1);
+
+    sim_pcm.IFG &= ~sim_pcm.CLRIFG;
+    sim_pcm.CLRIFG = 0;
+
+    /*
+     * Mode changes complete immediately: CPM follows AMR, key reads back
+     * clear.  A request the state diagram does not allow sets the invalid
+     * transition flag and leaves the mode alone.
+     */
+    amr = sim_pcm.CTL0 & PCM_CTL0_AMR_MASK;
+
+    if (!sim_pcm_valid_transition(pcmMode, amr))
+    {
+        sim_pcm.IFG |= PCM_IFG_AM_INVALID_TR_IFG;
+        amr = pcmMode;
+    }
+    else if (!(amr & 1) && (amr != pcmMode) && (sim_mclk_hz() > 24000000))
+    {
+        sim_fault("PCM: VCORE0 requested with MCLK at %u Hz, the limit is 24 MHz", sim_mclk_hz());
+    }
+
+    pcmMode = amr;
+    sim_pcm.CTL0 = (sim_pcm.CTL0 & 0x0000FFFF & ~(PCM_CTL0_CPM_MASK | PCM_CTL0_AMR_MASK)) |
+                   amr | (pcmMode << PCM_CTL0_CPM_OFS);
+    sim_pcm.CTL1 &= ~PCM_CTL1_PMR_BUSY;
+
+    return &sim_pcm;
+}
+
+CS_Type *sim_cs_reg(void)
+{
+    /* Pick up the previous write, the CS->KEY lock after a change included */
+    sim_hfxt_update();
+    sim_clock_sync();
+    sim_cycles(1);
+    return &sim_cs;
+}
+
+FLCTL_Type *sim_flctl_reg(void)
+{
+    sim_cycles(1);
+    return &sim_flctl;
+}
+
+Timer_A_Type *sim_timer_a_reg(unsigned n)
+{
+    sim_cycles(1);
+    return &sim_timer_a[n];
+}
+
+EUSCI_B_Type *sim_eusci_b_reg(unsigned n)
+{
+    sim_cycles(1);
+    return &sim_eusci_b[n];
+}
+
+WDT_A_Type *sim_wdt_a_reg(void)
+{
+    sim_cycles(1);
+    return &sim_wdt_a;
+}
+
+SysTick_Type *sim_systick_reg(void)
+{
+    sim_cycles(1);
+    return &sim_systick;
+}
+
+DWT_Type *sim_dwt_reg(void)
+{
+    sim_cycles(1);
+    return &sim_dwt;
+}
+
+CoreDebug_Type *sim_coredebug_reg(void)
+{
+    sim_cycles(1);
+    return &sim_coredebug;
+}
+
+SCB_Type *sim_scb_reg(void)
+{
+    sim_cycles(1);
+    return &sim_scb;
+}
+
+MPU_Type *sim_mpu_reg(void)
+{
+    sim_cycles(1);
+    return &sim_mpu;
+}
+
+/*-------------------------------------------------------------------------
+ * Run control
+ *-----------------------------------------------------------------------*/
+void sim_reset(void)
+{
+    memset(sim_port, 0, sizeof(sim_port));
+    memset(&sim_pcm, 0, sizeof(sim_pcm));
+    pcmMode = 0;
+    memset(&sim_cs, 0, sizeof(sim_cs));
+    hfxtOn = false;
+    memset(&sim_flctl, 0, sizeof(sim_flctl));
+    memset(sim_timer_a, 0, sizeof(sim_timer_a));
+    memset(sim_eusci_b, 0, sizeof(sim_eusci_b));
+    memset(&sim_systick, 0, sizeof(sim_systick));
+    memset(&sim_dwt, 0, sizeof(sim_dwt));
+    memset(&sim_coredebug, 0, sizeof(sim_coredebug));
+    memset(&sim_scb, 0, sizeof(sim_scb));
+    memset(&sim_mpu, 0, sizeof(sim_mpu));
+    memset(nvicEnabled, 0, sizeof(nvicEnabled));
+
+    /* Reset state after SystemInit(): DCO 3 MHz on MCLK and SMCLK, watchdog held */
+    sim_cs.CTL0 = 0x00010000;
+    sim_cs.CTL1 = 0x00000033;
+    sim_wdt_a.CTL = WDT_A_CTL_PW | WDT_A_CTL_HOLD;
+
+    /* Lab9's SystemInit() also starts the cycle counter to time the boot */
+    sim_coredebug.DEMCR = CoreDebug_DEMCR_TRCENA_Msk;
+    sim_dwt.CTRL = DWT_CTRL_CYCCNTENA_Msk;
+    sim_scb.CPUID = 0x410FC241;
+    sim_mpu.TYPE = 0x00000800;          /* 8 regions */
+
+    now = 0;
+    limit = SIM_NEVER;
+    nextModelEvent = SIM_NEVER;
+    cycleRemainder = 0;
+    numHooks = 0;
+    primask = false;
+    hangPending = false;
+    inIsr = false;
+    inModel = false;
+    systickPending = false;
+    sim_clock_sync();
+
+    sim_gpio_reset();
+    sim_i2c_reset();
+    sim_uart_reset();
+    sim_dma_reset();
+    sim_flash_reset();
+    sim_peripheral_reset();
+    sim_opt3001_reset();
+}
+
+/*
+ * Run the firmware for the given simulated time.  Returns 0 when the time
+ * is up (or the firmware returned), 2 on a simulation fault.
+ */
+int sim_run(int (*firmware)(void), double seconds)
+{
+    volatile int result;
+
+    limit = now + (uint64_t)(seconds * SIM_TICK_HZ);
+    running = true;
+
+    result = setjmp(exitJump);
+    if (result == 0)
+        firmware();
+
+    running = false;
+    inIsr = false;
+    inModel = false;
+
+    return (result == 1) ? 0 : result;
+}
+
+void sim_stop(void)
+{
+    if (running)
+        longjmp(exitJump, 1);
+    exit(0);
+}
+
+void sim_device_reset(const char *cause)
+{
+    fprintf(stderr, "sim: device reset at %.6f s: %s\n", sim_seconds(), cause);
+
+    if (running)
+        longjmp(exitJump, 4);
+    exit(4);
+}
+
+void sim_fault(const char *fmt, ...)
+{
+    va_list args;
+
+    fprintf(stderr, "sim: fault at %.6f s: ", sim_seconds());
+    va_start(args, fmt);
+    vfprintf(stderr, fmt, args);
+    va_end(args);
+    fputc('\n', stderr);
+
+    if (running)
+        longjmp(exitJump, 2);
+    exit(2);
+}
@@ -0,0 +1,211 @@
+/*
+ * sim_dma.c
+ *
+ * uDMA model and DriverLib API.
+ *
+ * Basic mode only, with the peripheral side being a UART TXBUF.  A channel
+ * moves one item per request: a rising edge of its trigger (TXIFG of the
+ * assigned eUSCI_A) or DMA_requestSoftwareTransfer().  Requests that arrive
+ * while the channel is disabled are lost, so like on the part a transfer to
+ * an idle UART, whose TXIFG is already set, has to be started by software.
+ * The channel disables itself when the transfer is complete.
+ */
+
+#include <string.h>
+#include "msp.h"
+#include "ti/devices/msp432p4xx/driverlib/driverlib.h"
+#include "sim.h"
+#include "sim_internal.h"
+
+#define SIM_DMA_CHANNELS    8
+
+typedef struct
+{
+    uint32_t mapping;                   /* DMA_CHn_xxx, 0 if not assigned */
+    uint32_t control;
+    uint32_t mode;
+    const uint8_t *src;
+    uint32_t dst;
+    uint32_t remaining;
+    bool enabled;
+    bool masked;
+    unsigned pending;
+} sim_dma_channel_t;
+
+static bool moduleEnabled;
+static void *controlBase;
+static sim_dma_channel_t channel[SIM_DMA_CHANNELS];
+static uint32_t transfers;
+
+void sim_dma_reset(void)
+{
+    moduleEnabled = false;
+    controlBase = NULL;
+    transfers = 0;
+    memset(channel, 0, sizeof(channel));
+}
+
+uint32_t sim_dma_transfers(void)
+{
+    return transfers;
+}
+
+void sim_dma_request(uint32_t mapping)
+{
+    sim_dma_channel_t *c = &channel[mapping & 0x7];
+
+    if (moduleEnabled && c->enabled && !c->masked && (c->mapping == mapping))
+        c->pending++;
+}
+
+/* Move one item */
+static void sim_dma_transfer(unsigned n)
+{
+    sim_dma_channel_t *c = &channel[n];
+    unsigned module;
+    unsigned srcInc;
+
+    if (!c->enabled || !c->remaining || (c->mode != UDMA_MODE_BASIC))
+        return;
+
+    if ((c->control & UDMA_SIZE_32) != UDMA_SIZE_8)
+        sim_fault("DMA channel %u: only 8 bit items are modelled", n);
+
+    if (!sim_uart_is_txbuf(c->dst, &module))
+    {
+        sim_fault("DMA channel %u: destination 0x%08X is not a UART TXBUF", n, c->dst);
+        return;
+    }
+
+    srcInc = ((c->control & UDMA_SRC_INC_NONE) == UDMA_SRC_INC_NONE) ? 0 : 1;
+
+    sim_uart_write(module, *c->src);
+    c->src += srcInc;
+    transfers++;
+
+    if (--c->remaining == 0)
+    {
+        c->enabled = false;
+        c->mode = UDMA_MODE_STOP;
+        c->pending = 0;
+    }
+}
+
+void sim_dma_step(void)
+{
+    unsigned n;
+
+    for (n = 0; n < SIM_DMA_CHANNELS; n++)
+    {
+        while (channel[n].pending)
+        {
+            channel[n].pending--;
+            sim_dma_transfer(n);
+        }
+    }
+}
+
+/*-------------------------------------------------------------------------
+ * DriverLib
+ *-----------------------------------------------------------------------*/
+static sim_dma_channel_t *sim_dma_call(uint32_t channelNum)
+{
+    sim_cycles(SIM_DRIVERLIB_CYCLES);
+    return &channel[channelNum & 0x7];
+}
+
+void DMA_enableModule(void)
+{
+    sim_cycles(SIM_DRIVERLIB_CYCLES);
+    moduleEnabled = true;
+}
+
+void DMA_disableModule(void)
+{
+    sim_cycles(SIM_DRIVERLIB_CYCLES);
+    moduleEnabled = false;
+}
+
+void DMA_setControlBase(void *controlTable)
+{
+    sim_cycles(SIM_DRIVERLIB_CYCLES);
+
+    if ((uintptr_t)controlTable & 0xFF)
+        sim_fault("DMA control table %p is not 256 byte aligned", controlTable);
+
+    controlBase = controlTable;
+}
+
+void DMA_assignChannel(uint32_t mapping)
+{
+    sim_dma_call(mapping)->mapping = mapping;
+}
+
+void DMA_enableChannelAttribute(uint32_t channelNum, uint32_t attr)
+{
+    sim_dma_channel_t *c = sim_dma_call(channelNum);
+
+    if (attr & UDMA_ATTR_REQMASK)
+        c->masked = true;
+}
+
+void DMA_disableChannelAttribute(uint32_t channelNum, uint32_t attr)
+{
+    sim_dma_channel_t *c = sim_dma_call(channelNum);
+
+    if (attr & UDMA_ATTR_REQMASK)
+        c->masked = false;
+}
+
+void DMA_setChannelControl(uint32_t channelStructIndex, uint32_t control)
+{
+    sim_dma_call(channelStructIndex)->control = control;
+}
+
+void DMA_setChannelTransfer(uint32_t channelStructIndex, uint32_t mode,
+                            void *srcAddr, void *dstAddr, uint32_t transferSize)
+{
+    sim_dma_channel_t *c = sim_dma_call(channelStructIndex);
+
+    if (!controlBase)
+        sim_fault("DMA_setChannelTransfer() before DMA_setControlBase()");
+
+    if ((transferSize == 0) || (transferSize > 1024))
+        sim_fault("DMA transfer size %u out of range 1-1024", transferSize);
+
+    c->mode = mode;
+    c->src = srcAddr;
+    c->dst = (uint32_t)(uintptr_t)dstAddr;
+    c->remaining = transferSize;
+}
+
+void DMA_enableChannel(uint32_t channelNum)
+{
+    sim_dma_channel_t *c = sim_dma_call(channelNum);
+
+    c->enabled = true;
+    c->pending = 0;
+}
+
+void DMA_disableChannel(uint32_t channelNum)
+{
+    sim_dma_call(channelNum)->enabled = false;
+}
+
+bool DMA_isChannelEnabled(uint32_t channelNum)
+{
+    return sim_dma_call(channelNum)->enabled;
+}
+
+uint32_t DMA_getChannelMode(uint32_t channelStructIndex)
+{
+    return sim_dma_call(channelStructIndex)->mode;
+}
+
+void DMA_requestSoftwareTransfer(uint32_t channelNum)
+{
+    sim_dma_call(channelNum);
+
+    if (moduleEnabled)
+        sim_dma_transfer(channelNum & 0x7);
+}
@@ -0,0 +1,274 @@
+/*
+ * sim_driverlib.c
+ *
+ * DriverLib for the peripherals without a model of their own: the NVIC,
+ * SysTick, the clock system, the watchdog and system control.  GPIO,
+ * Timer_A and eUSCI_B live with their models.
+ */
+
+#include "msp.h"
+#include "ti/devices/msp432p4xx/driverlib/driverlib.h"
+#include "sim.h"
+#include "sim_internal.h"
+
+static uint8_t priority[NUM_INTERRUPTS];
+
+static bool wdtRunning;
+static uint64_t wdtCleared;             /* last count clear */
+static uint_fast8_t wdtResetType = WDT_A_HARD_RESET;
+
+static void sim_wdt_step(void);
+
+void sim_peripheral_reset(void)
+{
+    unsigned i;
+
+    wdtRunning = false;
+    wdtResetType = WDT_A_HARD_RESET;
+
+    for (i = 0; i < NUM_INTERRUPTS; i++)
+        priority[i] = 0;
+}
+
+void sim_peripheral_step(void)
+{
+    sim_wdt_step();
+}
+
+bool sim_peripheral_irq_pending(uint32_t interruptNumber)
+{
+    (void)interruptNumber;
+    return false;
+}
+
+/*-------------------------------------------------------------------------
+ * Interrupt controller
+ *-----------------------------------------------------------------------*/
+void Interrupt_enableInterrupt(uint32_t interruptNumber)
+{
+    sim_cycles(SIM_DRIVERLIB_CYCLES);
+
+    if (interruptNumber == FAULT_SYSTICK)
+        SysTick_enableInterrupt();
+    else
+        sim_irq_set_enabled(interruptNumber, true);
+}
+
+void Interrupt_disableInterrupt(uint32_t interruptNumber)
+{
+    sim_cycles(SIM_DRIVERLIB_CYCLES);
+
+    if (interruptNumber == FAULT_SYSTICK)
+        SysTick_disableInterrupt();
+    else
+        sim_irq_set_enabled(interruptNumber, false);
+}
+
+bool Interrupt_isEnabled(uint32_t interruptNumber)
+{
+    sim_cycles(SIM_DRIVERLIB_CYCLES);
+    return sim_irq_enabled(interruptNumber);
+}
+
+void Interrupt_setPriority(uint32_t interruptNumber, uint8_t prio)
+{
+    sim_cycles(SIM_DRIVERLIB_CYCLES);
+    if (interruptNumber < NUM_INTERRUPTS)
+        priority[interruptNumber] = prio;
+}
+
+uint8_t Interrupt_getPriority(uint32_t interruptNumber)
+{
+    sim_cycles(SIM_DRIVERLIB_CYCLES);
+    return (interruptNumber < NUM_INTERRUPTS) ? priority[interruptNumber] : 0;
+}
+
+/* Both return true if interrupts were disabled before the call */
+bool Interrupt_enableMaster(void)
+{
+    bool wasDisabled = sim_get_primask();
+
+    sim_cycles(SIM_DRIVERLIB_CYCLES);
+    sim_enable_irq();
+    return wasDisabled;
+}
+
+bool Interrupt_disableMaster(void)
+{
+    bool wasDisabled = sim_get_primask();
+
+    sim_disable_irq();
+    sim_cycles(SIM_DRIVERLIB_CYCLES);
+    return wasDisabled;
+}
+
+/*-------------------------------------------------------------------------
+ * SysTick
+ *-----------------------------------------------------------------------*/
+void SysTick_enableModule(void)
+{
+    SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk | 0x4;     /* core clock source */
+}
+
+void SysTick_disableModule(void)
+{
+    SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+}
+
+void SysTick_setPeriod(uint32_t period)
+{
+    SysTick->LOAD = (period - 1) & SysTick_LOAD_RELOAD_Msk;
+}
+
+uint32_t SysTick_getPeriod(void)
+{
+    return SysTick->LOAD + 1;
+}
+
+uint32_t SysTick_getValue(void)
+{
+    return SysTick->VAL;
+}
+
+void SysTick_enableInterrupt(void)
+{
+    SysTick->CTRL |= SysTick_CTRL_TICKINT_Msk;
+}
+
+void SysTick_disableInterrupt(void)
+{
+    SysTick->CTRL &= ~SysTick_CTRL_TICKINT_Msk;
+}
+
+/*-------------------------------------------------------------------------
+ * Clock system
+ *-----------------------------------------------------------------------*/
+uint32_t CS_getMCLK(void)
+{
+    sim_cycles(SIM_DRIVERLIB_CYCLES);
+    return sim_mclk_hz();
+}
+
+uint32_t CS_getHSMCLK(void)
+{
+    sim_cycles(SIM_DRIVERLIB_CYCLES);
+    return sim_hsmclk_hz();
+}
+
+uint32_t CS_getSMCLK(void)
+{
+    sim_cycles(SIM_DRIVERLIB_CYCLES);
+    return sim_smclk_hz();
+}
+
+/*-------------------------------------------------------------------------
+ * Watchdog.  In watchdog mode a time-out ends the run like a reset would,
+ * interval mode is not modelled.  The count restarts when the firmware
+ * sets CNTCL or releases HOLD.
+ *-----------------------------------------------------------------------*/
+static uint64_t sim_wdt_period(uint16_t ctl)
+{
+    static const unsigned shift[8] = { 31, 27, 23, 19, 15, 13, 9, 6 };
+    uint64_t hz;
+
+    switch (ctl & WDT_A_CTL_SSEL_MASK)
+    {
+    case WDT_A_CLOCKSOURCE_SMCLK:  hz = sim_smclk_hz(); break;
+    case WDT_A_CLOCKSOURCE_VLOCLK: hz = 9400; break;
+    default:                       hz = 32768; break;  /* ACLK from REFO, BCLK */
+    }
+
+    return ((SIM_TICK_HZ << shift[ctl & WDT_A_CTL_IS_MASK]) + hz - 1) / hz;
+}
+
+static void sim_wdt_step(void)
+{
+    uint16_t ctl = sim_wdt_a.CTL;
+    uint64_t expiry;
+
+    if (ctl & WDT_A_CTL_HOLD)
+    {
+        wdtRunning = false;
+        return;
+    }
+
+    if (!wdtRunning || (ctl & WDT_A_CTL_CNTCL))
+    {
+        wdtRunning = true;
+        wdtCleared = sim_now();
+        sim_wdt_a.CTL = ctl & ~WDT_A_CTL_CNTCL;
+    }
+
+    if (ctl & WDT_A_CTL_TMSEL)
+        sim_fault("WDT_A interval mode is not modelled");
+
+    expiry = wdtCleared + sim_wdt_period(ctl);
+    if (sim_now() >= expiry)
+        sim_device_reset((wdtResetType == WDT_A_HARD_RESET) ? "watchdog time-out, hard reset" :
+                         "watchdog time-out, soft reset (peripherals keep running)");
+
+    sim_schedule(expiry);
+}
+
+void WDT_A_holdTimer(void)
+{
+    WDT_A->CTL = WDT_A_CTL_PW | (WDT_A->CTL & 0xFF) | WDT_A_CTL_HOLD;
+}
+
+void WDT_A_startTimer(void)
+{
+    WDT_A->CTL = WDT_A_CTL_PW | (WDT_A->CTL & 0xFF & ~WDT_A_CTL_HOLD);
+}
+
+void WDT_A_clearTimer(void)
+{
+    WDT_A->CTL = WDT_A_CTL_PW | (WDT_A->CTL & 0xFF) | WDT_A_CTL_CNTCL;
+}
+
+void WDT_A_initWatchdogTimer(uint_fast8_t clockSelect, uint_fast8_t clockDivider)
+{
+    WDT_A->CTL = WDT_A_CTL_PW | WDT_A_CTL_CNTCL | WDT_A_CTL_HOLD |
+                 (clockSelect & WDT_A_CTL_SSEL_MASK) | (clockDivider & WDT_A_CTL_IS_MASK);
+}
+
+void WDT_A_setTimeoutReset(uint_fast8_t resetType)
+{
+    sim_cycles(SIM_DRIVERLIB_CYCLES);
+    wdtResetType = resetType;
+}
+
+/*-------------------------------------------------------------------------
+ * Reset controller.  The simulator does not boot the firmware a second
+ * time, so a reset ends the run and no reset source is ever set.
+ *-----------------------------------------------------------------------*/
+void ResetCtl_initiateHardReset(void)
+{
+    sim_cycles(SIM_DRIVERLIB_CYCLES);
+    sim_device_reset("firmware requested a hard reset");
+}
+
+uint32_t ResetCtl_getHardResetSource(void)
+{
+    sim_cycles(SIM_DRIVERLIB_CYCLES);
+    return 0;
+}
+
+void ResetCtl_clearHardResetSource(uint32_t mask)
+{
+    (void)mask;
+    sim_cycles(SIM_DRIVERLIB_CYCLES);
+}
+
+/*-------------------------------------------------------------------------
+ * System control
+ *-----------------------------------------------------------------------*/
+void SysCtl_enableSRAMBankRetention(uint_fast8_t sramBank)
+{
+    (void)sramBank;
+    sim_cycles(SIM_DRIVERLIB_CYCLES);
+}
+
+void SysCtl_rebootDevice(void)
+{
+    sim_device_reset("firmware requested a device reboot");
+}
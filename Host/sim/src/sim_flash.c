@@ -0,0 +1,98 @@
+/*
+ * sim_flash.c
+ *
+ * Flash controller DriverLib API.
+ *
+ * The firmware's "flash" on the host is whatever memory it points at,
+ * normally an array standing in for a reserved flash region.  Erase sets a
+ * 4 KB sector to 0xFF and programming can only clear bits, so writing a
+ * location twice without an erase fails the verify as it does on the part.
+ * Both take roughly the datasheet time in simulated cycles.
+ *
+ * A host pointer cannot be mapped to a bank and sector, so write protection
+ * is only checked as far as something having been unprotected at all.
+ */
+
+#include <string.h>
+#include "msp.h"
+#include "ti/devices/msp432p4xx/driverlib/driverlib.h"
+#include "sim.h"
+#include "sim_internal.h"
+
+#define SIM_FLASH_SECTOR_SIZE       4096
+#define SIM_FLASH_ERASE_CYCLES      (SIM_TICK_HZ / 100)     /* 10 ms per sector */
+#define SIM_FLASH_PROGRAM_CYCLES    (SIM_TICK_HZ / 50000)   /* 20 us per 128 bit word */
+
+static uint32_t unprotected[4];
+
+void sim_flash_reset(void)
+{
+    memset(unprotected, 0, sizeof(unprotected));
+}
+
+static bool sim_flash_writable(const char *what)
+{
+    if (unprotected[0] | unprotected[1] | unprotected[2] | unprotected[3])
+        return true;
+
+    sim_fault("%s with every flash sector write protected", what);
+    return false;
+}
+
+bool FlashCtl_protectSector(uint_fast8_t memorySpace, uint32_t sectorMask)
+{
+    sim_cycles(SIM_DRIVERLIB_CYCLES);
+    unprotected[(memorySpace - 1) & 0x3] &= ~sectorMask;
+    return true;
+}
+
+bool FlashCtl_unprotectSector(uint_fast8_t memorySpace, uint32_t sectorMask)
+{
+    sim_cycles(SIM_DRIVERLIB_CYCLES);
+    unprotected[(memorySpace - 1) & 0x3] |= sectorMask;
+    return true;
+}
+
+bool FlashCtl_eraseSector(uintptr_t addr)
+{
+    sim_cycles(SIM_DRIVERLIB_CYCLES);
+
+    if (!sim_flash_writable("FlashCtl_eraseSector()"))
+        return false;
+
+    if (addr & (SIM_FLASH_SECTOR_SIZE - 1))
+    {
+        sim_fault("FlashCtl_eraseSector(%p) is not on a sector boundary", (void *)addr);
+        return false;
+    }
+
+    memset((void *)addr, 0xFF, SIM_FLASH_SECTOR_SIZE);
+    sim_cycles(SIM_FLASH_ERASE_CYCLES);
+
+    return true;
+}
+
+bool FlashCtl_programMemory(void *src, void *dest, uint32_t length)
+{
+    const uint8_t *s = src;
+    uint8_t *d = dest;
+    bool ok = true;
+    uint32_t i;
+
+    sim_cycles(SIM_DRIVERLIB_CYCLES);
+
+    if (!sim_flash_writable("FlashCtl_programMemory()"))
+        return false;
+
+    /* Programming clears bits, the verify fails where a bit had to be set */
+    for (i = 0; i < length; i++)
+    {
+        d[i] &= s[i];
+        if (d[i] != s[i])
+            ok = false;
+    }
+
+    sim_cycles(SIM_FLASH_PROGRAM_CYCLES * ((length + 15) / 16));
+
+    return ok;
+}
@@ -0,0 +1,265 @@
+/*
+ * sim_gpio.c
+ *
+ * Digital I/O model and the GPIO DriverLib API.
+ *
+ * The level on each pin is worked out from the firmware's configuration and
+ * whatever the environment drives onto it: an output pin reads back OUT, an
+ * input pin reads the external drive, else its pull resistor, else 0.  Edges
+ * set IFG according to IES exactly as on the part, so the port interrupts
+ * fire from the same pin changes as on the robot.
+ */
+
+#include <string.h>
+#include "msp.h"
+#include "ti/devices/msp432p4xx/driverlib/driverlib.h"
+#include "sim.h"
+#include "sim_internal.h"
+
+static uint8_t extDriven[SIM_NUM_PORTS];
+static uint8_t extLevel[SIM_NUM_PORTS];
+static uint8_t lastIn[SIM_NUM_PORTS];
+static uint16_t touched;                    /* ports accessed since the last flush */
+
+static sim_gpio_model_t inputModel[SIM_NUM_PORTS];
+static void *inputModelCtx[SIM_NUM_PORTS];
+static bool inInputModel;
+
+void sim_gpio_reset(void)
+{
+    memset(extDriven, 0, sizeof(extDriven));
+    memset(extLevel, 0, sizeof(extLevel));
+    memset(lastIn, 0, sizeof(lastIn));
+    memset(inputModel, 0, sizeof(inputModel));
+    touched = 0;
+}
+
+void sim_gpio_attach_model(unsigned port, sim_gpio_model_t model, void *ctx)
+{
+    inputModel[port] = model;
+    inputModelCtx[port] = ctx;
+}
+
+/* The firmware writes a port register after the accessor returns */
+void sim_gpio_touch(unsigned port)
+{
+    touched |= 1u << port;
+}
+
+/* Pick up register writes made since the last access, before time moves on */
+void sim_gpio_flush(void)
+{
+    unsigned port;
+
+    for (port = 1; touched && (port < SIM_NUM_PORTS); port++)
+    {
+        if (touched & (1u << port))
+        {
+            touched &= ~(1u << port);
+            sim_gpio_sync(port);
+        }
+    }
+}
+
+/* Recompute IN for a port and latch interrupt flags on edges */
+void sim_gpio_sync(unsigned port)
+{
+    DIO_PORT_Type *p = &sim_port[port];
+    uint8_t dir = p->DIR;
+    uint8_t in, rising, falling;
+
+    /* Let the environment update the pins it drives for this instant */
+    if (inputModel[port] && !inInputModel)
+    {
+        inInputModel = true;
+        inputModel[port](inputModelCtx[port], port);
+        inInputModel = false;
+    }
+
+    in = (dir & p->OUT) |
+         (~dir & extDriven[port] & extLevel[port]) |
+         (~dir & ~extDriven[port] & p->REN & p->OUT);
+
+    rising = in & ~lastIn[port];
+    falling = ~in & lastIn[port];
+    p->IFG |= (rising & ~p->IES) | (falling & p->IES);
+
+    lastIn[port] = in;
+    p->IN = in;
+}
+
+void sim_gpio_drive(unsigned port, uint8_t pins, uint8_t levels)
+{
+    extDriven[port] |= pins;
+    extLevel[port] = (extLevel[port] & ~pins) | (levels & pins);
+    sim_gpio_sync(port);
+}
+
+void sim_gpio_release(unsigned port, uint8_t pins)
+{
+    extDriven[port] &= ~pins;
+    sim_gpio_sync(port);
+}
+
+uint8_t sim_gpio_output(unsigned port)
+{
+    return sim_port[port].OUT & sim_port[port].DIR;
+}
+
+uint8_t sim_gpio_dir(unsigned port)
+{
+    return sim_port[port].DIR;
+}
+
+bool sim_gpio_irq_pending(unsigned port)
+{
+    return (sim_port[port].IFG & sim_port[port].IE) != 0;
+}
+
+/*-------------------------------------------------------------------------
+ * DriverLib
+ *-----------------------------------------------------------------------*/
+static DIO_PORT_Type *sim_gpio_call(uint_fast8_t selectedPort)
+{
+    sim_cycles(SIM_DRIVERLIB_CYCLES);
+    return &sim_port[selectedPort];
+}
+
+void GPIO_setAsOutputPin(uint_fast8_t selectedPort, uint_fast16_t selectedPins)
+{
+    DIO_PORT_Type *p = sim_gpio_call(selectedPort);
+
+    p->SEL0 &= ~selectedPins;
+    p->SEL1 &= ~selectedPins;
+    p->DIR |= selectedPins;
+    sim_gpio_sync(selectedPort);
+}
+
+void GPIO_setOutputHighOnPin(uint_fast8_t selectedPort, uint_fast16_t selectedPins)
+{
+    sim_gpio_call(selectedPort)->OUT |= selectedPins;
+    sim_gpio_sync(selectedPort);
+}
+
+void GPIO_setOutputLowOnPin(uint_fast8_t selectedPort, uint_fast16_t selectedPins)
+{
+    sim_gpio_call(selectedPort)->OUT &= ~selectedPins;
+    sim_gpio_sync(selectedPort);
+}
+
+void GPIO_toggleOutputOnPin(uint_fast8_t selectedPort, uint_fast16_t selectedPins)
+{
+    sim_gpio_call(selectedPort)->OUT ^= selectedPins;
+    sim_gpio_sync(selectedPort);
+}
+
+void GPIO_setAsInputPin(uint_fast8_t selectedPort, uint_fast16_t selectedPins)
+{
+    DIO_PORT_Type *p = sim_gpio_call(selectedPort);
+
+    p->SEL0 &= ~selectedPins;
+    p->SEL1 &= ~selectedPins;
+    p->DIR &= ~selectedPins;
+    p->REN &= ~selectedPins;
+    sim_gpio_sync(selectedPort);
+}
+
+void GPIO_setAsInputPinWithPullUpResistor(uint_fast8_t selectedPort, uint_fast16_t selectedPins)
+{
+    DIO_PORT_Type *p = sim_gpio_call(selectedPort);
+
+    p->SEL0 &= ~selectedPins;
+    p->SEL1 &= ~selectedPins;
+    p->DIR &= ~selectedPins;
+    p->REN |= selectedPins;
+    p->OUT |= selectedPins;
+    sim_gpio_sync(selectedPort);
+}
+
+void GPIO_setAsInputPinWithPullDownResistor(uint_fast8_t selectedPort, uint_fast16_t selectedPins)
+{
+    DIO_PORT_Type *p = sim_gpio_call(selectedPort);
+
+    p->SEL0 &= ~selectedPins;
+    p->SEL1 &= ~selectedPins;
+    p->DIR &= ~selectedPins;
+    p->REN |= selectedPins;
+    p->OUT &= ~selectedPins;
+    sim_gpio_sync(selectedPort);
+}
+
+static void sim_gpio_select(DIO_PORT_Type *p, uint_fast16_t selectedPins, uint_fast8_t mode)
+{
+    if (mode & GPIO_PRIMARY_MODULE_FUNCTION)
+        p->SEL0 |= selectedPins;
+    else
+        p->SEL0 &= ~selectedPins;
+
+    if (mode & GPIO_SECONDARY_MODULE_FUNCTION)
+        p->SEL1 |= selectedPins;
+    else
+        p->SEL1 &= ~selectedPins;
+}
+
+void GPIO_setAsPeripheralModuleFunctionOutputPin(uint_fast8_t selectedPort, uint_fast16_t selectedPins, uint_fast8_t mode)
+{
+    DIO_PORT_Type *p = sim_gpio_call(selectedPort);
+
+    p->DIR |= selectedPins;
+    sim_gpio_select(p, selectedPins, mode);
+    sim_gpio_sync(selectedPort);
+}
+
+void GPIO_setAsPeripheralModuleFunctionInputPin(uint_fast8_t selectedPort, uint_fast16_t selectedPins, uint_fast8_t mode)
+{
+    DIO_PORT_Type *p = sim_gpio_call(selectedPort);
+
+    p->DIR &= ~selectedPins;
+    sim_gpio_select(p, selectedPins, mode);
+    sim_gpio_sync(selectedPort);
+}
+
+uint8_t GPIO_getInputPinValue(uint_fast8_t selectedPort, uint_fast16_t selectedPins)
+{
+    sim_gpio_call(selectedPort);
+    sim_gpio_sync(selectedPort);
+
+    return (sim_port[selectedPort].IN & selectedPins) ? GPIO_INPUT_PIN_HIGH : GPIO_INPUT_PIN_LOW;
+}
+
+void GPIO_interruptEdgeSelect(uint_fast8_t selectedPort, uint_fast16_t selectedPins, uint_fast8_t edgeSelect)
+{
+    DIO_PORT_Type *p = sim_gpio_call(selectedPort);
+
+    if (edgeSelect == GPIO_HIGH_TO_LOW_TRANSITION)
+        p->IES |= selectedPins;
+    else
+        p->IES &= ~selectedPins;
+}
+
+void GPIO_enableInterrupt(uint_fast8_t selectedPort, uint_fast16_t selectedPins)
+{
+    sim_gpio_call(selectedPort)->IE |= selectedPins;
+}
+
+void GPIO_disableInterrupt(uint_fast8_t selectedPort, uint_fast16_t selectedPins)
+{
+    sim_gpio_call(selectedPort)->IE &= ~selectedPins;
+}
+
+void GPIO_clearInterruptFlag(uint_fast8_t selectedPort, uint_fast16_t selectedPins)
+{
+    sim_gpio_call(selectedPort)->IFG &= ~selectedPins;
+}
+
+uint_fast16_t GPIO_getInterruptStatus(uint_fast8_t selectedPort, uint_fast16_t selectedPins)
+{
+    return sim_gpio_call(selectedPort)->IFG & selectedPins;
+}
+
+uint_fast16_t GPIO_getEnabledInterruptStatus(uint_fast8_t selectedPort)
+{
+    DIO_PORT_Type *p = sim_gpio_call(selectedPort);
+
+    return p->IFG & p->IE;
+}
@@ -0,0 +1,488 @@
+/*
+ * sim_i2c.c
+ *
+ * eUSCI_B I2C master model and DriverLib API.
+ *
+ * The bus is modelled a byte at a time.  Each phase (address, data byte,
+ * STOP) takes its real time on the wire at SCL = SMCLK / UCBRW, and the
+ * interrupt flags move the way the eUSCI sets them: TXIFG when TXBUF can
+ * take the next byte, RXIFG when a byte has arrived, NACKIFG when the
+ * address is not acknowledged and STPIFG once the STOP is on the bus.  The
+ * master holds SCL low (clock stretching) while it waits for the firmware.
+ */
+
+#include <stddef.h>
+#include <string.h>
+#include "msp.h"
+#include "ti/devices/msp432p4xx/driverlib/driverlib.h"
+#include "sim.h"
+#include "sim_internal.h"
+
+#define SIM_I2C_MAX_SLAVES  4
+
+typedef enum
+{
+    BUS_IDLE,
+    BUS_ADDR,           /* START + address + ACK */
+    BUS_TX_BYTE,        /* data byte to the slave */
+    BUS_TX_HOLD,        /* SCL held, waiting for TXBUF, STOP or repeated START */
+    BUS_RX_BYTE,        /* data byte from the slave */
+    BUS_RX_HOLD,        /* SCL held, RXBUF still full */
+    BUS_NACKED,         /* address not acknowledged, waiting for STOP */
+    BUS_STOP
+} sim_bus_phase_t;
+
+typedef struct
+{
+    sim_bus_phase_t phase;
+    uint64_t eventTime;
+    bool read;
+    bool txFull;
+    bool rxFull;
+    uint8_t txShift;
+    uint8_t rxPending;
+    const sim_i2c_slave_t *active;
+    sim_i2c_slave_t slaves[SIM_I2C_MAX_SLAVES];
+    unsigned numSlaves;
+} sim_i2c_t;
+
+static sim_i2c_t bus[4];
+
+static unsigned sim_i2c_index(uint32_t moduleInstance)
+{
+    return ((moduleInstance - EUSCI_B0_BASE) >> 10) & 0x3;
+}
+
+void sim_i2c_reset(void)
+{
+    memset(bus, 0, sizeof(bus));
+}
+
+void sim_i2c_attach(unsigned module, const sim_i2c_slave_t *slave)
+{
+    if (bus[module].numSlaves < SIM_I2C_MAX_SLAVES)
+        bus[module].slaves[bus[module].numSlaves++] = *slave;
+}
+
+uint32_t sim_i2c_bit_rate(unsigned module)
+{
+    uint16_t brw = sim_eusci_b[module].BRW;
+
+    return sim_smclk_hz() / (brw ? brw : 1);
+}
+
+bool sim_i2c_irq_pending(unsigned module)
+{
+    EUSCI_B_Type *r = &sim_eusci_b[module];
+
+    return !(r->CTLW0 & EUSCI_B_CTLW0_SWRST) && (r->IFG & r->IE);
+}
+
+static void sim_i2c_after_bits(unsigned m, unsigned bits)
+{
+    bus[m].eventTime = sim_now() + (uint64_t)bits * SIM_TICK_HZ / sim_i2c_bit_rate(m);
+    sim_schedule(bus[m].eventTime);
+}
+
+static void sim_i2c_start_address(unsigned m)
+{
+    EUSCI_B_Type *r = &sim_eusci_b[m];
+
+    bus[m].phase = BUS_ADDR;
+    bus[m].read = !(r->CTLW0 & EUSCI_B_CTLW0_TR);
+    r->STATW |= EUSCI_B_STATW_BBUSY;
+
+    /* In transmit mode TXBUF is requested as soon as START goes out */
+    if (!bus[m].read && !bus[m].txFull)
+        r->IFG |= EUSCI_B_IFG_TXIFG0;
+
+    sim_i2c_after_bits(m, 10);
+}
+
+static void sim_i2c_start_tx_byte(unsigned m)
+{
+    bus[m].txShift = (uint8_t)sim_eusci_b[m].TXBUF;
+    bus[m].txFull = false;
+    sim_eusci_b[m].IFG |= EUSCI_B_IFG_TXIFG0;
+    bus[m].phase = BUS_TX_BYTE;
+    sim_i2c_after_bits(m, 9);
+}
+
+static void sim_i2c_start_rx_byte(unsigned m)
+{
+    bus[m].phase = BUS_RX_BYTE;
+    sim_i2c_after_bits(m, 9);
+}
+
+static void sim_i2c_start_stop(unsigned m)
+{
+    bus[m].phase = BUS_STOP;
+    sim_i2c_after_bits(m, 1);
+}
+
+static void sim_i2c_deliver(unsigned m, uint8_t data)
+{
+    sim_eusci_b[m].RXBUF = data;
+    sim_eusci_b[m].IFG |= EUSCI_B_IFG_RXIFG0;
+    bus[m].rxFull = true;
+}
+
+/* Move on from a held bus once the firmware has done its part */
+static void sim_i2c_kick(unsigned m)
+{
+    EUSCI_B_Type *r = &sim_eusci_b[m];
+
+    if (r->CTLW0 & EUSCI_B_CTLW0_SWRST)
+        return;
+
+    switch (bus[m].phase)
+    {
+    case BUS_IDLE:
+        if (r->CTLW0 & EUSCI_B_CTLW0_TXSTT)
+            sim_i2c_start_address(m);
+        break;
+
+    case BUS_TX_HOLD:
+    case BUS_NACKED:
+        if (r->CTLW0 & EUSCI_B_CTLW0_TXSTP)
+            sim_i2c_start_stop(m);
+        else if (r->CTLW0 & EUSCI_B_CTLW0_TXSTT)
+            sim_i2c_start_address(m);
+        else if ((bus[m].phase == BUS_TX_HOLD) && bus[m].txFull)
+            sim_i2c_start_tx_byte(m);
+        break;
+
+    case BUS_RX_HOLD:
+        if (!bus[m].rxFull)
+        {
+            sim_i2c_deliver(m, bus[m].rxPending);
+            if (r->CTLW0 & EUSCI_B_CTLW0_TXSTP)
+                sim_i2c_start_stop(m);
+            else
+                sim_i2c_start_rx_byte(m);
+        }
+        break;
+
+    default:
+        break;
+    }
+}
+
+static void sim_i2c_end_phase(unsigned m)
+{
+    EUSCI_B_Type *r = &sim_eusci_b[m];
+    const sim_i2c_slave_t *s = NULL;
+    uint8_t data;
+    unsigned i;
+
+    switch (bus[m].phase)
+    {
+    case BUS_ADDR:
+        r->CTLW0 &= ~EUSCI_B_CTLW0_TXSTT;
+
+        for (i = 0; i < bus[m].numSlaves; i++)
+        {
+            if (bus[m].slaves[i].address == (r->I2CSA & 0x7F))
+                s = &bus[m].slaves[i];
+        }
+
+        if ((s == NULL) || !s->start(s->ctx, bus[m].read))
+        {
+            r->IFG |= EUSCI_B_IFG_NACKIFG;
+            bus[m].txFull = false;
+            bus[m].active = NULL;
+            bus[m].phase = BUS_NACKED;
+        }
+        else
+        {
+            bus[m].active = s;
+            if (bus[m].read)
+                sim_i2c_start_rx_byte(m);
+            else
+                bus[m].phase = BUS_TX_HOLD;
+        }
+        break;
+
+    case BUS_TX_BYTE:
+        bus[m].active->write(bus[m].active->ctx, bus[m].txShift);
+        bus[m].phase = BUS_TX_HOLD;
+        break;
+
+    case BUS_RX_BYTE:
+        data = bus[m].active->read(bus[m].active->ctx);
+        if (bus[m].rxFull)
+        {
+            bus[m].rxPending = data;
+            bus[m].phase = BUS_RX_HOLD;
+        }
+        else
+        {
+            sim_i2c_deliver(m, data);
+            if (r->CTLW0 & EUSCI_B_CTLW0_TXSTP)
+                sim_i2c_start_stop(m);
+            else
+                sim_i2c_start_rx_byte(m);
+        }
+        return;
+
+    case BUS_STOP:
+        r->CTLW0 &= ~EUSCI_B_CTLW0_TXSTP;
+        r->STATW &= ~EUSCI_B_STATW_BBUSY;
+        r->IFG |= EUSCI_B_IFG_STPIFG;
+        if (bus[m].active)
+            bus[m].active->stop(bus[m].active->ctx);
+        bus[m].active = NULL;
+        bus[m].phase = BUS_IDLE;
+        break;
+
+    default:
+        return;
+    }
+
+    sim_i2c_kick(m);
+}
+
+void sim_i2c_step(void)
+{
+    unsigned m;
+
+    for (m = 0; m < 4; m++)
+    {
+        while (((bus[m].phase == BUS_ADDR) || (bus[m].phase == BUS_TX_BYTE) ||
+                (bus[m].phase == BUS_RX_BYTE) || (bus[m].phase == BUS_STOP)) &&
+               (bus[m].eventTime <= sim_now()))
+        {
+            sim_i2c_end_phase(m);
+        }
+
+        if ((bus[m].phase == BUS_ADDR) || (bus[m].phase == BUS_TX_BYTE) ||
+            (bus[m].phase == BUS_RX_BYTE) || (bus[m].phase == BUS_STOP))
+        {
+            sim_schedule(bus[m].eventTime);
+        }
+    }
+}
+
+/*-------------------------------------------------------------------------
+ * DriverLib
+ *-----------------------------------------------------------------------*/
+static unsigned sim_i2c_call(uint32_t moduleInstance)
+{
+    sim_cycles(SIM_DRIVERLIB_CYCLES);
+    return sim_i2c_index(moduleInstance);
+}
+
+/* DriverLib busy-waits on TXIFG when the TX interrupt is not enabled */
+static void sim_i2c_poll_tx(unsigned m)
+{
+    EUSCI_B_Type *r = &sim_eusci_b[m];
+
+    if (r->IE & EUSCI_B_IFG_TXIFG0)
+        return;
+
+    while (!(r->IFG & EUSCI_B_IFG_TXIFG0))
+        sim_cycles(4);
+}
+
+static void sim_i2c_write_txbuf(unsigned m, uint8_t txData)
+{
+    sim_eusci_b[m].TXBUF = txData;
+    sim_eusci_b[m].IFG &= ~EUSCI_B_IFG_TXIFG0;
+    bus[m].txFull = true;
+    sim_i2c_kick(m);
+}
+
+static void sim_i2c_set_ctlw0(unsigned m, uint16_t bits)
+{
+    sim_eusci_b[m].CTLW0 |= bits;
+    sim_i2c_kick(m);
+}
+
+void I2C_initMaster(uint32_t moduleInstance, const eUSCI_I2C_MasterConfig *config)
+{
+    unsigned m = sim_i2c_call(moduleInstance);
+    EUSCI_B_Type *r = &sim_eusci_b[m];
+
+    I2C_disableModule(moduleInstance);
+
+    r->CTLW0 = EUSCI_B_CTLW0_SWRST | config->selectClockSource;
+    r->CTLW1 = config->autoSTOPGeneration;
+    r->TBCNT = config->byteCounterThreshold;
+    r->BRW = (uint16_t)(config->i2cClk / config->dataRate);
+}
+
+void I2C_enableModule(uint32_t moduleInstance)
+{
+    unsigned m = sim_i2c_call(moduleInstance);
+
+    sim_eusci_b[m].CTLW0 &= ~EUSCI_B_CTLW0_SWRST;
+}
+
+void I2C_disableModule(uint32_t moduleInstance)
+{
+    unsigned m = sim_i2c_call(moduleInstance);
+    EUSCI_B_Type *r = &sim_eusci_b[m];
+
+    /* Software reset abandons the transfer and releases the bus */
+    if (bus[m].active)
+        bus[m].active->stop(bus[m].active->ctx);
+
+    bus[m].active = NULL;
+    bus[m].phase = BUS_IDLE;
+    bus[m].txFull = false;
+    bus[m].rxFull = false;
+
+    r->CTLW0 = (r->CTLW0 | EUSCI_B_CTLW0_SWRST) & ~(EUSCI_B_CTLW0_TXSTT | EUSCI_B_CTLW0_TXSTP);
+    r->STATW &= ~EUSCI_B_STATW_BBUSY;
+    r->IFG = 0;
+}
+
+void I2C_setSlaveAddress(uint32_t moduleInstance, uint_fast16_t slaveAddress)
+{
+    sim_eusci_b[sim_i2c_call(moduleInstance)].I2CSA = slaveAddress;
+}
+
+void I2C_setMode(uint32_t moduleInstance, uint_fast8_t mode)
+{
+    unsigned m = sim_i2c_call(moduleInstance);
+
+    sim_eusci_b[m].CTLW0 = (sim_eusci_b[m].CTLW0 & ~EUSCI_B_CTLW0_TR) | (mode & EUSCI_B_CTLW0_TR);
+}
+
+uint_fast8_t I2C_getMode(uint32_t moduleInstance)
+{
+    return sim_eusci_b[sim_i2c_call(moduleInstance)].CTLW0 & EUSCI_B_CTLW0_TR;
+}
+
+uint_fast16_t I2C_isBusBusy(uint32_t moduleInstance)
+{
+    return sim_eusci_b[sim_i2c_call(moduleInstance)].STATW & EUSCI_B_STATW_BBUSY;
+}
+
+void I2C_masterSendStart(uint32_t moduleInstance)
+{
+    sim_i2c_set_ctlw0(sim_i2c_call(moduleInstance), EUSCI_B_CTLW0_TXSTT);
+}
+
+void I2C_masterSendMultiByteStart(uint32_t moduleInstance, uint8_t txData)
+{
+    unsigned m = sim_i2c_call(moduleInstance);
+
+    sim_i2c_set_ctlw0(m, EUSCI_B_CTLW0_TR | EUSCI_B_CTLW0_TXSTT);
+    sim_i2c_poll_tx(m);
+    sim_i2c_write_txbuf(m, txData);
+}
+
+void I2C_masterSendMultiByteNext(uint32_t moduleInstance, uint8_t txData)
+{
+    unsigned m = sim_i2c_call(moduleInstance);
+
+    sim_i2c_poll_tx(m);
+    sim_i2c_write_txbuf(m, txData);
+}
+
+void I2C_masterSendMultiByteFinish(uint32_t moduleInstance, uint8_t txData)
+{
+    unsigned m = sim_i2c_call(moduleInstance);
+
+    sim_i2c_poll_tx(m);
+    sim_i2c_write_txbuf(m, txData);
+    sim_i2c_poll_tx(m);
+    sim_i2c_set_ctlw0(m, EUSCI_B_CTLW0_TXSTP);
+}
+
+void I2C_masterSendSingleByte(uint32_t moduleInstance, uint8_t txData)
+{
+    I2C_masterSendMultiByteStart(moduleInstance, txData);
+    sim_i2c_poll_tx(sim_i2c_index(moduleInstance));
+    sim_i2c_set_ctlw0(sim_i2c_index(moduleInstance), EUSCI_B_CTLW0_TXSTP);
+}
+
+void I2C_masterSendMultiByteStop(uint32_t moduleInstance)
+{
+    unsigned m = sim_i2c_call(moduleInstance);
+
+    sim_i2c_poll_tx(m);
+    sim_i2c_set_ctlw0(m, EUSCI_B_CTLW0_TXSTP);
+}
+
+void I2C_masterReceiveStart(uint32_t moduleInstance)
+{
+    unsigned m = sim_i2c_call(moduleInstance);
+
+    sim_eusci_b[m].CTLW0 &= ~EUSCI_B_CTLW0_TR;
+    sim_i2c_set_ctlw0(m, EUSCI_B_CTLW0_TXSTT);
+}
+
+uint8_t I2C_masterReceiveMultiByteNext(uint32_t moduleInstance)
+{
+    unsigned m = sim_i2c_call(moduleInstance);
+    uint8_t data = (uint8_t)sim_eusci_b[m].RXBUF;
+
+    sim_eusci_b[m].IFG &= ~EUSCI_B_IFG_RXIFG0;
+    bus[m].rxFull = false;
+    sim_i2c_kick(m);
+
+    return data;
+}
+
+uint8_t I2C_masterReceiveMultiByteFinish(uint32_t moduleInstance)
+{
+    unsigned m = sim_i2c_call(moduleInstance);
+
+    sim_i2c_set_ctlw0(m, EUSCI_B_CTLW0_TXSTP);
+    while (sim_eusci_b[m].CTLW0 & EUSCI_B_CTLW0_TXSTP)
+        sim_cycles(4);
+
+    while (!(sim_eusci_b[m].IFG & EUSCI_B_IFG_RXIFG0))
+        sim_cycles(4);
+
+    return I2C_masterReceiveMultiByteNext(moduleInstance);
+}
+
+void I2C_masterReceiveMultiByteStop(uint32_t moduleInstance)
+{
+    sim_i2c_set_ctlw0(sim_i2c_call(moduleInstance), EUSCI_B_CTLW0_TXSTP);
+}
+
+uint8_t I2C_masterReceiveSingle(uint32_t moduleInstance)
+{
+    unsigned m = sim_i2c_call(moduleInstance);
+
+    while (!(sim_eusci_b[m].IFG & EUSCI_B_IFG_RXIFG0))
+        sim_cycles(4);
+
+    return I2C_masterReceiveMultiByteNext(moduleInstance);
+}
+
+uint_fast8_t I2C_masterIsStopSent(uint32_t moduleInstance)
+{
+    return (sim_eusci_b[sim_i2c_call(moduleInstance)].CTLW0 & EUSCI_B_CTLW0_TXSTP) ? 1 : 0;
+}
+
+void I2C_enableInterrupt(uint32_t moduleInstance, uint_fast16_t mask)
+{
+    sim_eusci_b[sim_i2c_call(moduleInstance)].IE |= mask;
+}
+
+void I2C_disableInterrupt(uint32_t moduleInstance, uint_fast16_t mask)
+{
+    sim_eusci_b[sim_i2c_call(moduleInstance)].IE &= ~mask;
+}
+
+void I2C_clearInterruptFlag(uint32_t moduleInstance, uint_fast16_t mask)
+{
+    sim_eusci_b[sim_i2c_call(moduleInstance)].IFG &= ~mask;
+}
+
+uint_fast16_t I2C_getInterruptStatus(uint32_t moduleInstance, uint16_t mask)
+{
+    return sim_eusci_b[sim_i2c_call(moduleInstance)].IFG & mask;
+}
+
+uint_fast16_t I2C_getEnabledInterruptStatus(uint32_t moduleInstance)
+{
+    unsigned m = sim_i2c_call(moduleInstance);
+
+    return sim_eusci_b[m].IFG & sim_eusci_b[m].IE;
+}
@@ -0,0 +1,37 @@
+/*
+ * sim_internal.h
+ *
+ * Interfaces between the simulator modules, not for use by environments.
+ */
+#ifndef SIM_INTERNAL_H_
+#define SIM_INTERNAL_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sim.h"
+
+/* DriverLib calls cost roughly what the ROM routines take on target */
+#define SIM_DRIVERLIB_CYCLES    20
+
+sim_isr_t sim_vector(uint32_t interruptNumber);
+
+void sim_gpio_reset(void);
+void sim_gpio_touch(unsigned port);
+void sim_gpio_flush(void);
+void sim_i2c_reset(void);
+
+void sim_uart_reset(void);
+void sim_uart_write(unsigned module, uint8_t data);
+bool sim_uart_is_txbuf(uint32_t address, unsigned *module);
+
+void sim_dma_reset(void);
+void sim_dma_request(uint32_t mapping);
+
+void sim_flash_reset(void);
+
+/* Peripherals without a model of their own (sim_driverlib.c) */
+void sim_peripheral_reset(void);
+void sim_peripheral_step(void);
+bool sim_peripheral_irq_pending(uint32_t interruptNumber);
+
+#endif /* SIM_INTERNAL_H_ */
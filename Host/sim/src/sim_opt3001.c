@@ -0,0 +1,321 @@
+/*
+ * sim_opt3001.c
+ *
+ * OPT3001 ambient light sensor on eUSCI_B1 (address 0x47) with its INT
+ * output on P4.1 (J1.5), where the robot wires it: J2.11 is the right motor
+ * driver's nSLP on the RSLK.
+ *
+ * Register access follows the datasheet: the first byte of a write selects
+ * the register pointer, the next two bytes are written MSB first; a read
+ * returns the register at the pointer MSB first.  Conversions run for 100
+ * or 800 ms in single-shot or continuous mode, the result is encoded with
+ * automatic or fixed full-scale range and compared against the limit
+ * registers.  Reading the configuration register clears CRF, FH and FL and
+ * releases a latched INT.
+ */
+
+#include <string.h>
+#include "sim.h"
+#include "sim_internal.h"
+
+#define OPT_ADDRESS     0x47
+#define OPT_I2C_MODULE  1
+#define OPT_INT_PORT    4
+#define OPT_INT_PIN     0x02
+
+#define REG_RESULT      0x00
+#define REG_CONFIG      0x01
+#define REG_LOW_LIMIT   0x02
+#define REG_HIGH_LIMIT  0x03
+#define REG_MANUFACTURER 0x7E
+#define REG_DEVICE      0x7F
+
+#define CFG_RN          0xF000
+#define CFG_CT          0x0800
+#define CFG_M           0x0600
+#define CFG_M_SINGLE    0x0200
+#define CFG_OVF         0x0100
+#define CFG_CRF         0x0080
+#define CFG_FH          0x0040
+#define CFG_FL          0x0020
+#define CFG_L           0x0010
+#define CFG_POL         0x0008
+#define CFG_FC          0x0003
+#define CFG_WRITABLE    (CFG_RN | CFG_CT | CFG_M | CFG_L | CFG_POL | 0x0004 | CFG_FC)
+
+typedef struct
+{
+    bool present;
+    double lux;
+
+    uint16_t result, config, lowLimit, highLimit;
+    uint8_t pointer;
+    unsigned byteCount;         /* bytes moved since the START */
+    bool reading;
+    uint16_t readValue;
+    uint16_t writeValue;
+
+    unsigned msLeft;            /* of the conversion in progress, 0 if idle */
+    unsigned highCount, lowCount;
+    bool intActive;
+    uint32_t transfers;
+} sim_opt3001_t;
+
+static sim_opt3001_t opt;
+
+static uint32_t opt_centi_lux(uint16_t reg)
+{
+    return (uint32_t)(reg & 0x0FFF) << (reg >> 12);
+}
+
+static void opt_drive_int(void)
+{
+    bool level = (opt.config & CFG_POL) ? opt.intActive : !opt.intActive;
+
+    sim_gpio_drive(OPT_INT_PORT, OPT_INT_PIN, level ? OPT_INT_PIN : 0);
+}
+
+static uint16_t opt_encode(void)
+{
+    double centi = opt.lux * 100.0;
+    uint32_t mantissa;
+    unsigned e;
+
+    if (centi < 0)
+        centi = 0;
+
+    if ((opt.config & CFG_RN) == 0xC000)
+    {
+        for (e = 0; e < 11; e++)
+        {
+            if (centi / (1u << e) < 4095.5)
+                break;
+        }
+    }
+    else
+    {
+        e = (opt.config & CFG_RN) >> 12;
+    }
+
+    mantissa = (uint32_t)(centi / (1u << e) + 0.5);
+    opt.config &= ~CFG_OVF;
+    if (mantissa > 0x0FFF)
+    {
+        mantissa = 0x0FFF;
+        opt.config |= CFG_OVF;
+    }
+
+    return (uint16_t)((e << 12) | mantissa);
+}
+
+static void opt_start_conversion(void)
+{
+    opt.msLeft = (opt.config & CFG_CT) ? 800 : 100;
+}
+
+static void opt_compare(void)
+{
+    static const unsigned faults[4] = { 1, 2, 4, 8 };
+    unsigned needed = faults[opt.config & CFG_FC];
+    uint32_t value = opt_centi_lux(opt.result);
+
+    /* Low limit exponent 1100b selects end-of-conversion mode */
+    if ((opt.lowLimit & 0xF000) == 0xC000)
+    {
+        opt.intActive = true;
+        return;
+    }
+
+    opt.highCount = (value > opt_centi_lux(opt.highLimit)) ? opt.highCount + 1 : 0;
+    opt.lowCount = (value < opt_centi_lux(opt.lowLimit)) ? opt.lowCount + 1 : 0;
+
+    if (opt.highCount >= needed)
+        opt.config |= CFG_FH;
+    if (opt.lowCount >= needed)
+        opt.config |= CFG_FL;
+
+    if (opt.config & CFG_L)
+    {
+        if ((opt.highCount >= needed) || (opt.lowCount >= needed))
+            opt.intActive = true;
+    }
+    else
+    {
+        /* Transparent hysteresis: INT reports which side of the window the light is on */
+        if (opt.highCount >= needed)
+            opt.intActive = true;
+        else if (opt.lowCount >= needed)
+            opt.intActive = false;
+    }
+}
+
+static void opt_tick(void *ctx)
+{
+    (void)ctx;
+
+    if (!opt.present || (opt.msLeft == 0) || (--opt.msLeft != 0))
+        return;
+
+    opt.result = opt_encode();
+    opt.config |= CFG_CRF;
+    opt_compare();
+    opt_drive_int();
+
+    if ((opt.config & CFG_M) == CFG_M_SINGLE)
+        opt.config &= ~CFG_M;
+    else if (opt.config & CFG_M)
+        opt_start_conversion();
+}
+
+static uint16_t *opt_register(uint8_t pointer)
+{
+    switch (pointer)
+    {
+    case REG_RESULT:     return &opt.result;
+    case REG_CONFIG:     return &opt.config;
+    case REG_LOW_LIMIT:  return &opt.lowLimit;
+    case REG_HIGH_LIMIT: return &opt.highLimit;
+    default:             return NULL;
+    }
+}
+
+static void opt_write_register(uint8_t pointer, uint16_t value)
+{
+    uint16_t old = opt.config;
+
+    switch (pointer)
+    {
+    case REG_CONFIG:
+        opt.config = (old & ~CFG_WRITABLE) | (value & CFG_WRITABLE);
+        if (!(old & CFG_M) && (opt.config & CFG_M))
+            opt_start_conversion();
+        else if (!(opt.config & CFG_M))
+            opt.msLeft = 0;
+        if (!(opt.config & CFG_L) || ((old ^ opt.config) & CFG_POL))
+            opt_drive_int();
+        break;
+
+    case REG_LOW_LIMIT:
+        opt.lowLimit = value;
+        break;
+
+    case REG_HIGH_LIMIT:
+        opt.highLimit = value;
+        break;
+
+    default:
+        break;
+    }
+}
+
+static uint16_t opt_read_register(uint8_t pointer)
+{
+    uint16_t *reg = opt_register(pointer);
+    uint16_t value;
+
+    if (pointer == REG_MANUFACTURER)
+        return 0x5449;
+    if (pointer == REG_DEVICE)
+        return 0x3001;
+    if (reg == NULL)
+        return 0;
+
+    value = *reg;
+
+    if (pointer == REG_CONFIG)
+    {
+        opt.config &= ~(CFG_CRF | CFG_FH | CFG_FL);
+        if ((opt.config & CFG_L) || ((opt.lowLimit & 0xF000) == 0xC000))
+        {
+            opt.intActive = false;
+            opt_drive_int();
+        }
+    }
+
+    return value;
+}
+
+/*-------------------------------------------------------------------------
+ * I2C slave
+ *-----------------------------------------------------------------------*/
+static bool opt_start(void *ctx, bool read)
+{
+    (void)ctx;
+
+    if (!opt.present)
+        return false;
+
+    opt.reading = read;
+    opt.byteCount = 0;
+    return true;
+}
+
+static void opt_write(void *ctx, uint8_t data)
+{
+    (void)ctx;
+
+    if (opt.byteCount == 0)
+        opt.pointer = data;
+    else if (opt.byteCount == 1)
+        opt.writeValue = (uint16_t)data << 8;
+    else if (opt.byteCount == 2)
+        opt_write_register(opt.pointer, opt.writeValue | data);
+
+    opt.byteCount++;
+}
+
+static uint8_t opt_read(void *ctx)
+{
+    (void)ctx;
+
+    if ((opt.byteCount++ & 1) == 0)
+    {
+        opt.readValue = opt_read_register(opt.pointer);
+        return (uint8_t)(opt.readValue >> 8);
+    }
+
+    return (uint8_t)opt.readValue;
+}
+
+static void opt_stop(void *ctx)
+{
+    (void)ctx;
+    opt.transfers++;
+}
+
+/*-------------------------------------------------------------------------
+ * Environment API
+ *-----------------------------------------------------------------------*/
+void sim_opt3001_reset(void)
+{
+    static const sim_i2c_slave_t slave =
+    {
+        OPT_ADDRESS, NULL, opt_start, opt_write, opt_read, opt_stop
+    };
+
+    memset(&opt, 0, sizeof(opt));
+    opt.present = true;
+    opt.lux = 300.0;
+    opt.config = 0xC810;
+    opt.lowLimit = 0x0000;
+    opt.highLimit = 0xBFFF;
+
+    sim_i2c_attach(OPT_I2C_MODULE, &slave);
+    sim_add_hook(SIM_TICKS_PER_MS, opt_tick, NULL);
+    opt_drive_int();
+}
+
+void sim_opt3001_set_lux(double lux)
+{
+    opt.lux = lux;
+}
+
+void sim_opt3001_set_present(bool present)
+{
+    opt.present = present;
+}
+
+uint32_t sim_opt3001_transfers(void)
+{
+    return opt.transfers;
+}
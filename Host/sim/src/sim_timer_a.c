@@ -0,0 +1,162 @@
+/*
+ * sim_timer_a.c
+ *
+ * Timer_A model and DriverLib API.  The counter is derived from simulated
+ * time and the clock source; compare outputs are reported as a duty cycle,
+ * which is all the motor model needs from the PWM.
+ */
+
+#include <string.h>
+#include "msp.h"
+#include "ti/devices/msp432p4xx/driverlib/driverlib.h"
+#include "sim.h"
+#include "sim_internal.h"
+
+#define TIMER_A_MC_MASK     (0x0030)
+#define TIMER_A_SSEL_MASK   (0x0300)
+#define TIMER_A_OUTMOD_MASK (0x00E0)
+
+static uint32_t divider[4];
+static uint64_t startTime[4];
+
+static unsigned sim_timer_index(uint32_t timer)
+{
+    return ((timer - TIMER_A0_BASE) >> 10) & 0x3;
+}
+
+static uint32_t sim_timer_clock_hz(unsigned n)
+{
+    uint32_t source;
+
+    switch (sim_timer_a[n].CTL & TIMER_A_SSEL_MASK)
+    {
+    case TIMER_A_CLOCKSOURCE_SMCLK:
+        source = sim_smclk_hz();
+        break;
+    case TIMER_A_CLOCKSOURCE_ACLK:
+        source = 32768;
+        break;
+    default:
+        source = 0;
+        break;
+    }
+
+    return divider[n] ? source / divider[n] : source;
+}
+
+void sim_timer_a_step(void)
+{
+    unsigned n;
+    uint64_t count;
+    Timer_A_Type *t;
+
+    for (n = 0; n < 4; n++)
+    {
+        t = &sim_timer_a[n];
+        if (!(t->CTL & TIMER_A_MC_MASK))
+            continue;
+
+        count = (sim_now() - startTime[n]) * sim_timer_clock_hz(n) / SIM_TICK_HZ;
+
+        if ((t->CTL & TIMER_A_MC_MASK) == TIMER_A_UP_MODE)
+            t->R = (uint16_t)(count % ((uint32_t)t->CCR[0] + 1));
+        else
+            t->R = (uint16_t)count;
+    }
+}
+
+/* Fraction of the period the compare output is high */
+float sim_timer_a_duty(unsigned timer, unsigned ccr)
+{
+    Timer_A_Type *t = &sim_timer_a[timer];
+    float duty;
+
+    if (((t->CTL & TIMER_A_MC_MASK) != TIMER_A_UP_MODE) || (t->CCR[0] == 0))
+        return 0.0f;
+
+    duty = (float)t->CCR[ccr] / (float)t->CCR[0];
+    if (duty > 1.0f)
+        duty = 1.0f;
+
+    switch (t->CCTL[ccr] & TIMER_A_OUTMOD_MASK)
+    {
+    case TIMER_A_OUTPUTMODE_RESET_SET:
+        return duty;
+    case TIMER_A_OUTPUTMODE_SET_RESET:
+        return 1.0f - duty;
+    default:
+        return 0.0f;
+    }
+}
+
+/*-------------------------------------------------------------------------
+ * DriverLib
+ *-----------------------------------------------------------------------*/
+void Timer_A_generatePWM(uint32_t timer, const Timer_A_PWMConfig *config)
+{
+    unsigned n = sim_timer_index(timer);
+    unsigned ccr = (config->compareRegister - TIMER_A_CAPTURECOMPARE_REGISTER_0) / 2;
+    Timer_A_Type *t = &sim_timer_a[n];
+
+    sim_cycles(SIM_DRIVERLIB_CYCLES);
+
+    /* Like DriverLib, the counter is cleared on every call */
+    divider[n] = config->clockSourceDivider;
+    startTime[n] = sim_now();
+    t->CTL = config->clockSource | TIMER_A_UP_MODE;
+    t->R = 0;
+    t->CCR[0] = config->timerPeriod;
+    t->CCTL[ccr] = config->compareOutputMode;
+    t->CCR[ccr] = config->dutyCycle;
+}
+
+void Timer_A_setCompareValue(uint32_t timer, uint_fast16_t compareRegister, uint_fast16_t compareValue)
+{
+    sim_cycles(SIM_DRIVERLIB_CYCLES);
+    sim_timer_a[sim_timer_index(timer)].CCR[(compareRegister - TIMER_A_CAPTURECOMPARE_REGISTER_0) / 2] = compareValue;
+}
+
+void Timer_A_configureContinuousMode(uint32_t timer, const Timer_A_ContinuousModeConfig *config)
+{
+    unsigned n = sim_timer_index(timer);
+
+    sim_cycles(SIM_DRIVERLIB_CYCLES);
+
+    divider[n] = config->clockSourceDivider;
+    sim_timer_a[n].CTL = (sim_timer_a[n].CTL & TIMER_A_MC_MASK) | config->clockSource;
+    if (config->timerClear)
+    {
+        startTime[n] = sim_now();
+        sim_timer_a[n].R = 0;
+    }
+}
+
+void Timer_A_startCounter(uint32_t timer, uint_fast16_t timerMode)
+{
+    unsigned n = sim_timer_index(timer);
+
+    sim_cycles(SIM_DRIVERLIB_CYCLES);
+
+    /* Carry on from the current count */
+    startTime[n] = sim_now();
+    if (sim_timer_clock_hz(n))
+        startTime[n] -= (uint64_t)sim_timer_a[n].R * SIM_TICK_HZ / sim_timer_clock_hz(n);
+
+    sim_timer_a[n].CTL = (sim_timer_a[n].CTL & ~TIMER_A_MC_MASK) | timerMode;
+}
+
+void Timer_A_stopTimer(uint32_t timer)
+{
+    unsigned n = sim_timer_index(timer);
+
+    sim_cycles(SIM_DRIVERLIB_CYCLES);
+    sim_timer_a_step();
+    sim_timer_a[n].CTL &= ~TIMER_A_MC_MASK;
+}
+
+uint_fast16_t Timer_A_getCounterValue(uint32_t timer)
+{
+    sim_cycles(SIM_DRIVERLIB_CYCLES);
+    sim_timer_a_step();
+    return sim_timer_a[sim_timer_index(timer)].R;
+}
@@ -0,0 +1,250 @@
+/*
+ * sim_uart.c
+ *
+ * eUSCI_A UART model, transmit side, and its DriverLib API.
+ *
+ * TXBUF and the shift register are modelled separately.  A byte written to
+ * TXBUF moves to the shift register as soon as it is free, which sets TXIFG
+ * again, and takes 1 start + 8 data + parity + stop bits on the wire at the
+ * baud rate given by the clock prescaler and first modulation stage.  Every
+ * rising edge of TXIFG is a DMA request, as on the part.
+ */
+
+#include <string.h>
+#include "msp.h"
+#include "ti/devices/msp432p4xx/driverlib/driverlib.h"
+#include "sim.h"
+#include "sim_internal.h"
+
+#define SIM_UART_TXBUF_OFFSET   0x0E    /* UCAxTXBUF */
+
+typedef struct
+{
+    bool configured;
+    bool enabled;
+    uint32_t clockSource;
+    uint32_t divider;           /* clock cycles per bit */
+    unsigned frameBits;
+
+    bool txFull;
+    uint8_t txBuf;
+    bool shifting;
+    uint8_t shift;
+    uint64_t shiftEnd;
+
+    sim_uart_sink_t sink;
+    void *ctx;
+} sim_uart_t;
+
+static sim_uart_t uart[4];
+
+static unsigned sim_uart_index(uint32_t moduleInstance)
+{
+    return ((moduleInstance - EUSCI_A0_BASE) >> 10) & 0x3;
+}
+
+void sim_uart_reset(void)
+{
+    unsigned m;
+    sim_uart_sink_t sink[4];
+    void *ctx[4];
+
+    /* Sinks belong to the environment and survive a reset */
+    for (m = 0; m < 4; m++)
+    {
+        sink[m] = uart[m].sink;
+        ctx[m] = uart[m].ctx;
+    }
+
+    memset(uart, 0, sizeof(uart));
+
+    for (m = 0; m < 4; m++)
+    {
+        uart[m].sink = sink[m];
+        uart[m].ctx = ctx[m];
+    }
+}
+
+void sim_uart_attach(unsigned module, sim_uart_sink_t sink, void *ctx)
+{
+    uart[module & 0x3].sink = sink;
+    uart[module & 0x3].ctx = ctx;
+}
+
+uint32_t sim_uart_baud_rate(unsigned module)
+{
+    sim_uart_t *u = &uart[module & 0x3];
+    uint32_t clk;
+
+    if (!u->configured || !u->divider)
+        return 0;
+
+    clk = (u->clockSource == EUSCI_A_UART_CLOCKSOURCE_SMCLK) ? sim_smclk_hz() : 32768;
+
+    return clk / u->divider;
+}
+
+static uint64_t sim_uart_frame_ticks(unsigned m)
+{
+    uint32_t baud = sim_uart_baud_rate(m);
+
+    if (!baud)
+        return SIM_TICK_HZ;
+
+    return (SIM_TICK_HZ * uart[m].frameBits) / baud;
+}
+
+/* Move TXBUF into the shift register if it is free */
+static void sim_uart_load_shift(unsigned m, uint64_t start)
+{
+    sim_uart_t *u = &uart[m];
+
+    if (u->shifting || !u->txFull)
+        return;
+
+    u->shift = u->txBuf;
+    u->txFull = false;
+    u->shifting = true;
+    u->shiftEnd = start + sim_uart_frame_ticks(m);
+
+    /* TXIFG rises */
+    if (m == 0)
+        sim_dma_request(DMA_CH0_EUSCIA0TX);
+
+    sim_schedule(u->shiftEnd);
+}
+
+void sim_uart_write(unsigned m, uint8_t data)
+{
+    sim_uart_t *u = &uart[m];
+
+    if (!u->enabled)
+        return;
+
+    if (u->txFull)
+        sim_fault("eUSCI_A%u TXBUF written while full, byte 0x%02X lost", m, u->txBuf);
+
+    u->txBuf = data;
+    u->txFull = true;
+    sim_uart_load_shift(m, sim_now());
+}
+
+bool sim_uart_is_txbuf(uint32_t address, unsigned *module)
+{
+    unsigned m;
+
+    for (m = 0; m < 4; m++)
+    {
+        if (address == EUSCI_A0_BASE + (m << 10) + SIM_UART_TXBUF_OFFSET)
+        {
+            *module = m;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void sim_uart_step(void)
+{
+    sim_uart_t *u;
+    unsigned m;
+
+    for (m = 0; m < 4; m++)
+    {
+        u = &uart[m];
+
+        while (u->shifting && (u->shiftEnd <= sim_now()))
+        {
+            u->shifting = false;
+            if (u->sink)
+                u->sink(u->ctx, u->shift);
+
+            /* The next byte follows straight on from the stop bit */
+            sim_uart_load_shift(m, u->shiftEnd);
+        }
+
+        if (u->shifting)
+            sim_schedule(u->shiftEnd);
+    }
+}
+
+/*-------------------------------------------------------------------------
+ * DriverLib
+ *-----------------------------------------------------------------------*/
+static unsigned sim_uart_call(uint32_t moduleInstance)
+{
+    sim_cycles(SIM_DRIVERLIB_CYCLES);
+    return sim_uart_index(moduleInstance);
+}
+
+bool UART_initModule(uint32_t moduleInstance, const eUSCI_UART_Config *config)
+{
+    sim_uart_t *u = &uart[sim_uart_call(moduleInstance)];
+
+    u->enabled = false;
+    u->configured = true;
+    u->clockSource = config->selectClockSource;
+
+    /* The second modulation stage only moves single bit edges, ignore it */
+    if (config->overSampling)
+        u->divider = 16 * (uint32_t)config->clockPrescalar + config->firstModReg;
+    else
+        u->divider = config->clockPrescalar;
+
+    u->frameBits = 10;
+    if (config->parity != EUSCI_A_UART_NO_PARITY)
+        u->frameBits++;
+    if (config->numberofStopBits == EUSCI_A_UART_TWO_STOP_BITS)
+        u->frameBits++;
+
+    return true;
+}
+
+void UART_enableModule(uint32_t moduleInstance)
+{
+    uart[sim_uart_call(moduleInstance)].enabled = true;
+}
+
+void UART_disableModule(uint32_t moduleInstance)
+{
+    sim_uart_t *u = &uart[sim_uart_call(moduleInstance)];
+
+    u->enabled = false;
+    u->txFull = false;
+    u->shifting = false;
+}
+
+void UART_transmitData(uint32_t moduleInstance, uint_fast8_t transmitData)
+{
+    unsigned m = sim_uart_call(moduleInstance);
+
+    /* DriverLib busy-waits on TXIFG */
+    while (uart[m].enabled && uart[m].txFull)
+        sim_cycles(4);
+
+    sim_uart_write(m, transmitData);
+}
+
+uint_fast8_t UART_getInterruptStatus(uint32_t moduleInstance, uint8_t mask)
+{
+    sim_uart_t *u = &uart[sim_uart_call(moduleInstance)];
+    uint_fast8_t ifg = 0;
+
+    if (u->enabled && !u->txFull)
+        ifg |= EUSCI_A_UART_TRANSMIT_INTERRUPT_FLAG;
+
+    return ifg & mask;
+}
+
+uint_fast8_t UART_queryStatusFlags(uint32_t moduleInstance, uint_fast8_t mask)
+{
+    sim_uart_t *u = &uart[sim_uart_call(moduleInstance)];
+
+    return ((u->txFull || u->shifting) ? EUSCI_A_UART_BUSY : 0) & mask;
+}
+
+uint32_t UART_getTransmitBufferAddressForDMA(uint32_t moduleInstance)
+{
+    return EUSCI_A0_BASE + (sim_uart_call(moduleInstance) << 10) + SIM_UART_TXBUF_OFFSET;
+}
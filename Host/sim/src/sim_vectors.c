@@ -0,0 +1,132 @@
+/*
+ * sim_vectors.c
+ *
+ * Interrupt vector table.  Handlers are weak so the firmware's own
+ * definitions take over, as with startup_msp432p401r_ccs.c on target.
+ */
+
+#include "msp.h"
+#include "ti/devices/msp432p4xx/driverlib/driverlib.h"
+#include "sim.h"
+#include "sim_internal.h"
+
+static void Default_Handler(void)
+{
+    sim_fault("unhandled interrupt");
+}
+
+#define SIM_WEAK_HANDLER(name) \
+    void name(void) __attribute__((weak, alias("Default_Handler")));
+
+SIM_WEAK_HANDLER(SysTick_Handler)
+SIM_WEAK_HANDLER(PSS_IRQHandler)
+SIM_WEAK_HANDLER(CS_IRQHandler)
+SIM_WEAK_HANDLER(PCM_IRQHandler)
+SIM_WEAK_HANDLER(WDT_A_IRQHandler)
+SIM_WEAK_HANDLER(FPU_IRQHandler)
+SIM_WEAK_HANDLER(FLCTL_IRQHandler)
+SIM_WEAK_HANDLER(COMP_E0_IRQHandler)
+SIM_WEAK_HANDLER(COMP_E1_IRQHandler)
+SIM_WEAK_HANDLER(TA0_0_IRQHandler)
+SIM_WEAK_HANDLER(TA0_N_IRQHandler)
+SIM_WEAK_HANDLER(TA1_0_IRQHandler)
+SIM_WEAK_HANDLER(TA1_N_IRQHandler)
+SIM_WEAK_HANDLER(TA2_0_IRQHandler)
+SIM_WEAK_HANDLER(TA2_N_IRQHandler)
+SIM_WEAK_HANDLER(TA3_0_IRQHandler)
+SIM_WEAK_HANDLER(TA3_N_IRQHandler)
+SIM_WEAK_HANDLER(EUSCIA0_IRQHandler)
+SIM_WEAK_HANDLER(EUSCIA1_IRQHandler)
+SIM_WEAK_HANDLER(EUSCIA2_IRQHandler)
+SIM_WEAK_HANDLER(EUSCIA3_IRQHandler)
+SIM_WEAK_HANDLER(EUSCIB0_IRQHandler)
+SIM_WEAK_HANDLER(EUSCIB1_IRQHandler)
+SIM_WEAK_HANDLER(EUSCIB2_IRQHandler)
+SIM_WEAK_HANDLER(EUSCIB3_IRQHandler)
+SIM_WEAK_HANDLER(ADC14_IRQHandler)
+SIM_WEAK_HANDLER(T32_INT1_IRQHandler)
+SIM_WEAK_HANDLER(T32_INT2_IRQHandler)
+SIM_WEAK_HANDLER(T32_INTC_IRQHandler)
+SIM_WEAK_HANDLER(AES256_IRQHandler)
+SIM_WEAK_HANDLER(RTC_C_IRQHandler)
+SIM_WEAK_HANDLER(DMA_ERR_IRQHandler)
+SIM_WEAK_HANDLER(DMA_INT3_IRQHandler)
+SIM_WEAK_HANDLER(DMA_INT2_IRQHandler)
+SIM_WEAK_HANDLER(DMA_INT1_IRQHandler)
+SIM_WEAK_HANDLER(DMA_INT0_IRQHandler)
+SIM_WEAK_HANDLER(PORT1_IRQHandler)
+SIM_WEAK_HANDLER(PORT2_IRQHandler)
+SIM_WEAK_HANDLER(PORT3_IRQHandler)
+SIM_WEAK_HANDLER(PORT4_IRQHandler)
+SIM_WEAK_HANDLER(PORT5_IRQHandler)
+SIM_WEAK_HANDLER(PORT6_IRQHandler)
+
+/*
+ * Firmware built with ISR_PROFILE has its startup file point these vectors
+ * at the profiling wrappers in IsrProfile.c.  They are only defined then.
+ */
+void SysTick_ProfiledHandler(void) __attribute__((weak));
+void PORT1_ProfiledIRQHandler(void) __attribute__((weak));
+void PORT5_ProfiledIRQHandler(void) __attribute__((weak));
+
+/* Indexed by interrupt number, as INT_* in driverlib.h */
+static const sim_isr_t vectors[NUM_INTERRUPTS] =
+{
+    [FAULT_SYSTICK] = SysTick_Handler,
+    [INT_PSS]       = PSS_IRQHandler,
+    [INT_CS]        = CS_IRQHandler,
+    [INT_PCM]       = PCM_IRQHandler,
+    [INT_WDT_A]     = WDT_A_IRQHandler,
+    [INT_FPU]       = FPU_IRQHandler,
+    [INT_FLCTL]     = FLCTL_IRQHandler,
+    [22]            = COMP_E0_IRQHandler,
+    [23]            = COMP_E1_IRQHandler,
+    [INT_TA0_0]     = TA0_0_IRQHandler,
+    [INT_TA0_N]     = TA0_N_IRQHandler,
+    [INT_TA1_0]     = TA1_0_IRQHandler,
+    [INT_TA1_N]     = TA1_N_IRQHandler,
+    [INT_TA2_0]     = TA2_0_IRQHandler,
+    [INT_TA2_N]     = TA2_N_IRQHandler,
+    [INT_TA3_0]     = TA3_0_IRQHandler,
+    [INT_TA3_N]     = TA3_N_IRQHandler,
+    [INT_EUSCIA0]   = EUSCIA0_IRQHandler,
+    [INT_EUSCIA1]   = EUSCIA1_IRQHandler,
+    [INT_EUSCIA2]   = EUSCIA2_IRQHandler,
+    [INT_EUSCIA3]   = EUSCIA3_IRQHandler,
+    [INT_EUSCIB0]   = EUSCIB0_IRQHandler,
+    [INT_EUSCIB1]   = EUSCIB1_IRQHandler,
+    [INT_EUSCIB2]   = EUSCIB2_IRQHandler,
+    [INT_EUSCIB3]   = EUSCIB3_IRQHandler,
+    [INT_ADC14]     = ADC14_IRQHandler,
+    [INT_T32_INT1]  = T32_INT1_IRQHandler,
+    [INT_T32_INT2]  = T32_INT2_IRQHandler,
+    [INT_T32_INTC]  = T32_INTC_IRQHandler,
+    [INT_AES256]    = AES256_IRQHandler,
+    [INT_RTC_C]     = RTC_C_IRQHandler,
+    [INT_DMA_ERR]   = DMA_ERR_IRQHandler,
+    [INT_DMA_INT3]  = DMA_INT3_IRQHandler,
+    [INT_DMA_INT2]  = DMA_INT2_IRQHandler,
+    [INT_DMA_INT1]  = DMA_INT1_IRQHandler,
+    [INT_DMA_INT0]  = DMA_INT0_IRQHandler,
+    [INT_PORT1]     = PORT1_IRQHandler,
+    [INT_PORT2]     = PORT2_IRQHandler,
+    [INT_PORT3]     = PORT3_IRQHandler,
+    [INT_PORT4]     = PORT4_IRQHandler,
+    [INT_PORT5]     = PORT5_IRQHandler,
+    [INT_PORT6]     = PORT6_IRQHandler,
+};
+
+sim_isr_t sim_vector(uint32_t interruptNumber)
+{
+    if ((interruptNumber == FAULT_SYSTICK) && SysTick_ProfiledHandler)
+        return SysTick_ProfiledHandler;
+    if ((interruptNumber == INT_PORT1) && PORT1_ProfiledIRQHandler)
+        return PORT1_ProfiledIRQHandler;
+    if ((interruptNumber == INT_PORT5) && PORT5_ProfiledIRQHandler)
+        return PORT5_ProfiledIRQHandler;
+
+    if ((interruptNumber < NUM_INTERRUPTS) && vectors[interruptNumber])
+        return vectors[interruptNumber];
+
+    return Default_Handler;
+}
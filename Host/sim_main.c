@@ -0,0 +1,263 @@
+/*
+ * sim_main.c
+ *
+ * Command line runner: boots one of the lab firmwares on the simulated
+ * MSP432 inside the robot model, plays a script of button presses, bumps
+ * and light levels into it and prints a trace of what the firmware does
+ * with the motors and where the robot goes.
+ *
+ *   build/lab9 -m maps/box.map -t 30 -p s1@500 -v 250
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+#include <math.h>
+#include "msp.h"
+#include "sim.h"
+#include "robot.h"
+#include "world.h"
+
+#define MAX_EVENTS      32
+#define PRESS_MS        50      /* how long a scripted button press is held */
+#define DEFAULT_BUMP_MS 200
+
+/* The lab main() is compiled as firmware_main() (see Makefile) */
+int firmware_main(void);
+
+typedef struct
+{
+    uint32_t startMs;
+    uint32_t endMs;
+    unsigned port;
+    uint8_t pin;
+    bool active;
+} script_event_t;
+
+static script_event_t events[MAX_EVENTS];
+static unsigned numEvents;
+static unsigned hangMs;                 /* 0 for no hang */
+
+/* Bump switches 0..5 on P4, active low */
+static const uint8_t bumpPin[6] = { 0x01, 0x04, 0x08, 0x20, 0x40, 0x80 };
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "usage: %s [options]\n"
+            "  -t seconds      simulated run time (default 5)\n"
+            "  -m file         world map with walls and tape (default: empty floor)\n"
+            "  -p s1@ms        press S1 (P1.1) or S2 (P1.4) at the given time\n"
+            "  -b n@ms[:end]   hold bump switch n (0-5) from ms to end\n"
+            "  -l lux          light level seen by the OPT3001 (default 300)\n"
+            "  -n              OPT3001 not fitted (address NACKs)\n"
+            "  -x              48 MHz crystal broken, it never starts\n"
+            "  -H ms           the firmware's main loop hangs at the given time\n"
+            "  -g              wheels grip: a wall stalls them instead of letting them slip\n"
+            "  -E l@ms|r@ms    the left or right encoder fails at the given time\n"
+            "  -v ms           trace period, 0 for summary only (default 100)\n"
+            "  -u file         write the eUSCI_A0 (backchannel UART) output to file\n"
+            "  -w seconds      wall clock limit (default 60)\n",
+            prog);
+    exit(1);
+}
+
+static void add_event(unsigned port, uint8_t pin, uint32_t startMs, uint32_t endMs)
+{
+    if (numEvents >= MAX_EVENTS)
+    {
+        fprintf(stderr, "too many events\n");
+        exit(1);
+    }
+
+    events[numEvents].port = port;
+    events[numEvents].pin = pin;
+    events[numEvents].startMs = startMs;
+    events[numEvents].endMs = endMs;
+    numEvents++;
+}
+
+static void parse_press(const char *arg)
+{
+    unsigned ms;
+
+    if (sscanf(arg, "s1@%u", &ms) == 1)
+        add_event(1, 0x02, ms, ms + PRESS_MS);
+    else if (sscanf(arg, "s2@%u", &ms) == 1)
+        add_event(1, 0x10, ms, ms + PRESS_MS);
+    else
+    {
+        fprintf(stderr, "bad button press '%s'\n", arg);
+        exit(1);
+    }
+}
+
+static void parse_encoder_fail(robot_params_t *params, const char *arg)
+{
+    unsigned ms;
+
+    if (sscanf(arg, "l@%u", &ms) == 1)
+        params->encoderFail[ROBOT_LEFT] = ms / 1000.0;
+    else if (sscanf(arg, "r@%u", &ms) == 1)
+        params->encoderFail[ROBOT_RIGHT] = ms / 1000.0;
+    else
+    {
+        fprintf(stderr, "bad encoder failure '%s'\n", arg);
+        exit(1);
+    }
+}
+
+static void parse_bump(const char *arg)
+{
+    unsigned n, start, end;
+    int fields = sscanf(arg, "%u@%u:%u", &n, &start, &end);
+
+    if ((fields < 2) || (n > 5))
+    {
+        fprintf(stderr, "bad bump '%s'\n", arg);
+        exit(1);
+    }
+
+    add_event(4, bumpPin[n], start, (fields == 3) ? end : start + DEFAULT_BUMP_MS);
+}
+
+/* Drive the scripted pins, pulled up inputs are pressed by pulling low */
+static void script_hook(void *ctx)
+{
+    uint32_t ms = (uint32_t)(sim_now() / SIM_TICKS_PER_MS);
+    unsigned i;
+
+    (void)ctx;
+
+    if (hangMs && (ms == hangMs))
+        sim_hang();
+
+    for (i = 0; i < numEvents; i++)
+    {
+        script_event_t *e = &events[i];
+
+        if (!e->active && (ms >= e->startMs) && (ms < e->endMs))
+        {
+            e->active = true;
+            sim_gpio_drive(e->port, e->pin, 0);
+        }
+        else if (e->active && (ms >= e->endMs))
+        {
+            e->active = false;
+            sim_gpio_release(e->port, e->pin);
+        }
+    }
+}
+
+static void print_state(void)
+{
+    const robot_state_t *r = robot_state();
+    uint8_t p2 = sim_gpio_output(2);
+    uint8_t p5 = sim_gpio_output(5);
+
+    printf("%9.3f  L %5.1f%% %s %6.0f  R %5.1f%% %s %6.0f  x %6.0f y %6.0f h %4.0f  bump %02x  LED %c%c%c%c  i2c %u  %2lu MHz %s%u\n",
+           sim_seconds(),
+           100.0f * sim_timer_a_duty(0, 4), (p5 & 0x10) ? "rev" : "fwd", robot_wheel_counts(ROBOT_LEFT),
+           100.0f * sim_timer_a_duty(0, 3), (p5 & 0x20) ? "rev" : "fwd", robot_wheel_counts(ROBOT_RIGHT),
+           r->x * 1000, r->y * 1000, r->heading * 180 / M_PI, r->bumps,
+           (sim_gpio_output(1) & 0x01) ? '1' : '-',
+           (p2 & 0x01) ? 'R' : '-', (p2 & 0x02) ? 'G' : '-', (p2 & 0x04) ? 'B' : '-',
+           sim_opt3001_transfers(),
+           (unsigned long)(sim_mclk_hz() / 1000000),
+           (sim_power_mode() & 4) ? "DCDC" : "LDO", (unsigned)(sim_power_mode() & 1));
+}
+
+static void trace_hook(void *ctx)
+{
+    (void)ctx;
+    print_state();
+}
+
+static void uart_sink(void *ctx, uint8_t data)
+{
+    fputc(data, (FILE *)ctx);
+}
+
+static void wall_clock_expired(int sig)
+{
+    static const char msg[] = "sim: wall clock limit reached\n";
+
+    (void)sig;
+    if (write(STDERR_FILENO, msg, sizeof(msg) - 1) < 0)
+        _exit(3);
+    _exit(3);
+}
+
+int main(int argc, char *argv[])
+{
+    double seconds = 5.0, lux = 300.0;
+    unsigned traceMs = 100, wallSeconds = 60;
+    bool present = true;
+    int opt, result;
+    static world_t world;
+    robot_params_t params;
+    FILE *uartFile = NULL;
+
+    sim_reset();
+    world_init(&world);
+    robot_default_params(&params);
+
+    while ((opt = getopt(argc, argv, "t:m:p:b:l:nxH:gE:u:v:w:h")) != -1)
+    {
+        switch (opt)
+        {
+        case 't': seconds = atof(optarg); break;
+        case 'm':
+            if (!world_load(&world, optarg))
+                exit(1);
+            break;
+        case 'p': parse_press(optarg); break;
+        case 'b': parse_bump(optarg); break;
+        case 'l': lux = atof(optarg); break;
+        case 'n': present = false; break;
+        case 'x': sim_hfxt_set_broken(true); break;
+        case 'H': hangMs = (unsigned)atoi(optarg); break;
+        case 'g': params.grip = true; break;
+        case 'E': parse_encoder_fail(&params, optarg); break;
+        case 'u':
+            uartFile = fopen(optarg, "wb");
+            if (!uartFile)
+            {
+                perror(optarg);
+                exit(1);
+            }
+            sim_uart_attach(0, uart_sink, uartFile);
+            break;
+        case 'v': traceMs = (unsigned)atoi(optarg); break;
+        case 'w': wallSeconds = (unsigned)atoi(optarg); break;
+        default:  usage(argv[0]);
+        }
+    }
+
+    robot_attach(&params, &world);
+    sim_opt3001_set_lux(lux);
+    sim_opt3001_set_present(present);
+    sim_add_hook(SIM_TICKS_PER_MS, script_hook, NULL);
+    if (traceMs)
+        sim_add_hook(traceMs * SIM_TICKS_PER_MS, trace_hook, NULL);
+
+    signal(SIGALRM, wall_clock_expired);
+    alarm(wallSeconds);
+
+    result = sim_run(firmware_main, seconds);
+
+    printf("--- %.3f s simulated, MCLK %lu Hz, SMCLK %lu Hz, I2C SCL %lu Hz, %.0f mm driven, %u wall contacts\n",
+           sim_seconds(), (unsigned long)sim_mclk_hz(), (unsigned long)sim_smclk_hz(),
+           (unsigned long)sim_i2c_bit_rate(1), robot_state()->distance * 1000, robot_state()->wallContacts);
+    if (uartFile)
+    {
+        printf("    eUSCI_A0 %lu baud, %lu bytes written\n",
+               (unsigned long)sim_uart_baud_rate(0), (unsigned long)ftell(uartFile));
+        fclose(uartFile);
+    }
+    print_state();
+
+    return result;
+}
@@ -0,0 +1,510 @@
+/*
+ * sweep.c
+ *
+ * Monte-Carlo parameter sweep of the encoder move controllers in Motor.c.
+ *
+ * Every point of a grid over P, I, the stop threshold and the tick target
+ * is run against many randomly perturbed robots (motor speed mismatch,
+ * dead band/friction, motor time constant, encoder contact bounce).  The
+ * runs are spread over worker processes, one per core by default, and the
+ * distributions of settling time, overshoot and final error are reported
+ * for each grid point so the gains can be picked from data.
+ *
+ * Run k of every grid point uses the same random robot, so differences
+ * between grid points come from the parameters rather than the draw.
+ *
+ *   build/sweep -c pid -P 0.1:0.5:5 -I 0:0.002:3 -T 150 -n 200
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "msp.h"
+#include "ti/devices/msp432p4xx/driverlib/driverlib.h"
+#include "sim.h"
+#include "robot.h"
+#include "world.h"
+#include "Clock.h"
+#include "Motor.h"
+#include "Encoder.h"
+
+#define MAX_AXIS        32
+#define MAX_WORKERS     256
+#define LOOP_MS         10          /* control period, as in the lab main loops */
+#define COAST_MS        500         /* watched after the move reports done */
+
+typedef struct
+{
+    double from, to;
+    unsigned steps;
+} sweep_axis_t;
+
+typedef struct
+{
+    float p, i;
+    int threshold;
+    int target;
+} sweep_point_t;
+
+typedef struct
+{
+    uint32_t point;
+    uint32_t run;
+    uint8_t settled;
+    float settleTime;               /* s from the start of the move to done */
+    float overshoot;                /* counts past the target, worst wheel */
+    float finalError;               /* counts from the target after coasting, worst wheel */
+} sweep_result_t;
+
+/* Options */
+static bool usePid = true;
+static bool driveStraight = false;
+static float speedFactor = 0.25f;
+static double timeout = 10.0;
+static double noise = 1.0;
+static uint32_t baseSeed = 1;
+
+/* State of the run in progress (one per worker process) */
+static const sweep_point_t *current;
+static sweep_result_t result;
+static double startCounts[2];
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "usage: %s [options]\n"
+            "  -c simple|pid   controller, rotate_motors_by_counts[_pid] (default pid)\n"
+            "  -P from:to:n    proportional gain (default 0.3)\n"
+            "  -I from:to:n    integral gain (default 0.001)\n"
+            "  -S from:to:n    stop threshold in counts (default 8 simple, 2 pid)\n"
+            "  -T from:to:n    tick target (default 150)\n"
+            "  -d              drive straight instead of turning in place\n"
+            "  -s speed        speed factor (default 0.25)\n"
+            "  -n runs         random robots per grid point (default 100)\n"
+            "  -N level        noise level, 0 for the nominal robot (default 1)\n"
+            "  -j workers      worker processes (default one per core)\n"
+            "  -t seconds      simulated time limit per run (default 10)\n"
+            "  -r seed         base random seed (default 1)\n"
+            "  -o file         write every run to a CSV file\n",
+            prog);
+    exit(1);
+}
+
+static void parse_axis(sweep_axis_t *a, const char *arg)
+{
+    int n = sscanf(arg, "%lf:%lf:%u", &a->from, &a->to, &a->steps);
+
+    if (n == 1)
+    {
+        a->to = a->from;
+        a->steps = 1;
+    }
+    else if ((n != 3) || (a->steps == 0) || (a->steps > MAX_AXIS))
+    {
+        fprintf(stderr, "bad range '%s', expected value or from:to:n (n <= %d)\n", arg, MAX_AXIS);
+        exit(1);
+    }
+}
+
+static double axis_value(const sweep_axis_t *a, unsigned k)
+{
+    return (a->steps > 1) ? a->from + (a->to - a->from) * k / (a->steps - 1) : a->from;
+}
+
+/*-------------------------------------------------------------------------
+ * One run
+ *-----------------------------------------------------------------------*/
+static double sweep_random(uint32_t *state)
+{
+    *state ^= *state << 13;
+    *state ^= *state >> 17;
+    *state ^= *state << 5;
+
+    return *state / 4294967296.0;
+}
+
+/* Standard normal by Box-Muller */
+static double sweep_gauss(uint32_t *state)
+{
+    double u = sweep_random(state) + 1e-12;
+
+    return sqrt(-2.0 * log(u)) * cos(2 * M_PI * sweep_random(state));
+}
+
+static void sweep_robot(robot_params_t *p, uint32_t run)
+{
+    uint32_t state = (baseSeed + run) * 2654435761u + 1;
+
+    robot_default_params(p);
+
+    p->maxRpm[ROBOT_LEFT] *= 1.0 + 0.05 * noise * sweep_gauss(&state);
+    p->maxRpm[ROBOT_RIGHT] *= 1.0 + 0.05 * noise * sweep_gauss(&state);
+    p->deadband += 0.05 * noise * sweep_random(&state);
+    p->tau *= 1.0 + 0.3 * noise * (2 * sweep_random(&state) - 1);
+    p->edgeGlitch = 0.002 * noise;
+    p->seed = state;
+}
+
+static int sweep_target(unsigned side)
+{
+    return (side == ROBOT_RIGHT && !driveStraight) ? -current->target : current->target;
+}
+
+static void sweep_measure(bool final)
+{
+    double progress, past;
+    unsigned side;
+
+    for (side = 0; side < 2; side++)
+    {
+        progress = robot_wheel_counts(side) - startCounts[side];
+        past = (sweep_target(side) >= 0) ? progress - sweep_target(side) : sweep_target(side) - progress;
+
+        if (past > result.overshoot)
+            result.overshoot = (float)past;
+
+        if (final && (fabs(past) > result.finalError))
+            result.finalError = (float)fabs(past);
+    }
+}
+
+static bool sweep_move(motor_mode_t mode)
+{
+    int left = sweep_target(ROBOT_LEFT), right = sweep_target(ROBOT_RIGHT);
+
+    return usePid ? rotate_motors_by_counts_pid(mode, speedFactor, left, right)
+                  : rotate_motors_by_counts(mode, speedFactor, left, right);
+}
+
+/* Runs on the simulated MSP432 */
+static int sweep_firmware(void)
+{
+    double start;
+    unsigned ms;
+
+    Clock_Init48MHz();
+    MAP_WDT_A_holdTimer();
+    motor_init();
+    encoder_init();
+    MAP_Interrupt_enableMaster();
+
+    startCounts[ROBOT_LEFT] = robot_wheel_counts(ROBOT_LEFT);
+    startCounts[ROBOT_RIGHT] = robot_wheel_counts(ROBOT_RIGHT);
+    start = sim_seconds();
+
+    sweep_move(INITIAL);
+    while (!sweep_move(CONTINUOUS))
+    {
+        sweep_measure(false);
+        Clock_Delay1ms(LOOP_MS);
+    }
+
+    result.settled = 1;
+    result.settleTime = (float)(sim_seconds() - start);
+
+    /* Stop as the lab state machines do and let the robot coast */
+    set_left_motor_pwm(0);
+    set_right_motor_pwm(0);
+    for (ms = 0; ms < COAST_MS; ms += LOOP_MS)
+    {
+        sweep_measure(false);
+        Clock_Delay1ms(LOOP_MS);
+    }
+
+    return 0;
+}
+
+static void sweep_run(const sweep_point_t *point, uint32_t pointIndex, uint32_t run)
+{
+    static world_t world;
+    robot_params_t params;
+
+    memset(&result, 0, sizeof(result));
+    result.point = pointIndex;
+    result.run = run;
+    current = point;
+
+    sim_reset();
+    world_init(&world);
+    sweep_robot(&params, run);
+    robot_attach(&params, &world);
+
+    left_motor_count = 0;
+    right_motor_count = 0;
+    motor_pid_p = point->p;
+    motor_pid_i = point->i;
+    if (usePid)
+        motor_pid_stop_threshold = point->threshold;
+    else
+        motor_stop_threshold = point->threshold;
+
+    sim_run(sweep_firmware, timeout);
+    sweep_measure(true);
+}
+
+/*-------------------------------------------------------------------------
+ * Workers and statistics
+ *-----------------------------------------------------------------------*/
+static void sweep_worker(int fd, const sweep_point_t *points, unsigned numPoints,
+                         unsigned runs, unsigned worker, unsigned workers)
+{
+    unsigned job;
+
+    for (job = worker; job < numPoints * runs; job += workers)
+    {
+        sweep_run(&points[job / runs], job / runs, job % runs);
+
+        if (write(fd, &result, sizeof(result)) != (ssize_t)sizeof(result))
+            _exit(1);
+    }
+
+    _exit(0);
+}
+
+static int compare_float(const void *a, const void *b)
+{
+    float x = *(const float *)a, y = *(const float *)b;
+
+    return (x > y) - (x < y);
+}
+
+/* p in [0, 1] of n sorted values */
+static float percentile(const float *v, unsigned n, double p)
+{
+    return n ? v[(unsigned)(p * (n - 1) + 0.5)] : NAN;
+}
+
+typedef struct
+{
+    unsigned settled;
+    float settle50, settle90;
+    float over50, over90, overMax;
+    float err50, err90, errMax;
+} sweep_summary_t;
+
+static void summarise(const sweep_result_t *r, unsigned n, sweep_summary_t *s, float *scratch)
+{
+    unsigned i, k;
+
+    memset(s, 0, sizeof(*s));
+
+    for (i = k = 0; i < n; i++)
+    {
+        if (r[i].settled)
+            scratch[k++] = r[i].settleTime;
+    }
+    s->settled = k;
+    qsort(scratch, k, sizeof(float), compare_float);
+    s->settle50 = percentile(scratch, k, 0.5);
+    s->settle90 = percentile(scratch, k, 0.9);
+
+    for (i = 0; i < n; i++)
+        scratch[i] = r[i].overshoot;
+    qsort(scratch, n, sizeof(float), compare_float);
+    s->over50 = percentile(scratch, n, 0.5);
+    s->over90 = percentile(scratch, n, 0.9);
+    s->overMax = scratch[n - 1];
+
+    for (i = 0; i < n; i++)
+        scratch[i] = r[i].finalError;
+    qsort(scratch, n, sizeof(float), compare_float);
+    s->err50 = percentile(scratch, n, 0.5);
+    s->err90 = percentile(scratch, n, 0.9);
+    s->errMax = scratch[n - 1];
+}
+
+int main(int argc, char *argv[])
+{
+    sweep_axis_t axisP = { 0.3, 0.3, 1 }, axisI = { 0.001, 0.001, 1 };
+    sweep_axis_t axisS = { 0, 0, 0 }, axisT = { 150, 150, 1 };
+    sweep_point_t *points;
+    sweep_result_t *results, r;
+    sweep_summary_t s, bestSummary;
+    unsigned numPoints, runs = 100, workers, w, a, b, c, d, k, received = 0, best = 0;
+    const char *csv = NULL;
+    pid_t pids[MAX_WORKERS];
+    float *scratch;
+    int fds[2], opt, status, failed = 0;
+    FILE *out;
+
+    workers = (unsigned)sysconf(_SC_NPROCESSORS_ONLN);
+
+    while ((opt = getopt(argc, argv, "c:P:I:S:T:ds:n:N:j:t:r:o:h")) != -1)
+    {
+        switch (opt)
+        {
+        case 'c':
+            if (!strcmp(optarg, "pid"))
+                usePid = true;
+            else if (!strcmp(optarg, "simple"))
+                usePid = false;
+            else
+                usage(argv[0]);
+            break;
+        case 'P': parse_axis(&axisP, optarg); break;
+        case 'I': parse_axis(&axisI, optarg); break;
+        case 'S': parse_axis(&axisS, optarg); break;
+        case 'T': parse_axis(&axisT, optarg); break;
+        case 'd': driveStraight = true; break;
+        case 's': speedFactor = (float)atof(optarg); break;
+        case 'n': runs = (unsigned)atoi(optarg); break;
+        case 'N': noise = atof(optarg); break;
+        case 'j': workers = (unsigned)atoi(optarg); break;
+        case 't': timeout = atof(optarg); break;
+        case 'r': baseSeed = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 'o': csv = optarg; break;
+        default:  usage(argv[0]);
+        }
+    }
+
+    if (axisS.steps == 0)
+    {
+        axisS.from = axisS.to = usePid ? 2 : 8;
+        axisS.steps = 1;
+    }
+    if (runs == 0)
+        usage(argv[0]);
+    if (workers < 1)
+        workers = 1;
+    if (workers > MAX_WORKERS)
+        workers = MAX_WORKERS;
+
+    /* The simple controller has no gains, don't sweep them */
+    if (!usePid)
+        axisP.steps = axisI.steps = 1;
+
+    numPoints = axisP.steps * axisI.steps * axisS.steps * axisT.steps;
+    points = calloc(numPoints, sizeof(*points));
+    results = calloc((size_t)numPoints * runs, sizeof(*results));
+    scratch = calloc(runs, sizeof(*scratch));
+    if (!points || !results || !scratch)
+    {
+        perror("sweep");
+        return 1;
+    }
+
+    k = 0;
+    for (a = 0; a < axisP.steps; a++)
+        for (b = 0; b < axisI.steps; b++)
+            for (c = 0; c < axisS.steps; c++)
+                for (d = 0; d < axisT.steps; d++)
+                {
+                    points[k].p = (float)axis_value(&axisP, a);
+                    points[k].i = (float)axis_value(&axisI, b);
+                    points[k].threshold = (int)lround(axis_value(&axisS, c));
+                    points[k].target = (int)lround(axis_value(&axisT, d));
+                    k++;
+                }
+
+    if (workers > numPoints * runs)
+        workers = numPoints * runs;
+
+    fprintf(stderr, "sweep: %u points x %u runs on %u workers\n", numPoints, runs, workers);
+
+    if (pipe(fds) < 0)
+    {
+        perror("pipe");
+        return 1;
+    }
+
+    fflush(NULL);
+    for (w = 0; w < workers; w++)
+    {
+        pids[w] = fork();
+        if (pids[w] < 0)
+        {
+            perror("fork");
+            return 1;
+        }
+        if (pids[w] == 0)
+        {
+            close(fds[0]);
+            sweep_worker(fds[1], points, numPoints, runs, w, workers);
+        }
+    }
+    close(fds[1]);
+
+    /* Results are smaller than PIPE_BUF so worker writes never interleave */
+    for (;;)
+    {
+        ssize_t n = read(fds[0], &r, sizeof(r));
+
+        if ((n < 0) && (errno == EINTR))
+            continue;
+        if (n != (ssize_t)sizeof(r))
+            break;
+
+        results[(size_t)r.point * runs + r.run] = r;
+        received++;
+    }
+    close(fds[0]);
+
+    for (w = 0; w < workers; w++)
+    {
+        waitpid(pids[w], &status, 0);
+        if (!WIFEXITED(status) || WEXITSTATUS(status))
+            failed = 1;
+    }
+
+    if (failed || (received != numPoints * runs))
+    {
+        fprintf(stderr, "sweep: a worker failed, %u of %u runs received\n", received, numPoints * runs);
+        return 1;
+    }
+
+    if (csv)
+    {
+        out = fopen(csv, "w");
+        if (out == NULL)
+        {
+            perror(csv);
+            return 1;
+        }
+
+        fprintf(out, "p,i,threshold,target,run,settled,settle_s,overshoot,final_error\n");
+        for (k = 0; k < numPoints * runs; k++)
+        {
+            const sweep_point_t *pt = &points[results[k].point];
+
+            fprintf(out, "%g,%g,%d,%d,%u,%u,%.3f,%.2f,%.2f\n",
+                    pt->p, pt->i, pt->threshold, pt->target, results[k].run, results[k].settled,
+                    results[k].settleTime, results[k].overshoot, results[k].finalError);
+        }
+        fclose(out);
+    }
+
+    printf("controller %s, speed %.2f, %s, %u runs per point, noise %.2f\n",
+           usePid ? "pid" : "simple", speedFactor, driveStraight ? "drive" : "turn", runs, noise);
+    printf("%7s %8s %4s %5s | %5s | %-13s | %-20s | %-20s\n",
+           "P", "I", "stop", "ticks", "done", "settle s p50/90", "overshoot p50/90/max", "final err p50/90/max");
+
+    /* Best: most runs settled, then smallest p90 final error, then fastest */
+    memset(&bestSummary, 0, sizeof(bestSummary));
+    for (k = 0; k < numPoints; k++)
+    {
+        summarise(&results[(size_t)k * runs], runs, &s, scratch);
+
+        printf("%7.3f %8.5f %4d %5d | %4.0f%% | %6.2f %6.2f | %6.1f %6.1f %6.1f | %6.1f %6.1f %6.1f\n",
+               points[k].p, points[k].i, points[k].threshold, points[k].target,
+               100.0 * s.settled / runs, s.settle50, s.settle90,
+               s.over50, s.over90, s.overMax, s.err50, s.err90, s.errMax);
+
+        if ((k == 0) || (s.settled > bestSummary.settled) ||
+            ((s.settled == bestSummary.settled) &&
+             ((s.err90 < bestSummary.err90) ||
+              ((s.err90 == bestSummary.err90) && (s.settle50 < bestSummary.settle50)))))
+        {
+            best = k;
+            bestSummary = s;
+        }
+    }
+
+    printf("best: P %.3f I %.5f stop %d ticks %d\n",
+           points[best].p, points[best].i, points[best].threshold, points[best].target);
+
+    return 0;
+}
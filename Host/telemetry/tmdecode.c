@@ -0,0 +1,301 @@
+/*
+ * tmdecode.c
+ *
+ * Decode a capture of the Lab9 telemetry stream (Library/Telemetry.h) into
+ * CSV, one row per data frame: seq,time_ms and then the signals by name.
+ *
+ * The decoder syncs on 0xA5 0x5A, drops frames whose checksum is wrong and
+ * learns the signal list from the descriptor frames, so a capture may start
+ * anywhere in the stream.  Data frames before the first descriptor are
+ * counted and skipped.  The header row is printed again if the signal list
+ * changes.  Lost frames are counted from gaps in the sequence number.
+ *
+ *   stty -F /dev/ttyACM0 460800 raw -echo; cat /dev/ttyACM0 > run.bin
+ *   build/tmdecode -o run.csv run.bin
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+#include "Telemetry.h"
+
+#define FRAME_MAX   (TM_HEADER_SIZE + TM_MAX_PAYLOAD + TM_CHECK_SIZE)
+
+typedef struct
+{
+    unsigned count;
+    tm_type_t type[TM_MAX_SIGNALS];
+    char name[TM_MAX_SIGNALS][TM_MAX_NAME + 1];
+    unsigned length;                /* payload bytes of a data frame */
+} descriptor_t;
+
+static const unsigned typeSize[NUM_TM_TYPES] = { 1, 1, 2, 2, 4, 4, 4 };
+
+static descriptor_t desc;
+static bool haveDesc;
+static FILE *out;
+
+static bool haveSeq;
+static uint16_t lastSeq;
+
+static unsigned long frames, dataFrames, descFrames;
+static unsigned long badCheck, badLength, beforeDesc, lost, junk;
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "usage: %s [options] [capture]\n"
+            "  -o file         write the CSV to a file (default stdout)\n"
+            "  -q              no statistics on stderr\n"
+            "Reads stdin if no capture file is given.\n",
+            prog);
+    exit(1);
+}
+
+static uint32_t get32(const uint8_t *p)
+{
+    return p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint16_t get16(const uint8_t *p)
+{
+    return p[0] | (p[1] << 8);
+}
+
+static bool check_ok(const uint8_t *frame, unsigned length)
+{
+    uint32_t sum1 = 0, sum2 = 0;
+    unsigned i;
+
+    for (i = 2; i < length; i++)
+    {
+        sum1 += frame[i];
+        sum2 += sum1;
+    }
+
+    return (frame[length] == sum1 % 255) && (frame[length + 1] == sum2 % 255);
+}
+
+static void print_header(void)
+{
+    unsigned i;
+
+    fprintf(out, "seq,time_ms");
+    for (i = 0; i < desc.count; i++)
+        fprintf(out, ",%s", desc.name[i]);
+    fprintf(out, "\n");
+}
+
+static void decode_descriptor(const uint8_t *p, unsigned length)
+{
+    const uint8_t *end = p + length;
+    descriptor_t d;
+    unsigned i, n;
+
+    memset(&d, 0, sizeof(d));
+
+    if (length < 1 || p[0] > TM_MAX_SIGNALS)
+    {
+        badLength++;
+        return;
+    }
+    d.count = *p++;
+
+    for (i = 0; i < d.count; i++)
+    {
+        if ((end - p < 2) || (p[0] >= NUM_TM_TYPES) || (p[1] > TM_MAX_NAME) || (end - p < 2 + p[1]))
+        {
+            badLength++;
+            return;
+        }
+        d.type[i] = (tm_type_t)p[0];
+        n = p[1];
+        memcpy(d.name[i], p + 2, n);
+        d.name[i][n] = '\0';
+        d.length += typeSize[d.type[i]];
+        p += 2 + n;
+    }
+
+    if (!haveDesc || memcmp(&d, &desc, sizeof(d)))
+    {
+        desc = d;
+        haveDesc = true;
+        print_header();
+    }
+}
+
+static void decode_data(uint16_t seq, uint32_t time, const uint8_t *p, unsigned length)
+{
+    unsigned i;
+    uint32_t v;
+    float f;
+
+    if (!haveDesc)
+    {
+        beforeDesc++;
+        return;
+    }
+    if (length != desc.length)
+    {
+        badLength++;
+        return;
+    }
+
+    fprintf(out, "%u,%u", seq, time);
+
+    for (i = 0; i < desc.count; i++)
+    {
+        switch (desc.type[i])
+        {
+        case TM_U8:    fprintf(out, ",%u", p[0]); break;
+        case TM_I8:    fprintf(out, ",%d", (int8_t)p[0]); break;
+        case TM_U16:   fprintf(out, ",%u", get16(p)); break;
+        case TM_I16:   fprintf(out, ",%d", (int16_t)get16(p)); break;
+        case TM_U32:   fprintf(out, ",%u", get32(p)); break;
+        case TM_I32:   fprintf(out, ",%d", (int32_t)get32(p)); break;
+        case TM_FLOAT:
+            v = get32(p);
+            memcpy(&f, &v, sizeof(f));
+            fprintf(out, ",%g", f);
+            break;
+        default:
+            break;
+        }
+        p += typeSize[desc.type[i]];
+    }
+
+    fprintf(out, "\n");
+    dataFrames++;
+}
+
+static void decode_frame(const uint8_t *frame)
+{
+    uint8_t type = frame[2];
+    unsigned length = frame[3];
+    uint16_t seq = get16(&frame[4]);
+    uint32_t time = get32(&frame[6]);
+
+    frames++;
+
+    if (haveSeq)
+        lost += (uint16_t)(seq - lastSeq - 1);
+    haveSeq = true;
+    lastSeq = seq;
+
+    if (type == TM_FRAME_DESCRIPTOR)
+    {
+        descFrames++;
+        decode_descriptor(frame + TM_HEADER_SIZE, length);
+    }
+    else if (type == TM_FRAME_DATA)
+        decode_data(seq, time, frame + TM_HEADER_SIZE, length);
+}
+
+/*
+ * Decode the complete frames at the start of buf, return the bytes used.
+ * At the end of the input whatever cannot be a frame is skipped as well.
+ */
+static size_t decode(const uint8_t *buf, size_t len, bool eof)
+{
+    size_t i = 0;
+    unsigned total;
+
+    while (len - i >= 2)
+    {
+        if (buf[i] != TM_SYNC1 || buf[i + 1] != TM_SYNC2)
+        {
+            junk++;
+            i++;
+            continue;
+        }
+
+        if (len - i < TM_HEADER_SIZE)
+            break;
+
+        total = TM_HEADER_SIZE + buf[i + 3] + TM_CHECK_SIZE;
+        if (len - i < total)
+            break;
+
+        if (!check_ok(buf + i, total - TM_CHECK_SIZE))
+        {
+            /* Not a frame after all, or a corrupted one.  Resync one byte on. */
+            badCheck++;
+            i++;
+            continue;
+        }
+
+        decode_frame(buf + i);
+        i += total;
+    }
+
+    if (eof)
+    {
+        junk += len - i;
+        i = len;
+    }
+
+    return i;
+}
+
+int main(int argc, char *argv[])
+{
+    static uint8_t buf[16 * FRAME_MAX];
+    const char *csv = NULL;
+    bool quiet = false;
+    size_t len = 0, used, n;
+    FILE *in = stdin;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "o:qh")) != -1)
+    {
+        switch (opt)
+        {
+        case 'o': csv = optarg; break;
+        case 'q': quiet = true; break;
+        default:  usage(argv[0]);
+        }
+    }
+
+    if (optind + 1 < argc)
+        usage(argv[0]);
+
+    if (optind < argc && !(in = fopen(argv[optind], "rb")))
+    {
+        perror(argv[optind]);
+        return 1;
+    }
+
+    out = stdout;
+    if (csv && !(out = fopen(csv, "w")))
+    {
+        perror(csv);
+        return 1;
+    }
+
+    do
+    {
+        n = fread(buf + len, 1, sizeof(buf) - len, in);
+        len += n;
+
+        used = decode(buf, len, n == 0);
+        memmove(buf, buf + used, len - used);
+        len -= used;
+    } while (n > 0);
+
+    if (!quiet)
+    {
+        fprintf(stderr, "frames %lu: %lu data, %lu descriptor\n", frames, dataFrames, descFrames);
+        fprintf(stderr, "lost %lu (sequence gaps), bad checksum %lu, bad length %lu\n",
+                lost, badCheck, badLength);
+        fprintf(stderr, "skipped %lu data frames before the first descriptor, %lu bytes between frames\n",
+                beforeDesc, junk);
+    }
+
+    if (out != stdout)
+        fclose(out);
+
+    return ferror(in) ? 1 : 0;
+}
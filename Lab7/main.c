@@ -32,7 +32,6 @@ uint8_t bump_data5;
 
 int tick=0;
 
-int mytime[20];
 int i=0;
 
 typedef enum
@@ -338,10 +337,10 @@ void Initialize_System()
     MAP_SysCtl_enableSRAMBankRetention(SYSCTL_SRAM_BANK1);
 
     /*
-     * Configuring SysTick to trigger at .001 sec (MCLK is 48Mhz)
+     * Configuring SysTick to trigger at .001 sec, from MCLK (48Mhz)
      */
     MAP_SysTick_enableModule();
-    MAP_SysTick_setPeriod(48000);
+    MAP_SysTick_setPeriod(Clock_GetMCLK() / 1000);
     MAP_SysTick_enableInterrupt();
 
     MAP_Interrupt_enableMaster();
@@ -104,6 +104,13 @@ extern void PORT4_IRQHandler    (void) __attribute__((weak,alias("Default_Handle
 extern void PORT5_IRQHandler    (void) __attribute__((weak,alias("Default_Handler")));
 extern void PORT6_IRQHandler    (void) __attribute__((weak,alias("Default_Handler")));
 
+#ifdef ISR_PROFILE
+/* Profiling wrappers from Library/IsrProfile.c, they call the handlers above */
+extern void SysTick_ProfiledHandler  (void);
+extern void PORT1_ProfiledIRQHandler (void);
+extern void PORT5_ProfiledIRQHandler (void);
+#endif
+
 /* Interrupt vector table.  Note that the proper constructs must be placed on this to */
 /* ensure that it ends up at physical address 0x0000.0000 or at the start of          */
 /* the program if located at a start address other than 0.                            */
@@ -127,7 +134,11 @@ void (* const interruptVectors[])(void) =
     DebugMon_Handler,                      /* Debug monitor handler     */
     0,                                     /* Reserved                  */
     PendSV_Handler,                        /* The PendSV handler        */
+#ifdef ISR_PROFILE
+    SysTick_ProfiledHandler,               /* The SysTick handler       */
+#else
     SysTick_Handler,                       /* The SysTick handler       */
+#endif
     PSS_IRQHandler,                        /* PSS Interrupt             */
     CS_IRQHandler,                         /* CS Interrupt              */
     PCM_IRQHandler,                        /* PCM Interrupt             */
@@ -163,11 +174,19 @@ void (* const interruptVectors[])(void) =
     DMA_INT2_IRQHandler,                   /* DMA_INT2 Interrupt        */
     DMA_INT1_IRQHandler,                   /* DMA_INT1 Interrupt        */
     DMA_INT0_IRQHandler,                   /* DMA_INT0 Interrupt        */
+#ifdef ISR_PROFILE
+    PORT1_ProfiledIRQHandler,              /* Port1 Interrupt           */
+#else
     PORT1_IRQHandler,                      /* Port1 Interrupt           */
+#endif
     PORT2_IRQHandler,                      /* Port2 Interrupt           */
     PORT3_IRQHandler,                      /* Port3 Interrupt           */
     PORT4_IRQHandler,                      /* Port4 Interrupt           */
+#ifdef ISR_PROFILE
+    PORT5_ProfiledIRQHandler,              /* Port5 Interrupt           */
+#else
     PORT5_IRQHandler,                      /* Port5 Interrupt           */
+#endif
     PORT6_IRQHandler                       /* Port6 Interrupt           */
 };
 
@@ -7,20 +7,51 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <stdio.h>
+#include <stdlib.h>
 
 #include <ti/devices/msp432p4xx/driverlib/driverlib.h>
 
 #include "Library/Clock.h"
+#include "Library/RamFunc.h"
 #include "Library/Bump.h"
 #include "Library/Motor.h"
 #include "Library/Encoder.h"
 #include "Library/Button.h"
+#include "Library/StateMachine.h"
+#include "Library/LoopTiming.h"
+#include "Library/IsrProfile.h"
+#include "Library/Telemetry.h"
+#include "Library/FlightLog.h"
+#include "Library/PowerManager.h"
+#include "Library/Boot.h"
+#include "Library/Supervisor.h"
+#include "Library/FaultDump.h"
+#include "Library/StackMonitor.h"
+#include "Library/WheelMonitor.h"
+#include "Library/MotorModel.h"
+#include "Library/PidTune.h"
+#include "Library/Calibration.h"
 
 #include "Library/HAL_I2C.h"
 #include "Library/HAL_OPT3001.h"
 
+#ifdef BENCHMARK
+#include "Library/Reflectance.h"
+#include "Library/Benchmark.h"
+#endif
+
 #define TURN_TARGET_TICKS 150
 #define DRIVE_TARGET_TICKS 500
+#define PID_SPEED_FACTOR 0.25     // rotate_motors_by_counts_pid() speed factor the PI gains are tuned for
+#define MOVE_SPEED 65            // counts/s each wheel starts a move at, about what a duty of .1 gives
+
+#define LOOP_PERIOD_US 10000    // Clock_Delay1ms(10) at the end of the loop
+#define LOOP_BUDGET_US 1000     // work allowed per iteration before the delay
+#define LOOP_DEADLINE_MS 100    // longest the main loop may go without checking in with the supervisor
+
+#define TELEMETRY_RATE_HZ 200   // frames per second on the backchannel UART
+#define FL_ENCODER_PERIOD 20    // loop iterations between encoder snapshots in the flight log
+#define POWER_USE_DCDC false    // idle on the DC-DC regulator, as __REGULATOR in system_msp432p401r.c
 
 
 void Initialize_System();
@@ -35,9 +66,49 @@ uint8_t bump_data5;
 
 int tick=0;
 
-int mytime[20];
 int i=0;
 
+/*
+ * Timed sections of the main loop, see loop_timing in the Expressions view
+ */
+typedef enum
+{
+    LT_BUMP = 0,
+    LT_LIGHT,
+    LT_EVENTS,
+    LT_STATE_MACHINE,
+    NUM_LT_SECTIONS
+} loop_section_t;
+
+const char *const loop_section_names[NUM_LT_SECTIONS] =
+{
+    "bump",
+    "light",
+    "events",
+    "state machine",
+};
+
+/*
+ * Start-up stages, see boot_report in the Expressions view.  The crystal
+ * starts while the peripherals are initialized.
+ */
+typedef enum
+{
+    BOOT_VCORE = 0,
+    BOOT_PERIPHERALS,
+    BOOT_CRYSTAL,
+    BOOT_SENSORS,
+    NUM_BOOT_STAGES
+} boot_stage_id_t;
+
+const char *const boot_stage_names[NUM_BOOT_STAGES] =
+{
+    "VCORE1",
+    "peripherals",
+    "crystal",
+    "sensors",
+};
+
 /* Variable for storing lux value returned from OPT3001 */
 float lux;
 
@@ -45,284 +116,636 @@ typedef enum
 {
     START = 0,
     WAIT,
-    SETUP_DRIVEFORWARD,
     DRIVEFORWARD,
-    STOP_DRIVE1,
-    SETUP_TURNLEFT,
     TURNLEFT,
-    SETUP_TURN1,
     TURN1,
-    STOP_TURN1,
-    SETUP_BUMPEDOUTSIDE,
-    BUMPEDOUTSIDE,
-    SETUP_BUMPEDOUTSIDE2,
-    BUMPEDOUTSIDE2,
-    SETUP_BUMPEDINSIDE,
-    BUMPEDINSIDE,
-    SETUP_BUMPEDMIDDLE,
-    BUMPEDMIDDLE,
-    SETUP_BACKWARDS,
     BACKWARDS,
-    ALL_DONE
+    ALL_DONE,
+    NUM_STATES
 } my_state_t;
 
-my_state_t state = START;
+typedef enum
+{
+    EV_GO = 0,          // button S1
+    EV_STOP,            // button S2, emergency stop
+    EV_BUMP0,           // bump switches, lowest numbered switch pressed wins
+    EV_BUMP1,
+    EV_BUMP2,
+    EV_BUMP3,
+    EV_BUMP4,
+    EV_BUMP5,
+    EV_DONE,            // current state has finished its move
+    EV_STALL,           // the wheels are driven but do not turn, see wheel_monitor
+    EV_WHEEL_FAULT      // an encoder does not count, or counts the wrong way
+} my_event_t;
+
+int left_encoder_zero_pos, right_encoder_zero_pos;
+int move_target;            // counts each wheel should travel, 0 if the move has no target
+bool left_done, right_done;
+
+//-----------------------------------
+//        State handlers
+//-----------------------------------
 
-int main(void)
+/*
+ * Zero the encoders, set the wheel directions and start both motors.
+ * Motors are only written here, once per transition.
+ */
+static void start_move(bool left_dir, bool right_dir, int target)
+{
+    left_encoder_zero_pos = get_left_motor_count();
+    right_encoder_zero_pos = get_right_motor_count();
+    move_target = target;
+
+    set_left_motor_direction(left_dir);
+    set_right_motor_direction(right_dir);
 
+    left_done = false;
+    right_done = false;
+
+    // The same speed from both wheels once the motors are calibrated
+    set_left_motor_pwm(motor_model_duty(MOTOR_LEFT, MOVE_SPEED, .1));
+    set_right_motor_pwm(motor_model_duty(MOTOR_RIGHT, MOVE_SPEED, .1));
+}
+
+/*
+ * Stop each motor the first time it reaches its target.
+ * Returns EV_DONE once both wheels are done, logging how far each has
+ * gone past the target.
+ */
+static sm_event_t finish_move(bool left_reached, bool right_reached)
 {
-    bool left_done, right_done;
+    if (left_reached && !left_done)
+    {
+        left_done = true;
+        set_left_motor_pwm(0);
+    }
 
-    int left_encoder_zero_pos, right_encoder_zero_pos;
+    if (right_reached && !right_done)
+    {
+        right_done = true;
+        set_right_motor_pwm(0);
+    }
 
-    Initialize_System();
+    if (!(left_done && right_done))
+        return SM_NO_EVENT;
+
+    flight_log_record(FL_MOVE_ERROR, 0, 0, 0,
+                      abs(get_left_motor_count() - left_encoder_zero_pos) - move_target,
+                      abs(get_right_motor_count() - right_encoder_zero_pos) - move_target);
 
+    return EV_DONE;
+}
+
+static void stop_motors(void)
+{
     set_left_motor_pwm(0);
     set_right_motor_pwm(0);
+}
 
-    while (1)
+static sm_event_t start_do(void)
+{
+    return EV_DONE;
+}
+
+static void driveforward_entry(void)
+{
+    start_move(true, true, 0);
+}
+
+static void turnleft_entry(void)
+{
+    start_move(false, true, TURN_TARGET_TICKS);
+}
+
+static sm_event_t turnleft_do(void)
+{
+    return finish_move((left_encoder_zero_pos - get_left_motor_count()) > TURN_TARGET_TICKS,
+                       (get_right_motor_count() - right_encoder_zero_pos) > TURN_TARGET_TICKS);
+}
+
+static void turn1_entry(void)
+{
+    start_move(true, false, TURN_TARGET_TICKS);
+}
+
+static sm_event_t turn1_do(void)
+{
+    return finish_move((get_left_motor_count() - left_encoder_zero_pos) > TURN_TARGET_TICKS,
+                       (right_encoder_zero_pos - get_right_motor_count()) > TURN_TARGET_TICKS);
+}
+
+static void backwards_entry(void)
+{
+    start_move(false, false, DRIVE_TARGET_TICKS);
+}
+
+static sm_event_t backwards_do(void)
+{
+    return finish_move((left_encoder_zero_pos - get_left_motor_count()) > DRIVE_TARGET_TICKS,
+                       (right_encoder_zero_pos - get_right_motor_count()) > DRIVE_TARGET_TICKS);
+}
+
+static sm_event_t all_done_do(void)
+{
+    return EV_DONE;
+}
+
+//-----------------------------------
+//        State and transition tables
+//-----------------------------------
+
+const sm_state_handlers_t mission_states[NUM_STATES] =
+{
+    //  entry               do              exit
+    {   NULL,               start_do,       NULL },     // START
+    {   stop_motors,        NULL,           NULL },     // WAIT
+    {   driveforward_entry, NULL,           NULL },     // DRIVEFORWARD
+    {   turnleft_entry,     turnleft_do,    NULL },     // TURNLEFT
+    {   turn1_entry,        turn1_do,       NULL },     // TURN1
+    {   backwards_entry,    backwards_do,   NULL },     // BACKWARDS
+    {   stop_motors,        all_done_do,    NULL },     // ALL_DONE
+};
+
+const sm_transition_t mission_transitions[] =
+{
+    //  from            event       to
+    {   SM_ANY_STATE,   EV_STOP,    ALL_DONE     },
+
+    // Pushing against something no bumper felt: back off it, or give up
+    {   DRIVEFORWARD,   EV_STALL,   BACKWARDS    },
+    {   SM_ANY_STATE,   EV_STALL,   ALL_DONE     },
+    {   SM_ANY_STATE,   EV_WHEEL_FAULT, ALL_DONE },
+
+    {   START,          EV_DONE,    WAIT         },
+    {   WAIT,           EV_GO,      DRIVEFORWARD },
+
+    {   DRIVEFORWARD,   EV_BUMP0,   TURNLEFT     },
+    {   DRIVEFORWARD,   EV_BUMP1,   TURNLEFT     },
+    {   DRIVEFORWARD,   EV_BUMP2,   BACKWARDS    },
+    {   DRIVEFORWARD,   EV_BUMP3,   WAIT         },
+    {   DRIVEFORWARD,   EV_BUMP4,   TURN1        },
+    {   DRIVEFORWARD,   EV_BUMP5,   TURNLEFT     },
+
+    {   TURNLEFT,       EV_DONE,    DRIVEFORWARD },
+    {   TURN1,          EV_DONE,    WAIT         },
+    {   BACKWARDS,      EV_DONE,    TURN1        },
+    {   ALL_DONE,       EV_DONE,    WAIT         },
+};
+
+state_machine_t mission;
+
+/*
+ * Log every transition.  A run ends when the robot comes to rest in WAIT,
+ * after a move or an emergency stop, which is when the log goes to flash.
+ *
+ * WAIT is also the idle phase: the clocks and the core voltage drop until
+ * S1 starts the next run.
+ */
+static void log_transition(sm_state_t from, sm_state_t to, sm_event_t event)
+{
+    flight_log_record(FL_TRANSITION, from, to, event, 0, 0);
+
+    if ((to == WAIT) && (from != START))
     {
-        // Read Bump data into a byte
-        // Lower six bits correspond to the six bump sensors
-        // put into individual variables so we can view it in GC
-        bump_data = Bump_Read();
-        bump_data0 = BUMP_SWITCH(bump_data,0);
-        bump_data1 = BUMP_SWITCH(bump_data,1);
-        bump_data2 = BUMP_SWITCH(bump_data,2);
-        bump_data3 = BUMP_SWITCH(bump_data,3);
-        bump_data4 = BUMP_SWITCH(bump_data,4);
-        bump_data5 = BUMP_SWITCH(bump_data,5);
+        flight_log_record(FL_STACK, 0, 0, 0, stack_high_water(), stack_monitor.size);
+        flight_log_flush((from == ALL_DONE) ? FL_FLUSH_STOP : FL_FLUSH_END_OF_RUN);
+    }
 
-        /* Obtain lux value from the OPT3001 light sensor */
-        lux = OPT3001_getLux();
+    if (to == WAIT)
+        power_set_mode(POWER_IDLE);
+    else if (from == WAIT)
+        power_set_mode(POWER_RUN);
+}
 
-        // Emergency stop switch S2
-        // Switch to state "STOP" if pressed
-        if (button_S2_pressed()) 
-        {
-            state = ALL_DONE;
-        }
+#ifdef BENCHMARK
+//-----------------------------------
+//        Benchmark cases
+//-----------------------------------
 
-        //-----------------------------------
-        //        Main State Machine
-        //-----------------------------------
-        switch (state) 
-        {
+uint8_t bench_light_data;
+int32_t bench_position;
+
+static void bench_bump_read(void)
+{
+    bump_data = Bump_Read();
+}
+
+static void bench_reflectance_read(void)
+{
+    bench_light_data = Reflectance_Read(1000);
+}
+
+/* Step through every sensor pattern so all branches are timed */
+static void bench_next_light_data(void)
+{
+    bench_light_data++;
+}
+
+static void bench_reflectance_position(void)
+{
+    bench_position = Reflectance_Position(bench_light_data);
+}
+
+static void bench_motor_pwm(void)
+{
+    set_left_motor_pwm(0);
+}
 
-        case START:
-                state = WAIT;
-        break;
+void PORT5_IRQHandler(void);
 
-        case WAIT:
-            if (button_S1_pressed()) 
-            {
-                state = SETUP_DRIVEFORWARD;
-            }
-        break;
+/* Fake a left encoder edge so the handler takes its counting path */
+static void bench_encoder_edge(void)
+{
+    P5->IFG |= GPIO_PIN2;
+}
 
+static void bench_port5_isr(void)
+{
+    PORT5_IRQHandler();
+}
 
-        case SETUP_DRIVEFORWARD:
-            left_encoder_zero_pos = get_left_motor_count();
-            right_encoder_zero_pos = get_right_motor_count();
+/* From the value cached by the conversion ready interrupt, or over I2C without it */
+static void bench_lux(void)
+{
+    lux = OPT3001_getLux();
+}
 
-            set_left_motor_direction(true);
-            set_right_motor_direction(true);
+/*
+ * The mission's states and transitions without its transition hook: the
+ * hook's power mode switch on entering WAIT would drop MCLK mid-suite
+ */
+static state_machine_t bench_mission;
 
-            state = DRIVEFORWARD;
-        break;
+static void bench_state_machine(void)
+{
+    sm_run(&bench_mission);
+}
 
-        case DRIVEFORWARD:
-            set_left_motor_direction(true);
-            set_right_motor_direction(true);
-            set_left_motor_pwm(.1);
-            set_right_motor_pwm(.1);
+/* On target, so the PI step runs with zero error and the motors stay off */
+static void bench_pid_setup(void)
+{
+    rotate_motors_by_counts_pid(INITIAL, 0.5, 0, 0);
+}
 
-            if (bump_data0 == 1)
-                state = BUMPEDOUTSIDE;
-            else
-            if (bump_data1 == 1)
-                state = SETUP_TURNLEFT;
-            else
+static void bench_pid_step(void)
+{
+    rotate_motors_by_counts_pid(CONTINUOUS, 0.5, 0, 0);
+}
 
-            if (bump_data2 == 1)
-                state = SETUP_BACKWARDS;
-            else
-            if (bump_data3 == 1)
-                state = SETUP_BUMPEDMIDDLE;
-            else
-            if (bump_data4 == 1)
-                state = SETUP_TURN1;
-            else
-            if (bump_data5 == 1)
-            state = BUMPEDOUTSIDE;
+void SysTick_Handler(void);
 
-        break;
+static void bench_systick_isr(void)
+{
+    SysTick_Handler();
+}
 
-        case SETUP_TURN1:
-            left_encoder_zero_pos = get_left_motor_count();
-            right_encoder_zero_pos = get_right_motor_count();
+const bench_case_t bench_cases[] =
+{
+    //  name                        setup                   run                         iterations
+    {   "Bump_Read",                NULL,                   bench_bump_read,            0   },
+    {   "Reflectance_Read(1000)",   NULL,                   bench_reflectance_read,     100 },
+    {   "Reflectance_Position",     bench_next_light_data,  bench_reflectance_position, 0   },
+    {   "set_left_motor_pwm",       NULL,                   bench_motor_pwm,            0   },
+    {   "PORT5_IRQHandler",         bench_encoder_edge,     bench_port5_isr,            0   },
+    {   "OPT3001_getLux (cached)",  NULL,                   bench_lux,                  0   },
+    {   "sm_run",                   NULL,                   bench_state_machine,        0   },
+    {   "rotate_motors_by_counts_pid", bench_pid_setup,     bench_pid_step,             0   },
+    {   "SysTick_Handler",          NULL,                   bench_systick_isr,          0   },
+};
+
+const bench_case_t bench_lux_i2c_case =
+    {   "OPT3001_getLux (I2C)",     NULL,                   bench_lux,                  100 };
 
-            set_left_motor_direction(true);
-            set_right_motor_direction(false);
+/*
+ * Time the library and one state machine pass, results are left in
+ * bench_results[].  Run with the robot on a stand, the wheels stay stopped.
+ *
+ * The suite runs twice, with the flash read buffers off (as SystemInit()
+ * leaves them) and on (as Clock_Init48MHz() sets them), and bench_results[]
+ * keeps the second run.  Build the Library and Lab9 with NO_RAMFUNC for the
+ * figures of the RAMFUNC code running from flash.
+ */
+static void run_benchmarks(void)
+{
+    uint8_t buffered;
 
-            left_done = false;
-            right_done = false;
+    Reflectance_Init();
 
-            // Start the motors here so we only have to start them once
-            set_left_motor_pwm(.1);
-            set_right_motor_pwm(.1);
+    for (buffered = 0; buffered < 2; buffered++)
+    {
+        Clock_SetFlashBuffering(buffered);
 
-            state = TURN1;
-        break;
+        sm_init(&bench_mission, mission_states, NUM_STATES,
+                mission_transitions, sizeof(mission_transitions) / sizeof(mission_transitions[0]),
+                START);
 
+        bench_init();
+        bench_run_all(bench_cases, sizeof(bench_cases) / sizeof(bench_cases[0]));
 
-        case TURN1:
-            left_done = (get_left_motor_count() - left_encoder_zero_pos) > TURN_TARGET_TICKS;
-            right_done = (get_right_motor_count() - right_encoder_zero_pos) < -TURN_TARGET_TICKS;
+        // Every call reads the sensor once the conversion ready interrupt is off.
+        // Samples run with interrupts masked so let queued transfers finish first.
+        OPT3001_disableConversionReadyInterrupt();
+        while (!I2C_isIdle());
+        bench_run(&bench_lux_i2c_case);
+        OPT3001_enableConversionReadyInterrupt();
 
-            if (left_done)
-            {
-                set_left_motor_pwm(0);
-            }
+        printf("flash read buffers %s\n", buffered ? "on" : "off");
+        bench_report();
+    }
 
-            if (right_done)
-            {
-                set_right_motor_pwm(0);
-            }
+    // printf is the deepest the boot goes, see the stack size of this build
+    printf("stack high-water %lu of %lu bytes\n",
+           (unsigned long)stack_high_water(), (unsigned long)stack_monitor.size);
+}
+#endif
 
-            if (left_done && right_done) {
-                state = SETUP_BUMPEDINSIDE;
-            }
-        break;
+/*
+ * Measure both motors, then tune the PI gains with the new model as the
+ * feed-forward, and keep both in flash for the next boots.  A failed
+ * measurement leaves the stored one.
+ */
+static void calibrate_motors(void)
+{
+    motor_model_t model;
+    pid_tune_t tune;
+    uint8_t side;
 
-        case SETUP_TURNLEFT:
-            left_encoder_zero_pos = get_left_motor_count();
-            right_encoder_zero_pos = get_right_motor_count();
+    if (motor_model_measure(&model))
+    {
+        calibration.motor = model;
+        motor_model_use(&calibration.motor);
 
-            set_left_motor_direction(true);
-            set_right_motor_direction(false);
+        for (side = 0; side < 2; side++)
+            flight_log_record(FL_MOTOR_MODEL, side,
+                              (model.wheel[side].tau_ms < 255) ? (uint8_t)model.wheel[side].tau_ms : 255, 0,
+                              (int32_t)(model.wheel[side].deadband * 1000), (int32_t)model.wheel[side].gain);
+    }
+    else
+        flight_log_record(FL_MOTOR_MODEL, 0xFF, 0, 0, 0, 0);
 
-            // Start the motors here so we only have to start them once
-            set_left_motor_pwm(.1);
-            set_right_motor_pwm(.1);
+    if (pid_tune_measure(PID_SPEED_FACTOR, &tune))
+    {
+        calibration.pid = tune;
+        pid_tune_use(&calibration.pid);
 
-            left_done = false;
-            right_done = false;
+        for (side = 0; side < 2; side++)
+            flight_log_record(FL_PID_TUNE, side, (tune.wheel[side].tu < 255) ? (uint8_t)tune.wheel[side].tu : 255, 0,
+                              (int32_t)(tune.wheel[side].ku * 1000), (int32_t)tune.wheel[side].amplitude);
+        flight_log_record(FL_PID_TUNE, 2, 0, 0, (int32_t)(tune.p * 1000), (int32_t)(tune.i * 1000000));
+    }
+    else
+        flight_log_record(FL_PID_TUNE, 0xFF, 0, 0, 0, 0);
 
-            state = TURNLEFT;
-         break;
+    if (model.valid || tune.valid)
+        cal_save();
+}
 
+/*
+ * Stop the motors and keep the flight log of the crash.  The registers are
+ * in fault_record by now, the device is reset after this.
+ */
+static void fault_stop(const fault_record_t *record)
+{
+    stop_motors();
+    flight_log_record(FL_FAULT, record->exception, 0, 0, record->pc, record->cfsr);
+    flight_log_record(FL_STACK, 0, 0, 0, stack_high_water(), stack_monitor.size);
+    flight_log_flush(FL_FLUSH_FAULT);
+}
 
-        case TURNLEFT:
-            left_done = (left_encoder_zero_pos - get_left_motor_count()) > TURN_TARGET_TICKS;
-            right_done = (right_encoder_zero_pos - get_right_motor_count()) < -TURN_TARGET_TICKS;
+/*
+ * A supervised task missed its deadline: stop the motors and keep the
+ * flight log, the supervisor then resets the device.
+ */
+static void watchdog_expired(uint8_t task, uint32_t late_ms)
+{
+    stop_motors();
+    flight_log_record(FL_WATCHDOG, task, 0, 0, late_ms, 0);
+    flight_log_flush(FL_FLUSH_WATCHDOG);
+}
 
-            if (left_done)
-            {
-                set_left_motor_pwm(0);
-            }
+int main(void)
 
-            if(right_done)
-            {
-                set_right_motor_pwm(0);
-            }
+{
+    uint8_t last_bump_data = 0x3F;     // no switch pressed
+    int last_left_count = 0;
+    int last_right_count = 0;
+    uint32_t iteration = 0;
+    uint8_t main_loop_task;
+    wheel_condition_t wheel_condition;
 
-            if (left_done && right_done) {
-                state = SETUP_DRIVEFORWARD;
-            }
-        break;
+    sup_init();
 
-        case ALL_DONE:
-            state = WAIT;
-        break;
+    fault_init(fault_stop);
 
-        case SETUP_BUMPEDOUTSIDE:
-            state  = WAIT;
-        break;
+    // Paint the stack for its high-water mark and fence off its bottom, a
+    // stack overflow is then a MemManage fault
+    stack_init(true);
 
-        case BUMPEDOUTSIDE:
-            state = SETUP_TURNLEFT;
-        break;
+    Initialize_System();
 
-        case SETUP_BUMPEDOUTSIDE2:
-             state  = WAIT;
-        break;
+    flight_log_init();
+    flight_log_record(FL_BOOT_REPORT, boot_report.clock, 0, 0, boot_report.ready_us, boot_report.crystal_us);
+    if (supervisor.watchdog_reset)
+        flight_log_record(FL_WATCHDOG, FL_WATCHDOG_RESET, 0, 0, 0, 0);
 
-        case BUMPEDOUTSIDE2:
-             state = SETUP_TURN1;
-        break;
+    power_init(POWER_USE_DCDC);
 
-        case SETUP_BUMPEDINSIDE:
-            state  = WAIT;
-        break;
+    set_left_motor_pwm(0);
+    set_right_motor_pwm(0);
 
-        case BUMPEDINSIDE:
-            state  = SETUP_BACKWARDS;
-        break;
+    sm_init(&mission, mission_states, NUM_STATES,
+            mission_transitions, sizeof(mission_transitions) / sizeof(mission_transitions[0]),
+            START);
+    sm_set_transition_hook(&mission, log_transition);
 
-        case SETUP_BUMPEDMIDDLE:
-             state = WAIT;
-        break;
+    // Per wheel dead band and gain, and the PI gains, from flash, see
+    // Library/MotorModel.h and Library/PidTune.h.  S1 held through reset
+    // measures them again.
+    if (cal_load())
+    {
+        motor_model_use(&calibration.motor);
+        pid_tune_use(&calibration.pid);
+    }
+    if (MAP_GPIO_getInputPinValue(GPIO_PORT_P1, GPIO_PIN1) == GPIO_INPUT_PIN_LOW)
+        calibrate_motors();
 
-        case BUMPEDMIDDLE:
-             state = WAIT;
-        break;
+    wheel_init();
 
-        case SETUP_BACKWARDS:
+#ifdef BENCHMARK
+    run_benchmarks();
+#endif
 
-                 left_encoder_zero_pos = get_left_motor_count();
-                 right_encoder_zero_pos = get_right_motor_count();
+    lt_init(loop_section_names, NUM_LT_SECTIONS, LOOP_PERIOD_US, LOOP_BUDGET_US);
 
-                 set_left_motor_direction(true);
-                 set_right_motor_direction(true);
+#ifdef ISR_PROFILE
+    isr_profile_init();
+#endif
 
-                 // Start the motors here so we only have to start them once
-                 set_left_motor_pwm(.1);
-                 set_right_motor_pwm(.1);
+    /*
+     * Stream these to the PC, decode a capture with Host/telemetry/tmdecode
+     */
+    telemetry_init(TELEMETRY_RATE_HZ);
 
-                 left_done = false;
-                 right_done = false;
+    // S2 held through reset: send the last flight log, see Host/flightlog/fldecode
+    // and the registers of the last crash, see Host/faultdump/faultdecode
+    if (MAP_GPIO_getInputPinValue(GPIO_PORT_P1, GPIO_PIN4) == GPIO_INPUT_PIN_LOW)
+    {
+        flight_log_dump();
+        fault_dump();
+    }
 
-                 state = BACKWARDS;
-        break;
+    telemetry_add_signal("tick", &tick, TM_I32);
+    telemetry_add_signal("bump", &bump_data, TM_U8);
+    telemetry_add_signal("lux", &lux, TM_FLOAT);
+    telemetry_add_signal("left_count", &left_motor_count, TM_I32);
+    telemetry_add_signal("right_count", &right_motor_count, TM_I32);
+    telemetry_add_signal("state", &mission.current, TM_U8);
+    telemetry_add_signal("loop_exec_us", &loop_timing.exec.last, TM_U32);
 
-        case BACKWARDS:
+    /*
+     * From here on a main loop that stops checking in stops the robot and
+     * resets it, see supervisor in the Expressions view
+     */
+    main_loop_task = sup_add_task("main loop", LOOP_DEADLINE_MS);
+    sup_start(watchdog_expired);
 
-            left_done = (left_encoder_zero_pos - get_left_motor_count()) > DRIVE_TARGET_TICKS;
-            right_done = (right_encoder_zero_pos - get_right_motor_count()) > DRIVE_TARGET_TICKS;
+    while (1)
+    {
+        lt_loop_start();
 
-            if (left_done)
-            {
-                set_left_motor_pwm(0);
-            }
+        // Read Bump data into a byte
+        // Lower six bits correspond to the six bump sensors
+        // put into individual variables so we can view it in GC
+        lt_section_start(LT_BUMP);
+        bump_data = Bump_Read();
+        bump_data0 = BUMP_SWITCH(bump_data,0);
+        bump_data1 = BUMP_SWITCH(bump_data,1);
+        bump_data2 = BUMP_SWITCH(bump_data,2);
+        bump_data3 = BUMP_SWITCH(bump_data,3);
+        bump_data4 = BUMP_SWITCH(bump_data,4);
+        bump_data5 = BUMP_SWITCH(bump_data,5);
+        lt_section_end(LT_BUMP);
+
+        // Flight log: bump switch changes and, while the wheels turn, encoder snapshots
+        if (bump_data != last_bump_data)
+            flight_log_record(FL_BUMP, ~bump_data & 0x3F, 0, 0, 0, 0);
+        last_bump_data = bump_data;
+
+        if (((++iteration % FL_ENCODER_PERIOD) == 0) &&
+            ((left_motor_count != last_left_count) || (right_motor_count != last_right_count)))
+        {
+            last_left_count = left_motor_count;
+            last_right_count = right_motor_count;
+            flight_log_record(FL_ENCODER, 0, 0, 0, last_left_count, last_right_count);
+        }
+
+        /*
+         * Obtain lux value from the OPT3001 light sensor.  The sensor is read
+         * once per conversion from its INT pin, this is just the cached value.
+         */
+        lt_section_start(LT_LIGHT);
+        OPT3001_service();
+        lux = OPT3001_getLuxFloat();
+        lt_section_end(LT_LIGHT);
+
+        //-----------------------------------
+        //        Events
+        //-----------------------------------
+
+        lt_section_start(LT_EVENTS);
+
+        // Emergency stop switch S2 takes priority over everything else
+        if (button_S2_pressed())
+        {
+            flight_log_record(FL_BUTTON, 2, 0, 0, 0, 0);
+            sm_dispatch(&mission, EV_STOP);
+        }
+        else if (button_S1_pressed())
+        {
+            flight_log_record(FL_BUTTON, 1, 0, 0, 0, 0);
+            sm_dispatch(&mission, EV_GO);
+        }
+
+        // Wheels that do not turn as driven, see wheel_monitor
+        wheel_condition = wheel_event();
+        if (wheel_condition != WHEEL_OK)
+        {
+            flight_log_record(FL_WHEEL, wheel_condition, wheel_monitor.sides, 0,
+                              wheel_monitor.rate[0], wheel_monitor.rate[1]);
+            if (wheel_condition == WHEEL_STALL)
+                sm_dispatch(&mission, EV_STALL);
+            else if (wheel_condition == WHEEL_ENCODER)
+                sm_dispatch(&mission, EV_WHEEL_FAULT);
+        }
+
+        if (bump_data0 == 1)
+            sm_dispatch(&mission, EV_BUMP0);
+        else if (bump_data1 == 1)
+            sm_dispatch(&mission, EV_BUMP1);
+        else if (bump_data2 == 1)
+            sm_dispatch(&mission, EV_BUMP2);
+        else if (bump_data3 == 1)
+            sm_dispatch(&mission, EV_BUMP3);
+        else if (bump_data4 == 1)
+            sm_dispatch(&mission, EV_BUMP4);
+        else if (bump_data5 == 1)
+            sm_dispatch(&mission, EV_BUMP5);
+
+        lt_section_end(LT_EVENTS);
+
+        //-----------------------------------
+        //        Main State Machine
+        //-----------------------------------
+        lt_section_start(LT_STATE_MACHINE);
+        sm_run(&mission);
+        lt_section_end(LT_STATE_MACHINE);
 
-            if (right_done)
-            {
-                set_right_motor_pwm(0);
-            }
+        lt_loop_end();
 
-            if (left_done && right_done) {
-                state = SETUP_TURN1;
-            }
-            break;
-        } // end of case
+        sup_checkin(main_loop_task);
 
+#ifdef ISR_PROFILE
+        // Interrupt and CPU load, see isr_profile in the Expressions view
+        isr_profile_update();
+        isr_profile_idle_start();
         Clock_Delay1ms(10);
+        isr_profile_idle_end();
+#else
+        Clock_Delay1ms(10);
+#endif
     }
 }
 
 
+/*
+ * Keep SysTick at 1 ms when MCLK changes
+ */
+static void systick_clock_changed(void)
+{
+    MAP_SysTick_setPeriod(Clock_GetMCLK() / 1000);
+}
+
+
 void Initialize_System()
 {
+    boot_start(boot_stage_names, NUM_BOOT_STAGES);
+
+    /* Halting the Watchdog */
+    MAP_WDT_A_holdTimer();
+
     /*
-     * Initialize main clock
+     * Start the 48 MHz crystal, it runs MCLK from Clock_Finish48MHz()
      *
      * SMCLK = 12Mhz
      */
-    Clock_Init48MHz();
+    Clock_Start48MHz();
+    boot_stage_end(BOOT_VCORE);
 
-    /* Halting the Watchdog */
-    MAP_WDT_A_holdTimer();
+    /*
+     * Nothing here needs the final clocks, the drivers that derive a rate
+     * from them are told about the switch by their clock change handlers
+     */
 
     /* Configuring GPIO LED1 as an output */
     MAP_GPIO_setAsOutputPin(GPIO_PORT_P1, GPIO_PIN0);
@@ -345,20 +768,33 @@ void Initialize_System()
     MAP_SysCtl_enableSRAMBankRetention(SYSCTL_SRAM_BANK1);
 
     /*
-     * Configuring SysTick to trigger at .001 sec (MCLK is 48Mhz)
+     * Configuring SysTick to trigger at .001 sec, from MCLK (48Mhz)
      */
     MAP_SysTick_enableModule();
-    MAP_SysTick_setPeriod(48000);
+    systick_clock_changed();
+    Clock_AddChangeHandler(systick_clock_changed);
     MAP_SysTick_enableInterrupt();
 
-    MAP_Interrupt_enableMaster();
-
     /* Initialize I2C communication */
     Init_I2C_GPIO();
     I2C_init();
+    boot_stage_end(BOOT_PERIPHERALS);
+
+    /*
+     * Wait for the crystal, or run from the 48 MHz DCO if it does not start.
+     * Either way the clocks are 48, 24 and 12 MHz, boot_report tells which.
+     */
+    Clock_Finish48MHz();
+    boot_stage_end(BOOT_CRYSTAL);
+
+    MAP_Interrupt_enableMaster();
 
     /* Initialize OPT3001 digital ambient light sensor */
     OPT3001_init();
+    OPT3001_enableConversionReadyInterrupt();
+    boot_stage_end(BOOT_SENSORS);
+
+    boot_ready();
 
     //__delay_cycles(100000);
 }
@@ -370,11 +806,14 @@ void Initialize_System()
  * Increment the tick counter "tick"
  * Blink the red led
  */
-void SysTick_Handler(void)
+RAMFUNC void SysTick_Handler(void)
 {
     tick++;
+    I2C_service();                  // time out stuck I2C transactions
+    telemetry_tick();               // start the next telemetry frame when due
+    flight_log_tick();              // flight log time stamps
+    power_tick();                   // time in each power mode
+    wheel_tick();                   // wheel stall, slip and encoder checks
+    sup_tick();                     // main loop deadline, watchdog
     // if ((tick%1000)==0) MAP_GPIO_toggleOutputOnPin(GPIO_PORT_P1, GPIO_PIN0);        // Toggle RED LED each time through loop
 }
-
-
-
@@ -40,7 +40,12 @@
 
 MEMORY
 {
-    MAIN       (RX) : origin = 0x00000000, length = 0x00040000
+    MAIN       (RX) : origin = 0x00000000, length = 0x0003D000
+    /* Sector 29 of bank 1 kept for the motor calibration, Calibration.h.    */
+    CALIBRATION (R) : origin = 0x0003D000, length = 0x00001000
+    /* Top two sectors of bank 1 kept for the flight log, see FlightLog.h.    */
+    /* Nothing is linked there, loading a program leaves it alone.           */
+    FLIGHT_LOG (R)  : origin = 0x0003E000, length = 0x00002000
     INFO       (RX) : origin = 0x00200000, length = 0x00004000
 #ifdef  __TI_COMPILER_VERSION__
 #if     __TI_COMPILER_VERSION__ >= 15009000
@@ -98,6 +103,8 @@ SECTIONS
     .data   :   > SRAM_DATA
     .bss    :   > SRAM_DATA
     .sysmem :   > SRAM_DATA
+    /* fault_record, see FaultDump.h: not zeroed at start-up, kept over a reset */
+    .TI.noinit  :   > SRAM_DATA
     .stack  :   > SRAM_DATA (HIGH)
 
 #ifdef  __TI_COMPILER_VERSION__
@@ -261,6 +261,11 @@ void SystemCoreClockUpdate(void)
  */
 void SystemInit(void)
 {
+    // Count cycles from here for the boot report (Library/Boot.h)
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
     // Enable FPU if used
     #if (__FPU_USED == 1)                                  // __FPU_USED is defined in core_cm4.h
     SCB->CPACR |= ((3UL << 10 * 2) |                       // Set CP10 Full Access
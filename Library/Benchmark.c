@@ -0,0 +1,156 @@
+/*
+ * Benchmark.c
+ *
+ * Cycle accurate micro-benchmarks using the DWT cycle counter.  See Benchmark.h.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include "msp.h"
+#include <ti/devices/msp432p4xx/driverlib/driverlib.h>
+#include "Benchmark.h"
+#include "Clock.h"
+
+bench_result_t bench_results[BENCH_MAX_CASES];
+uint8_t bench_num_results = 0;
+uint32_t bench_overhead = 0;
+
+static void bench_empty(void)
+{
+}
+
+/*
+ *  Time one call of c->run with interrupts masked.  Returns raw cycles.
+ */
+static uint32_t bench_sample(const bench_case_t *c)
+{
+    uint32_t start;
+    uint32_t cycles;
+    bool wasDisabled;
+
+    wasDisabled = MAP_Interrupt_disableMaster();
+
+    if (c->setup)
+        c->setup();
+
+    start = DWT->CYCCNT;
+    c->run();
+    cycles = DWT->CYCCNT - start;
+
+    if (!wasDisabled)
+        MAP_Interrupt_enableMaster();
+
+    return cycles;
+}
+
+/*
+ *  Start the DWT cycle counter and measure the cost of taking a sample.
+ *
+ *  CYCCNT keeps counting without a debugger attached once TRCENA is set.
+ */
+void bench_init(void)
+{
+    const bench_case_t empty = { "overhead", NULL, bench_empty, 0 };
+    uint32_t cycles;
+    uint32_t i;
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    bench_num_results = 0;
+    bench_overhead = 0xFFFFFFFF;
+
+    for (i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        cycles = bench_sample(&empty);
+        if (cycles < bench_overhead)
+            bench_overhead = cycles;
+    }
+}
+
+/*
+ *  Run one case and append its result to bench_results[].
+ *
+ *  Returns the result, or NULL if the results table is full.
+ */
+const bench_result_t *bench_run(const bench_case_t *c)
+{
+    bench_result_t *r;
+    uint32_t iterations;
+    uint32_t cycles;
+    uint32_t i;
+
+    if (bench_num_results >= BENCH_MAX_CASES)
+        return NULL;
+
+    iterations = c->iterations ? c->iterations : BENCH_ITERATIONS;
+
+    r = &bench_results[bench_num_results++];
+    r->name = c->name;
+    r->iterations = iterations;
+    r->min = 0xFFFFFFFF;
+    r->max = 0;
+    r->total = 0;
+
+    for (i = 0; i < iterations; i++)
+    {
+        cycles = bench_sample(c);
+        cycles = (cycles > bench_overhead) ? (cycles - bench_overhead) : 0;
+
+        if (cycles < r->min)
+            r->min = cycles;
+        if (cycles > r->max)
+            r->max = cycles;
+        r->total += cycles;
+    }
+
+    r->avg = (uint32_t)(r->total / iterations);
+
+    return r;
+}
+
+/*
+ *  Run every case of a table in order.
+ */
+void bench_run_all(const bench_case_t *cases, uint8_t num_cases)
+{
+    uint8_t i;
+
+    for (i = 0; i < num_cases; i++)
+        bench_run(&cases[i]);
+}
+
+/*
+ *  Print the results table, in cycles and microseconds at the current MCLK.
+ *
+ *  On the LaunchPad printf goes to the CCS console and halts the CPU while it
+ *  prints, so call this after the last case has run.  The microseconds are
+ *  printed as fixed point, a float conversion takes the RTS printf more stack.
+ */
+void bench_report(void)
+{
+    uint32_t mhz = Clock_GetMCLK() / 1000000;
+    const bench_result_t *r;
+    uint32_t hundredths;
+    uint8_t i;
+
+    if (mhz == 0)
+        mhz = 1;
+
+    printf("%-28s %8s %8s %8s %8s %10s\n", "case", "calls", "min", "avg", "max", "avg us");
+
+    for (i = 0; i < bench_num_results; i++)
+    {
+        r = &bench_results[i];
+        hundredths = (uint32_t)(((uint64_t)r->avg * 100) / mhz);
+        printf("%-28s %8lu %8lu %8lu %8lu %7lu.%02lu\n", r->name,
+               (unsigned long)r->iterations, (unsigned long)r->min,
+               (unsigned long)r->avg, (unsigned long)r->max,
+               (unsigned long)(hundredths / 100), (unsigned long)(hundredths % 100));
+    }
+
+    printf("(cycles at MCLK %lu MHz, %lu cycle measurement overhead removed)\n",
+           (unsigned long)mhz, (unsigned long)bench_overhead);
+}
@@ -0,0 +1,54 @@
+/*
+ *  Benchmark.h
+ *
+ *  Cycle accurate micro-benchmarks using the DWT cycle counter.
+ *
+ *  A benchmark is described by a const table of cases.  Every case is run
+ *  many times with interrupts masked and the MCLK cycles taken by each call
+ *  are counted with DWT->CYCCNT.  The minimum, average and maximum of every
+ *  case are kept in the RAM table bench_results[] so they can be read in the
+ *  debugger's Expressions view, and bench_report() prints the table.
+ *
+ *  The cost of the measurement itself (two CYCCNT reads and the call through
+ *  the table) is measured on an empty case by bench_init() and subtracted.
+ *
+ *  Build the Benchmark configuration (defines BENCHMARK) to run the suite in
+ *  main.c at boot.
+ */
+#ifndef BENCHMARK_H_
+#define BENCHMARK_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define BENCH_MAX_CASES     16      // size of the results table
+#define BENCH_ITERATIONS    1000    // default number of timed calls per case
+
+typedef struct
+{
+    const char *name;
+    void (*setup)(void);        // called before every timed call, not timed, may be NULL
+    void (*run)(void);          // code being timed
+    uint32_t iterations;        // 0 selects BENCH_ITERATIONS
+} bench_case_t;
+
+typedef struct
+{
+    const char *name;
+    uint32_t iterations;
+    uint32_t min;               // cycles, measurement overhead removed
+    uint32_t avg;
+    uint32_t max;
+    uint64_t total;
+} bench_result_t;
+
+extern bench_result_t bench_results[BENCH_MAX_CASES];
+extern uint8_t bench_num_results;
+extern uint32_t bench_overhead;     // cycles subtracted from every sample
+
+void bench_init(void);
+const bench_result_t *bench_run(const bench_case_t *c);
+void bench_run_all(const bench_case_t *cases, uint8_t num_cases);
+void bench_report(void);
+
+#endif /* BENCHMARK_H_ */
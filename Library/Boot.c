@@ -0,0 +1,105 @@
+/*
+ * Boot.c
+ *
+ * Boot time and clock start-up report.  See Boot.h.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "msp.h"
+#include "Boot.h"
+#include "Clock.h"
+
+boot_report_t boot_report;
+
+static uint32_t mark;               // CYCCNT at the last rebase
+static uint32_t mark_us;            // time since reset at the last rebase
+static uint32_t stage_end_us;       // time since reset at the last stage end
+static uint32_t cycles_per_us = 3;  // 3 MHz DCO out of reset
+
+/*
+ *  Microseconds since reset, or since boot_start() if the C start-up code
+ *  did not run the cycle counter.
+ */
+uint32_t boot_time_us(void)
+{
+    return mark_us + (DWT->CYCCNT - mark) / cycles_per_us;
+}
+
+/*
+ *  Clock change handler: count the cycles so far at the old MCLK, the rest
+ *  at the new one
+ */
+static void boot_clock_changed(void)
+{
+    mark_us = boot_time_us();
+    mark = DWT->CYCCNT;
+
+    cycles_per_us = Clock_GetMCLK() / 1000000;
+    if (cycles_per_us == 0)
+        cycles_per_us = 1;
+}
+
+/*
+ *  Start timing the boot.  Stage names are not copied.
+ */
+void boot_start(const char *const *stage_names, uint8_t num_stages)
+{
+    uint8_t i;
+
+    if (num_stages > BOOT_MAX_STAGES)
+        num_stages = BOOT_MAX_STAGES;
+
+    mark = 0;
+    mark_us = 0;
+
+    // Started and zeroed by SystemInit(): the counter holds the start-up time
+    if (!(DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk))
+    {
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        DWT->CYCCNT = 0;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    }
+
+    boot_clock_changed();
+    Clock_AddChangeHandler(boot_clock_changed);
+
+    boot_report.startup_us = boot_time_us();
+    stage_end_us = boot_report.startup_us;
+
+    boot_report.num_stages = num_stages;
+    for (i = 0; i < num_stages; i++)
+    {
+        boot_report.stages[i].name = stage_names[i];
+        boot_report.stages[i].us = 0;
+    }
+
+    boot_report.ready_us = 0;
+    boot_report.crystal_us = 0;
+    boot_report.clock = Clock_GetStatus();
+    boot_report.ok = false;
+}
+
+/*
+ *  Mark the end of a stage, the stage started where the previous one ended.
+ */
+void boot_stage_end(uint8_t stage)
+{
+    uint32_t now = boot_time_us();
+
+    if (stage < boot_report.num_stages)
+        boot_report.stages[stage].us = now - stage_end_us;
+
+    stage_end_us = now;
+}
+
+/*
+ *  The program is ready to run: record the total and the clock result.
+ */
+void boot_ready(void)
+{
+    boot_report.ready_us = boot_time_us();
+    boot_report.clock = Clock_GetStatus();
+    boot_report.crystal_us = Clock_GetCrystalStartup();
+    boot_report.ok = (boot_report.clock == CLOCK_HFXT);
+}
@@ -0,0 +1,56 @@
+/*
+ *  Boot.h
+ *
+ *  Boot time and clock start-up report.
+ *
+ *  The program marks the end of each stage of its start-up, named like the
+ *  loop sections of LoopTiming.h, and finally the point where it is ready.
+ *  Times come from the DWT cycle counter and are converted at the MCLK each
+ *  stage ran at, so a stage that spans the switch to 48 MHz is still right.
+ *  The result is in boot_report for the debugger, and the flight log:
+ *
+ *    boot_report.startup_us     reset to boot_start(), the C start-up code.
+ *                               Only known if SystemInit() zeroed and started
+ *                               the cycle counter, as Lab9's does
+ *    boot_report.stages[]       each stage, in order
+ *    boot_report.ready_us       reset to boot_ready()
+ *    boot_report.crystal_us     HFXT enable to stable, 0 if it did not start
+ *    boot_report.clock          what Clock_Finish48MHz() ended up with
+ *    boot_report.ok             ready, on the crystal
+ *
+ *  Call boot_start() before Clock_Start48MHz().
+ */
+#ifndef BOOT_H_
+#define BOOT_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "Clock.h"
+
+#define BOOT_MAX_STAGES     8
+
+typedef struct
+{
+    const char *name;
+    uint32_t us;
+} boot_stage_t;
+
+typedef struct
+{
+    uint32_t startup_us;
+    boot_stage_t stages[BOOT_MAX_STAGES];
+    uint8_t num_stages;
+    uint32_t ready_us;
+    uint32_t crystal_us;
+    clock_status_t clock;
+    bool ok;
+} boot_report_t;
+
+extern boot_report_t boot_report;
+
+void boot_start(const char *const *stage_names, uint8_t num_stages);
+void boot_stage_end(uint8_t stage);
+void boot_ready(void);
+uint32_t boot_time_us(void);
+
+#endif /* BOOT_H_ */
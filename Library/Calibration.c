@@ -0,0 +1,82 @@
+/*
+ * Calibration.c
+ *
+ * Per robot calibration kept in MAIN flash.  See Calibration.h.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include "msp.h"
+#include <ti/devices/msp432p4xx/driverlib/driverlib.h>
+#include "Calibration.h"
+
+#if defined(__TI_COMPILER_VERSION__)
+#define calibration_flash   ((calibration_t *)CALIBRATION_ADDRESS)
+#else
+/* On the host the sector is RAM, erased and programmed by the simulated FlashCtl */
+static uint8_t calibration_sector[CALIBRATION_SIZE] __attribute__((aligned(CALIBRATION_SIZE)));
+#define calibration_flash   ((calibration_t *)calibration_sector)
+#endif
+
+calibration_t calibration;
+
+static uint32_t sum_words(const void *data, uint32_t bytes)
+{
+    const uint32_t *w = data;
+    uint32_t sum = 0;
+
+    for (; bytes >= 4; bytes -= 4)
+        sum += *w++;
+
+    return sum;
+}
+
+/*
+ *  Copy the stored calibration to calibration.  Returns false, leaving it
+ *  alone, if there is none or it is damaged.
+ */
+bool cal_load(void)
+{
+    const calibration_t *stored = calibration_flash;
+
+    if ((stored->magic != CALIBRATION_MAGIC) || (stored->size != sizeof(calibration_t)))
+        return false;
+
+    if (sum_words(stored, offsetof(calibration_t, check)) != stored->check)
+        return false;
+
+    memcpy(&calibration, stored, sizeof(calibration));
+
+    return true;
+}
+
+/*
+ *  Store calibration in flash.  Takes the sector erase time, about 10 ms
+ *  plus programming, with interrupts still running.
+ */
+bool cal_save(void)
+{
+    calibration_t *stored = calibration_flash;
+    bool ok;
+
+    calibration.magic = CALIBRATION_MAGIC;
+    calibration.size = sizeof(calibration_t);
+    calibration.check = sum_words(&calibration, offsetof(calibration_t, check));
+
+    MAP_FlashCtl_unprotectSector(FLASH_MAIN_MEMORY_SPACE_BANK1, FLASH_SECTOR29);
+
+    ok = MAP_FlashCtl_eraseSector((uintptr_t)stored);
+
+    // Everything after the magic, then the magic makes it valid
+    if (ok)
+        ok = MAP_FlashCtl_programMemory(&calibration.size, &stored->size,
+                                        sizeof(calibration) - offsetof(calibration_t, size));
+    if (ok)
+        ok = MAP_FlashCtl_programMemory(&calibration.magic, &stored->magic, sizeof(calibration.magic));
+
+    MAP_FlashCtl_protectSector(FLASH_MAIN_MEMORY_SPACE_BANK1, FLASH_SECTOR29);
+
+    return ok;
+}
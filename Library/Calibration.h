@@ -0,0 +1,45 @@
+/*
+ *  Calibration.h
+ *
+ *  Per robot calibration kept in MAIN flash.
+ *
+ *  Each robot's motors are measured once (MotorModel.h), and its PI gains
+ *  tuned (PidTune.h), and the results kept in sector 29 of bank 1, below
+ *  the flight log, which the linker command file keeps free.  cal_load() at
+ *  boot copies it to calibration if the stored record is intact; cal_save()
+ *  writes calibration back, erasing the sector and programming the magic
+ *  last so a reset part way through leaves no record rather than a bad one.
+ *  Loading a new program does not touch the sector as long as the
+ *  debugger's flash erase setting is "necessary segments only".  An erase of
+ *  all of MAIN takes the record with it: cal_load() then returns false and
+ *  the robot runs on the fixed PI gains without feed-forward until S1 is
+ *  held through a reset again.
+ */
+#ifndef CALIBRATION_H_
+#define CALIBRATION_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "MotorModel.h"
+#include "PidTune.h"
+
+#define CALIBRATION_ADDRESS     0x0003D000  // MAIN flash bank 1, sector 29
+#define CALIBRATION_SIZE        0x1000
+
+#define CALIBRATION_MAGIC       0x424C4143  // "CALB"
+
+typedef struct
+{
+    uint32_t magic;             // CALIBRATION_MAGIC, written last
+    uint32_t size;              // sizeof(calibration_t), a changed layout is not loaded
+    motor_model_t motor;
+    pid_tune_t pid;
+    uint32_t check;             // sum of the words before it
+} calibration_t;
+
+extern calibration_t calibration;
+
+bool cal_load(void);
+bool cal_save(void);
+
+#endif /* CALIBRATION_H_ */
@@ -0,0 +1,396 @@
+// Clock.c
+// Runs on the MSP432 
+// Daniel and Jonathan Valvano
+// February 23, 2017
+
+/* This example accompanies the books
+   "Embedded Systems: Introduction to the MSP432 Microcontroller",
+       ISBN: 978-1512185676, Jonathan Valvano, copyright (c) 2017
+   "Embedded Systems: Real-Time Interfacing to the MSP432 Microcontroller",
+       ISBN: 978-1514676585, Jonathan Valvano, copyright (c) 2017
+   "Embedded Systems: Real-Time Operating Systems for ARM Cortex-M Microcontrollers",
+       ISBN: 978-1466468863, , Jonathan Valvano, copyright (c) 2017
+ For more information about my classes, my research, and my books, see
+ http://users.ece.utexas.edu/~valvano/
+
+Simplified BSD License (FreeBSD License)
+Copyright (c) 2017, Jonathan Valvano, All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are
+those of the authors and should not be interpreted as representing official
+policies, either expressed or implied, of the FreeBSD Project.
+*/
+
+#include <stdint.h>
+#include "msp.h"
+#include "Clock.h"
+
+uint32_t ClockFrequency = 3000000; // cycles/second, MCLK
+//static uint32_t SubsystemFrequency = 3000000; // cycles/second
+
+// Clock tree: MCLK, HSMCLK and SMCLK all divide SourceFrequency, the DCO out
+// of reset or 48 MHz after Clock_Init48MHz(), from the crystal or, if it does
+// not start, from the DCO.  The dividers are kept as the shift counts of the
+// CS->CTL1 DIVM, DIVHS and DIVS fields.
+static uint32_t SourceFrequency = 3000000;
+static uint8_t MCLKShift = 0;
+static uint8_t HSMCLKShift = 0;
+static uint8_t SMCLKShift = 0;
+
+static clock_change_handler_t ChangeHandlers[CLOCK_MAX_HANDLERS];
+static uint8_t NumChangeHandlers = 0;
+
+static void CallChangeHandlers(void){
+  uint32_t i;
+  for(i = 0; i < NumChangeHandlers; i++){
+    ChangeHandlers[i]();
+  }
+}
+
+// ------------Clock_InitFastest------------
+// Configure the system clock to run at the fastest
+// and most accurate settings.  For example, if the
+// LaunchPad has a crystal, it should be used here.
+// Call BSP_Clock_GetFreq() to get the current system
+// clock frequency for the LaunchPad.
+// Input: none
+// Output: none
+uint32_t Prewait = 0;                   // us between Clock_Start48MHz() called and PCM idle (expect 0)
+uint32_t CPMwait = 0;                   // us between Power Active Mode Request and Current Power Mode matching requested mode (expect small)
+uint32_t Postwait = 0;                  // us between Current Power Mode matching requested mode and PCM module idle (expect about 0)
+uint32_t IFlags = 0;                    // non-zero if transition is invalid
+uint32_t Crystalstable = 0;             // us from HFXT enable to stable, 0 if it never was
+static clock_status_t ClockStatus = CLOCK_RESET;
+static uint32_t CrystalStart;           // CYCCNT when the HFXT was enabled
+
+// The waits are timed with the DWT cycle counter, still at the 3 MHz DCO
+static void CycleCounterOn(void){
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+static uint32_t ElapsedUs(uint32_t start){
+  return (DWT->CYCCNT - start)/(ClockFrequency/1000000);
+}
+
+// wait for the Power Control Manager to be idle, false on time out
+static bool PCMIdle(uint32_t *us){
+  uint32_t start = DWT->CYCCNT;
+  while(PCM->CTL1&0x00000100){
+    *us = ElapsedUs(start);
+    if(*us >= CLOCK_PCM_TIMEOUT_US){
+      return false;                     // time out error
+    }
+  }
+  return true;
+}
+
+// ------------Clock_Start48MHz------------
+// First half of Clock_Init48MHz(): raise the core to
+// VCORE1 and start the 48 MHz crystal, without waiting
+// for it.  Peripherals that do not depend on the
+// clocks can be initialized while it starts.
+// Input: none
+// Output: none
+void Clock_Start48MHz(void){
+  uint32_t start;
+  CycleCounterOn();
+  ClockStatus = CLOCK_VCORE_FAILED;     // until VCORE1 is reached
+  // wait for the PCMCTL0 and Clock System to be write-able by waiting for Power Control Manager to be idle
+  if(!PCMIdle(&Prewait)){
+    return;
+  }
+  // request power active mode LDO VCORE1 to support the 48 MHz frequency
+  PCM->CTL0 = (PCM->CTL0&~0xFFFF000F) |     // clear PCMKEY bit field and AMR bit field
+            0x695A0000 |                // write the proper PCM key to unlock write access
+            0x00000001;                 // request power active mode LDO VCORE1
+  // check if the transition is invalid (see Figure 7-3 on p344 of datasheet)
+  if(PCM->IFG&0x00000004){
+    IFlags = PCM->IFG;                    // bit 2 set on active mode transition invalid; bits 1-0 are for LPM-related errors; bit 6 is for DC-DC-related error
+    PCM->CLRIFG = 0x00000004;             // clear the transition invalid flag
+    // this works out of reset, but it WILL NOT work if Clock_Int32kHz() or Clock_InitLowPower() has been called
+    return;
+  }
+  // wait for the CPM (Current Power Mode) bit field to reflect a change to active mode LDO VCORE1
+  start = DWT->CYCCNT;
+  while((PCM->CTL0&0x00003F00) != 0x00000100){
+    CPMwait = ElapsedUs(start);
+    if(CPMwait >= CLOCK_PCM_TIMEOUT_US){
+      return;                           // time out error
+    }
+  }
+  // wait for the PCMCTL0 and Clock System to be write-able by waiting for Power Control Manager to be idle
+  if(!PCMIdle(&Postwait)){
+    return;
+  }
+  // initialize PJ.3 and PJ.2 and make them HFXT (PJ.3 built-in 48 MHz crystal out; PJ.2 built-in 48 MHz crystal in)
+  PJ->SEL0 |= 0x0C;
+  PJ->SEL1 &= ~0x0C;                    // configure built-in 48 MHz crystal for HFXT operation
+  CS->KEY = 0x695A;                     // unlock CS module for register access
+  CS->CTL2 = (CS->CTL2&~0x00700000) |   // clear HFXTFREQ bit field
+           0x00600000 |                 // configure for 48 MHz external crystal
+           0x00010000 |                 // HFXT oscillator drive selection for crystals >4 MHz
+           0x01000000;                  // enable HFXT
+  CS->CTL2 &= ~0x02000000;              // disable high-frequency crystal bypass
+  CS->KEY = 0;                          // lock CS module from unintended access
+  CrystalStart = DWT->CYCCNT;
+  ClockStatus = CLOCK_STARTING;
+}
+
+// ------------Clock_Finish48MHz------------
+// Second half of Clock_Init48MHz(): wait up to
+// CLOCK_HFXT_TIMEOUT_US from Clock_Start48MHz() for the
+// crystal, then run MCLK at 48 MHz, HSMCLK at 24 MHz and
+// SMCLK at 12 MHz from it.  If it does not start, the
+// same clocks come from the DCO at 48 MHz instead.  The
+// change handlers are called either way.
+// Input: none
+// Output: how the clocks ended up
+clock_status_t Clock_Finish48MHz(void){
+  uint32_t source;
+  if(ClockStatus != CLOCK_STARTING){
+    return ClockStatus;                 // no VCORE1, stay on the 3 MHz DCO
+  }
+  CS->KEY = 0x695A;                     // unlock CS module for register access
+  // wait for the HFXT clock to stabilize
+  while(CS->IFG&0x00000002){
+    CS->CLRIFG = 0x00000002;              // clear the HFXT oscillator interrupt flag
+    if(ElapsedUs(CrystalStart) >= CLOCK_HFXT_TIMEOUT_US){
+      break;                            // time out error
+    }
+  }
+  // configure for 2 wait states (minimum for 48 MHz operation) for flash Bank 0
+  FLCTL->BANK0_RDCTL = (FLCTL->BANK0_RDCTL&~0x0000F000)|FLCTL_BANK0_RDCTL_WAIT_2;
+  // configure for 2 wait states (minimum for 48 MHz operation) for flash Bank 1
+  FLCTL->BANK1_RDCTL = (FLCTL->BANK1_RDCTL&~0x0000F000)|FLCTL_BANK1_RDCTL_WAIT_2;
+  // SystemInit() leaves the flash read buffers off, with 2 wait states every
+  // fetch would stall, so turn on instruction and data buffering
+  Clock_SetFlashBuffering(true);
+  if(CS->IFG&0x00000002){
+    CS->CTL2 &= ~0x01000000;            // give up on the crystal, disable HFXT
+    CS->CTL0 = 0x00050000;              // DCO nominal 48 MHz (DCORSEL = 5)
+    source = 0x00000033;                // configure for MCLK, SMCLK and HSMCLK sourced from DCOCLK
+    ClockStatus = CLOCK_DCO_FALLBACK;
+  }else{
+    Crystalstable = ElapsedUs(CrystalStart);
+    source = 0x00000055;                // configure for MCLK, SMCLK and HSMCLK sourced from HFXTCLK
+    ClockStatus = CLOCK_HFXT;
+  }
+  CS->CTL1 = 0x20000000 |               // configure for SMCLK divider /4
+           0x00100000 |                 // configure for HSMCLK divider /2
+           0x00000200 |                 // configure for ACLK sourced from REFOCLK
+           source;
+  CS->KEY = 0;                          // lock CS module from unintended access
+  SourceFrequency = 48000000;
+  MCLKShift = 0;
+  HSMCLKShift = 1;
+  SMCLKShift = 2;
+  ClockFrequency = 48000000;
+//  SubsystemFrequency = 12000000;
+  CallChangeHandlers();
+  return ClockStatus;
+}
+
+void Clock_Init48MHz(void){
+  Clock_Start48MHz();
+  Clock_Finish48MHz();
+}
+
+// ------------Clock_GetStatus------------
+// Return how far Clock_Init48MHz() got.
+// Input: none
+// Output: CLOCK_HFXT when running from the crystal
+clock_status_t Clock_GetStatus(void){
+  return ClockStatus;
+}
+
+// ------------Clock_GetCrystalStartup------------
+// Return how long the crystal took to start.
+// Input: none
+// Output: us from HFXT enable to stable, 0 if it did not start
+uint32_t Clock_GetCrystalStartup(void){
+  return (ClockStatus == CLOCK_HFXT) ? Crystalstable : 0;
+}
+
+// ------------Clock_GetFreq------------
+// Return the current system clock frequency for the
+// LaunchPad.
+// Input: none
+// Output: system clock frequency in cycles/second
+uint32_t Clock_GetFreq(void){
+  return ClockFrequency;
+}
+
+uint32_t Clock_GetMCLK(void){
+  return ClockFrequency;
+}
+
+uint32_t Clock_GetHSMCLK(void){
+  return SourceFrequency>>HSMCLKShift;
+}
+
+uint32_t Clock_GetSMCLK(void){
+  return SourceFrequency>>SMCLKShift;
+}
+
+// flash wait states needed at VCORE1 for an MCLK frequency (datasheet table 5-3)
+static uint32_t FlashWaitStates(uint32_t mclk){
+  if(mclk > 32000000){
+    return 2;
+  }
+  if(mclk > 16000000){
+    return 1;
+  }
+  return 0;
+}
+
+static void SetFlashWaitStates(uint32_t waits){
+  FLCTL->BANK0_RDCTL = (FLCTL->BANK0_RDCTL&~0x0000F000)|(waits<<12);
+  FLCTL->BANK1_RDCTL = (FLCTL->BANK1_RDCTL&~0x0000F000)|(waits<<12);
+}
+
+// ------------Clock_SetFlashBuffering------------
+// Turn the flash read buffers of both banks on or off.
+// BUFI buffers instruction fetches, BUFD data reads
+// (constants), each a 128-bit line.
+// Input: enable, true to buffer
+// Output: none
+void Clock_SetFlashBuffering(bool enable){
+  if(enable){
+    FLCTL->BANK0_RDCTL |= (FLCTL_BANK0_RDCTL_BUFD|FLCTL_BANK0_RDCTL_BUFI);
+    FLCTL->BANK1_RDCTL |= (FLCTL_BANK1_RDCTL_BUFD|FLCTL_BANK1_RDCTL_BUFI);
+  }else{
+    FLCTL->BANK0_RDCTL &= ~(FLCTL_BANK0_RDCTL_BUFD|FLCTL_BANK0_RDCTL_BUFI);
+    FLCTL->BANK1_RDCTL &= ~(FLCTL_BANK1_RDCTL_BUFD|FLCTL_BANK1_RDCTL_BUFI);
+  }
+}
+
+// shift count for a power of two divider up to 128, or -1
+static int DividerShift(uint32_t div){
+  int shift;
+  for(shift = 0; shift <= 7; shift++){
+    if(div == (1u<<shift)){
+      return shift;
+    }
+  }
+  return -1;
+}
+
+// ------------Clock_SetDividers------------
+// Change the MCLK, HSMCLK and SMCLK dividers, keeping the
+// flash wait states safe on the way, then tell the drivers.
+// Inputs: mclkDiv, hsmclkDiv, smclkDiv, each 1, 2, 4, ... 128
+// Outputs: false if a divider is invalid
+bool Clock_SetDividers(uint32_t mclkDiv, uint32_t hsmclkDiv, uint32_t smclkDiv){
+  int m = DividerShift(mclkDiv);
+  int hs = DividerShift(hsmclkDiv);
+  int s = DividerShift(smclkDiv);
+  uint32_t mclk;
+  if((m < 0) || (hs < 0) || (s < 0)){
+    return false;
+  }
+  mclk = SourceFrequency>>m;
+  // more wait states before speeding up, fewer only after slowing down
+  if(FlashWaitStates(mclk) > FlashWaitStates(ClockFrequency)){
+    SetFlashWaitStates(FlashWaitStates(mclk));
+  }
+  CS->KEY = 0x695A;                     // unlock CS module for register access
+  CS->CTL1 = (CS->CTL1&~0x70770000) |   // clear DIVS, DIVHS and DIVM
+           ((uint32_t)s<<28) |
+           ((uint32_t)hs<<20) |
+           ((uint32_t)m<<16);
+  CS->KEY = 0;                          // lock CS module from unintended access
+  if(FlashWaitStates(mclk) < FlashWaitStates(ClockFrequency)){
+    SetFlashWaitStates(FlashWaitStates(mclk));
+  }
+  MCLKShift = m;
+  HSMCLKShift = hs;
+  SMCLKShift = s;
+  ClockFrequency = mclk;
+  CallChangeHandlers();
+  return true;
+}
+
+// ------------Clock_AddChangeHandler------------
+// Register a function called after every clock change.
+// Input: handler, function to call
+// Output: false if the table is full
+bool Clock_AddChangeHandler(clock_change_handler_t handler){
+  uint32_t i;
+  for(i = 0; i < NumChangeHandlers; i++){
+    if(ChangeHandlers[i] == handler){
+      return true;                      // already registered, init called twice
+    }
+  }
+  if(NumChangeHandlers >= CLOCK_MAX_HANDLERS){
+    return false;
+  }
+  ChangeHandlers[NumChangeHandlers] = handler;
+  NumChangeHandlers = NumChangeHandlers + 1;
+  return true;
+}
+
+
+// delay function
+// which delays about 6*ulCount cycles
+// ulCount=8000 => 1ms = (8000 loops)*(6 cycles/loop)*(20.83 ns/cycle)
+  //Code Composer Studio Code
+#ifdef __TI_COMPILER_VERSION__
+void delay(unsigned long ulCount){
+  __asm (  "pdloop:  subs    r0, #1\n"
+      "    bne    pdloop\n");
+}
+#else
+// Host build (Host/Makefile): spend the same number of cycles in simulated time
+void delay(unsigned long ulCount){
+  __delay_cycles((uint64_t)ulCount*9162/1000);
+}
+#endif
+
+// ------------Clock_Delay1us------------
+// Simple delay function which delays about n microseconds.
+// Inputs: n, number of us to wait
+// Outputs: none
+void Clock_Delay1us(uint32_t n){
+#ifdef __TI_COMPILER_VERSION__
+  n = (382*(ClockFrequency/1000000)*n)/4800; // 1 us, tuned at 48 MHz
+  while(n){
+    n--;
+  }
+#else
+  __delay_cycles((uint64_t)(ClockFrequency/1000000)*n);
+#endif
+}
+
+// ------------Clock_Delay1ms------------
+// Simple delay function which delays about n milliseconds.
+// Inputs: n, number of msec to wait
+// Outputs: none
+void Clock_Delay1ms(uint32_t n){
+  while(n){
+    delay(ClockFrequency/9162);   // 1 msec, tuned at 48 MHz
+    n--;
+  }
+}
+
+
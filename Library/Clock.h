@@ -0,0 +1,260 @@
+/**
+ * @file      Clock.h
+ * @brief     Provide functions that initialize the MSP432 clock module
+ * @details   Reconfigure MSP432 to run at 48 MHz
+ * @version   V1.0
+ * @author    Valvano
+ * @copyright Copyright 2017 by Jonathan W. Valvano, valvano@mail.utexas.edu,
+ * @warning   AS-IS
+ * @note      For more information see  http://users.ece.utexas.edu/~valvano/
+ * @date      March 14, 2017
+ ******************************************************************************/
+
+/* This example accompanies the books
+   "Embedded Systems: Introduction to the MSP432 Microcontroller",
+       ISBN: 978-1512185676, Jonathan Valvano, copyright (c) 2017
+   "Embedded Systems: Real-Time Interfacing to the MSP432 Microcontroller",
+       ISBN: 978-1514676585, Jonathan Valvano, copyright (c) 2017
+   "Embedded Systems: Real-Time Operating Systems for ARM Cortex-M Microcontrollers",
+       ISBN: 978-1466468863, , Jonathan Valvano, copyright (c) 2017
+ For more information about my classes, my research, and my books, see
+ http://users.ece.utexas.edu/~valvano/
+
+Simplified BSD License (FreeBSD License)
+Copyright (c) 2017, Jonathan Valvano, All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are
+those of the authors and should not be interpreted as representing official
+policies, either expressed or implied, of the FreeBSD Project.
+*/
+#ifndef CLOCK_H_
+#define CLOCK_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * Most clock change handlers Clock_AddChangeHandler() accepts
+ */
+#define CLOCK_MAX_HANDLERS 8
+
+/**
+ * Called after MCLK, HSMCLK or SMCLK has changed
+ */
+typedef void (*clock_change_handler_t)(void);
+
+/**
+ * Longest wait for the PCM to reach VCORE1, in us
+ */
+#define CLOCK_PCM_TIMEOUT_US 10000
+
+/**
+ * Longest time for the 48 MHz crystal to start, from Clock_Start48MHz(), in us
+ */
+#define CLOCK_HFXT_TIMEOUT_US 20000
+
+/**
+ * How far Clock_Init48MHz() got
+ */
+typedef enum {
+  CLOCK_RESET,          // 3 MHz DCO, Clock_Start48MHz() not called yet
+  CLOCK_STARTING,       // VCORE1, crystal starting, still on the 3 MHz DCO
+  CLOCK_HFXT,           // 48 MHz from the crystal
+  CLOCK_DCO_FALLBACK,   // the crystal did not start, 48 MHz from the DCO
+  CLOCK_VCORE_FAILED    // the PCM did not reach VCORE1, 3 MHz DCO
+} clock_status_t;
+
+/**
+ * Configure the MSP432 clock to run at 48 MHz
+ * @param none
+ * @return none
+ * @note  Since the crystal is used, the bus clock will be very accurate.
+ * Same as Clock_Start48MHz() followed by Clock_Finish48MHz(), if the
+ * crystal does not start MCLK runs at 48 MHz from the DCO.
+ * @see Clock_GetFreq(), Clock_GetStatus()
+ * @brief  Initialize clock to 48 MHz
+ */
+void Clock_Init48MHz(void);
+
+/**
+ * First half of Clock_Init48MHz(): raise the core to VCORE1 and start
+ * the 48 MHz crystal without waiting for it
+ * @param none
+ * @return none
+ * @note  The crystal takes a few ms to start.  Initialize whatever does
+ * not need the final clocks in the meantime, drivers that registered a
+ * change handler (Clock_AddChangeHandler()) are fixed up by
+ * Clock_Finish48MHz().  The waits are timed with the DWT cycle counter,
+ * which this turns on.
+ * @see Clock_Finish48MHz()
+ * @brief  Start the crystal
+ */
+void Clock_Start48MHz(void);
+
+/**
+ * Second half of Clock_Init48MHz(): wait for the crystal and switch
+ * MCLK, HSMCLK and SMCLK to it at 48, 24 and 12 MHz
+ * @param none
+ * @return CLOCK_HFXT, CLOCK_DCO_FALLBACK if the crystal has not started
+ * CLOCK_HFXT_TIMEOUT_US after Clock_Start48MHz() and the same clocks
+ * come from the DCO, or CLOCK_VCORE_FAILED if the core could not be
+ * raised to VCORE1 and the clocks stay at 3 MHz
+ * @note  The change handlers are called in every case but the last.
+ * The DCO is only about as accurate as its factory trim, a few percent.
+ * @see Clock_Start48MHz(), Clock_GetStatus()
+ * @brief  Switch to the crystal, or the DCO if it did not start
+ */
+clock_status_t Clock_Finish48MHz(void);
+
+/**
+ * Return how far Clock_Init48MHz() got
+ * @param none
+ * @return see Clock_Finish48MHz()
+ * @brief  Clock start-up result
+ */
+clock_status_t Clock_GetStatus(void);
+
+/**
+ * Return how long the crystal took to start
+ * @param none
+ * @return us from Clock_Start48MHz() enabling the HFXT to it running
+ * stable, 0 if it did not start
+ * @brief  Crystal start-up time
+ */
+uint32_t Clock_GetCrystalStartup(void);
+ 
+
+/**
+ * Return the current bus clock frequency
+ * @param none
+ * @return frequency of the system clock in Hz
+ * @note  3000000 out of reset, 48000000 after Clock_Init48MHz()
+ * unless Clock_SetDividers() divides MCLK down
+ * @see Clock_Init48MHz(), Clock_SetDividers()
+ * @brief Returns current clock bus frequency in Hz
+ */
+uint32_t Clock_GetFreq(void);
+
+
+/**
+ * Simple delay function which delays about n milliseconds.
+ * It is implemented with a nested for-loop and is very approximate.
+ * @param  n is the number of msec to wait
+ * @return none
+ * @note This function scales with MCLK, it is tuned at 48 MHz.
+ * This implementation is not very accurate.
+ * To improve accuracy, you could tune this function
+ * by adjusting the constant within the implementation
+ * found in the <b>Clock.c</b> file.
+ * For a more accurate time delay, you could use the SysTick module.
+ * @brief  Software implementation of a busy-wait delay
+ */
+void Clock_Delay1ms(uint32_t n);
+
+/**
+ * Simple delay function which delays about n microseconds.
+ * It is implemented with a nested for-loop and is very approximate.
+ * @param  n is the number of usec to wait
+ * @return none
+ * @note This function scales with MCLK, it is tuned at 48 MHz.
+ * This implementation is not very accurate.
+ * To improve accuracy, you could tune this function
+ * by adjusting the constant within the implementation
+ * found in the <b>Clock.c</b> file.
+ * For a more accurate time delay, you could use the SysTick module.
+ * @brief  Software implementation of a busy-wait delay
+ */
+void Clock_Delay1us(uint32_t n);
+
+/**
+ * Turn the flash read buffers (BUFI for instruction fetches, BUFD for
+ * data) of both banks on or off
+ * @param  enable true to buffer
+ * @return none
+ * @note  Clock_Init48MHz() turns them on.  Without them every flash
+ * fetch waits out the 2 wait states at 48 MHz.
+ * @brief  Flash read buffering on or off
+ */
+void Clock_SetFlashBuffering(bool enable);
+
+/**
+ * Return the frequency of MCLK, the CPU clock
+ * @param none
+ * @return MCLK in Hz
+ * @note  Same as Clock_GetFreq()
+ * @see Clock_Init48MHz(), Clock_SetDividers()
+ * @brief Returns MCLK in Hz
+ */
+uint32_t Clock_GetMCLK(void);
+
+/**
+ * Return the frequency of HSMCLK, the high speed subsystem clock
+ * @param none
+ * @return HSMCLK in Hz
+ * @see Clock_Init48MHz(), Clock_SetDividers()
+ * @brief Returns HSMCLK in Hz
+ */
+uint32_t Clock_GetHSMCLK(void);
+
+/**
+ * Return the frequency of SMCLK, the clock of Timer_A, the eUSCI
+ * UART and I2C modules and the ADC
+ * @param none
+ * @return SMCLK in Hz
+ * @note  12 MHz after Clock_Init48MHz()
+ * @see Clock_Init48MHz(), Clock_SetDividers()
+ * @brief Returns SMCLK in Hz
+ */
+uint32_t Clock_GetSMCLK(void);
+
+/**
+ * Divide the clock source down for MCLK, HSMCLK and SMCLK.  The flash
+ * wait states follow MCLK, then every handler registered with
+ * Clock_AddChangeHandler() is called so the peripherals can
+ * reprogram their dividers.
+ * @param  mclkDiv MCLK divider: 1, 2, 4, ... 128
+ * @param  hsmclkDiv HSMCLK divider: 1, 2, 4, ... 128
+ * @param  smclkDiv SMCLK divider: 1, 2, 4, ... 128
+ * @return false if a divider is not a power of two up to 128
+ * @note  Clock_Init48MHz() sets 1, 2 and 4 from the 48 MHz crystal.
+ * Call it from the main loop, with no interrupt handler depending on
+ * the clocks half way through a change.
+ * @see Clock_AddChangeHandler()
+ * @brief  Change the MCLK, HSMCLK and SMCLK dividers
+ */
+bool Clock_SetDividers(uint32_t mclkDiv, uint32_t hsmclkDiv, uint32_t smclkDiv);
+
+/**
+ * Register a function to be called after every clock change.  Drivers
+ * that derive a divider or baud rate from the clocks register one in
+ * their init function.
+ * @param  handler function to call
+ * @return false if CLOCK_MAX_HANDLERS are already registered
+ * @see Clock_SetDividers()
+ * @brief  Get told about clock changes
+ */
+bool Clock_AddChangeHandler(clock_change_handler_t handler);
+
+#endif /* CLOCK_H_ */
+
+
@@ -22,6 +22,7 @@
 #include "msp.h"
 #include <ti/devices/msp432p4xx/driverlib/driverlib.h>
 #include "Encoder.h"
+#include "RamFunc.h"
 
 // Initialize Encoder inputs
 
@@ -56,8 +57,8 @@ int get_right_motor_count() {
     return right_motor_count;
 }
 
-/* GPIO ISR */
-void PORT5_IRQHandler(void)
+/* GPIO ISR, runs from SRAM */
+RAMFUNC void PORT5_IRQHandler(void)
 {
     uint32_t status;
 
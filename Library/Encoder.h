@@ -0,0 +1,7 @@
+
+void encoder_init(void);
+int get_left_motor_count();
+int get_right_motor_count();
+
+extern int left_motor_count;     // updated by the PORT5 interrupt
+extern int right_motor_count;
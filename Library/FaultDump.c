@@ -0,0 +1,200 @@
+/*
+ * FaultDump.c
+ *
+ * Fault handlers that leave a post-mortem record.  See FaultDump.h.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "msp.h"
+#include <ti/devices/msp432p4xx/driverlib/driverlib.h>
+#include "FaultDump.h"
+
+#define FAULT_SRAM_START    0x20000000
+#define FAULT_SRAM_END      0x20010000
+
+#define FAULT_CFSR_STKERR       0x1010  // MSTKERR, STKERR: the frame was not written
+
+#define FAULT_FRAME_WORDS       8       // r0-r3, r12, LR, PC, xPSR
+#define FAULT_FP_FRAME_WORDS    26      // and s0-s15, FPSCR, a reserved word
+
+#ifdef __TI_COMPILER_VERSION__
+#pragma NOINIT(fault_record)
+#endif
+fault_record_t fault_record;
+
+static fault_hook_t fault_hook;
+
+#ifdef __TI_COMPILER_VERSION__
+/*
+ *  Pass the exception frame, on whichever stack the fault used, and
+ *  EXC_RETURN to fault_capture().  It has to be done before the compiler's
+ *  prologue moves the stack pointer, hence assembly.  The MPU goes off
+ *  first: after a stack overflow the stack pointer is in the guard region
+ *  (StackMonitor.h) and fault_capture() has to push there.
+ */
+__asm("        .sect \".text:fault_entry\"\n"
+      "        .thumb\n"
+      "        .global HardFault_Handler\n"
+      "        .global MemManage_Handler\n"
+      "        .global BusFault_Handler\n"
+      "        .global UsageFault_Handler\n"
+      "        .global fault_capture\n"
+      "        .thumbfunc HardFault_Handler\n"
+      "        .thumbfunc MemManage_Handler\n"
+      "        .thumbfunc BusFault_Handler\n"
+      "        .thumbfunc UsageFault_Handler\n"
+      "HardFault_Handler:\n"
+      "MemManage_Handler:\n"
+      "BusFault_Handler:\n"
+      "UsageFault_Handler:\n"
+      "        MOVW    R2, #0xED94\n"          // MPU->CTRL
+      "        MOVT    R2, #0xE000\n"
+      "        MOVS    R3, #0\n"
+      "        STR     R3, [R2]\n"
+      "        DSB\n"
+      "        ISB\n"
+      "        TST     LR, #4\n"
+      "        ITE     EQ\n"
+      "        MRSEQ   R0, MSP\n"
+      "        MRSNE   R0, PSP\n"
+      "        MOV     R1, LR\n"
+      "        B       fault_capture\n");
+#endif
+
+static uint32_t fault_sum(void)
+{
+    const uint32_t *p = (const uint32_t *)&fault_record;
+    uint32_t sum = 0;
+    uint32_t i;
+
+    for (i = 0; i < offsetof(fault_record_t, check) / 4; i++)
+        sum += p[i];
+
+    return sum;
+}
+
+/*
+ *  Whether words at p can be read without faulting again
+ */
+static bool fault_in_sram(const uint32_t *p, uint32_t words)
+{
+#ifdef __TI_COMPILER_VERSION__
+    return !((uint32_t)p & 3) &&
+           ((uint32_t)p >= FAULT_SRAM_START) &&
+           ((uint32_t)p + 4 * words <= FAULT_SRAM_END);
+#else
+    return p != NULL;               // host build: the caller's buffer
+#endif
+}
+
+/*
+ *  Enable the configurable fault handlers, so each fault type is caught
+ *  on its own, and trap integer division by zero instead of returning 0.
+ *  hook, which may be NULL, runs after the capture.
+ */
+void fault_init(fault_hook_t hook)
+{
+    fault_hook = hook;
+
+    SCB->CCR |= SCB_CCR_DIV_0_TRP_Msk;
+    SCB->SHCSR |= SCB_SHCSR_MEMFAULTENA_Msk | SCB_SHCSR_BUSFAULTENA_Msk | SCB_SHCSR_USGFAULTENA_Msk;
+}
+
+/*
+ *  Whether fault_record holds a fault from before the last reset
+ */
+bool fault_valid(void)
+{
+    return (fault_record.magic == FAULT_MAGIC) && (fault_record.check == fault_sum());
+}
+
+/*
+ *  Send a valid fault_record out of eUSCI_A0.  The UART must be set up
+ *  (telemetry_init()) and idle.
+ */
+void fault_dump(void)
+{
+    const uint8_t *p = (const uint8_t *)&fault_record;
+    uint32_t i;
+
+    if (!fault_valid())
+        return;
+
+    for (i = 0; i < sizeof(fault_record); i++)
+        MAP_UART_transmitData(EUSCI_A0_BASE, p[i]);
+}
+
+/*
+ *  Fill in fault_record, run the hook and reset.  Entered from the fault
+ *  handlers above with the exception frame and EXC_RETURN, does not return.
+ */
+void fault_capture(uint32_t *frame, uint32_t exc_return)
+{
+    uint32_t count = fault_valid() ? fault_record.count + 1 : 1;
+    uint32_t frame_words;
+    uint32_t *above = frame;
+    uint32_t i;
+
+    fault_record.magic = FAULT_MAGIC;
+    fault_record.count = count;
+    fault_record.exception = SCB->ICSR & SCB_ICSR_VECTACTIVE_Msk;
+    fault_record.exc_return = exc_return;
+    fault_record.cfsr = SCB->CFSR;
+    fault_record.hfsr = SCB->HFSR;
+    fault_record.mmfar = SCB->MMFAR;
+    fault_record.bfar = SCB->BFAR;
+
+    // Bit 4 of EXC_RETURN clear: the FPU registers were stacked as well
+    frame_words = (exc_return & 0x10) ? FAULT_FRAME_WORDS : FAULT_FP_FRAME_WORDS;
+    fault_record.flags = (exc_return & 0x10) ? 0 : FAULT_FLAG_FP_FRAME;
+    if (exc_return & 0x04)
+        fault_record.flags |= FAULT_FLAG_PSP;
+
+    fault_record.r0 = fault_record.r1 = fault_record.r2 = fault_record.r3 = 0;
+    fault_record.r12 = fault_record.lr = fault_record.pc = fault_record.xpsr = 0;
+    for (i = 0; i < FAULT_STACK_WORDS; i++)
+        fault_record.stack[i] = 0;
+
+    if (!fault_in_sram(frame, frame_words))
+    {
+        fault_record.flags |= FAULT_FLAG_BAD_SP;
+        fault_record.sp = (uint32_t)(uintptr_t)frame;
+    }
+    else if (fault_record.cfsr & FAULT_CFSR_STKERR)
+    {
+        // Nothing was written where the frame should be, but the stack
+        // above it shows what overflowed
+        fault_record.flags |= FAULT_FLAG_NO_FRAME;
+        above = frame + frame_words;
+        fault_record.sp = (uint32_t)(uintptr_t)above;
+    }
+    else
+    {
+        fault_record.r0 = frame[0];
+        fault_record.r1 = frame[1];
+        fault_record.r2 = frame[2];
+        fault_record.r3 = frame[3];
+        fault_record.r12 = frame[4];
+        fault_record.lr = frame[5];
+        fault_record.pc = frame[6];
+        fault_record.xpsr = frame[7];
+
+        // xPSR bit 9: a padding word was inserted to align the frame
+        above = frame + frame_words + ((frame[7] & 0x200) ? 1 : 0);
+        fault_record.sp = (uint32_t)(uintptr_t)above;
+    }
+
+    if (!(fault_record.flags & FAULT_FLAG_BAD_SP))
+        for (i = 0; (i < FAULT_STACK_WORDS) && fault_in_sram(above + i, 1); i++)
+            fault_record.stack[i] = above[i];
+
+    fault_record.check = fault_sum();
+
+    if (fault_hook)
+        fault_hook(&fault_record);
+
+    MAP_ResetCtl_initiateHardReset();
+    while (1);
+}
@@ -0,0 +1,76 @@
+/*
+ *  FaultDump.h
+ *
+ *  Fault handlers that leave a post-mortem record.
+ *
+ *  HardFault, MemManage, BusFault and UsageFault all end up in
+ *  fault_capture(), which copies the stacked registers (r0-r3, r12, LR, PC,
+ *  xPSR), the fault status and address registers (CFSR, HFSR, MMFAR, BFAR)
+ *  and the FAULT_STACK_WORDS words above the exception frame into
+ *  fault_record.  The record is in a NOINIT section, so the C start-up code
+ *  leaves it alone and it survives the reset that follows, though not a
+ *  power cycle.  Then the program's hook stops the motors and logs the
+ *  fault, and the device is reset.
+ *
+ *  fault_dump() sends a valid record out of the backchannel UART, and
+ *  Host/faultdump/faultdecode prints it with the PC, LR and the code
+ *  addresses on the stack named from the program's .map file.
+ *
+ *  fault_init() turns on the separate MemManage, BusFault and UsageFault
+ *  handlers and the divide by zero trap.  Calling it also links the handlers
+ *  in place of the start-up file's Default_Handler.
+ *
+ *  A stack that overflows into the StackMonitor.h guard faults while
+ *  pushing, usually the exception frame as well (MSTKERR): the registers
+ *  are then lost and FAULT_FLAG_NO_FRAME is set, but the stack above is
+ *  still recorded.
+ */
+#ifndef FAULTDUMP_H_
+#define FAULTDUMP_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define FAULT_MAGIC         0x544C4146  // "FALT"
+#define FAULT_STACK_WORDS   32
+
+// fault_record_t.flags
+#define FAULT_FLAG_FP_FRAME     0x01    // the frame includes the FPU registers
+#define FAULT_FLAG_PSP          0x02    // the fault happened on the process stack
+#define FAULT_FLAG_BAD_SP       0x04    // the stack pointer was outside SRAM, no frame
+#define FAULT_FLAG_NO_FRAME     0x08    // stacking the frame faulted, a stack overflow
+
+typedef struct
+{
+    uint32_t magic;
+    uint32_t count;             // faults since power-on
+    uint32_t exception;         // 3 HardFault, 4 MemManage, 5 BusFault, 6 UsageFault
+    uint32_t flags;
+    uint32_t r0, r1, r2, r3, r12;
+    uint32_t lr;                // stacked: where the faulting code returns to
+    uint32_t pc;                // stacked: the faulting instruction, or the one after
+    uint32_t xpsr;
+    uint32_t exc_return;        // LR in the handler
+    uint32_t sp;                // stack pointer before the exception
+    uint32_t cfsr;
+    uint32_t hfsr;
+    uint32_t mmfar;
+    uint32_t bfar;
+    uint32_t stack[FAULT_STACK_WORDS];
+    uint32_t check;             // sum of the words above
+} fault_record_t;
+
+/*
+ *  Called with the record filled in, before the reset.  Keep it simple: it
+ *  runs in the fault handler.
+ */
+typedef void (*fault_hook_t)(const fault_record_t *record);
+
+extern fault_record_t fault_record;
+
+void fault_init(fault_hook_t hook);
+bool fault_valid(void);
+void fault_dump(void);
+void fault_capture(uint32_t *frame, uint32_t exc_return);
+
+#endif /* FAULTDUMP_H_ */
@@ -0,0 +1,207 @@
+/*
+ * FlightLog.c
+ *
+ * Flight recorder, RAM ring flushed to MAIN flash.  See FlightLog.h.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "msp.h"
+#include <ti/devices/msp432p4xx/driverlib/driverlib.h>
+#include "FlightLog.h"
+#include "RamFunc.h"
+
+/*
+ * The header and entries fill a sector exactly, and the counts, stored and
+ * in the ring, are bytes.  With the 16 byte entries that leaves no count a
+ * slot cannot hold, so a stored count is not range checked.  These fail to
+ * compile if a layout change breaks that.
+ */
+typedef char flight_log_slot_fills_sector[(sizeof(flight_log_slot_t) == FLIGHT_LOG_SLOT_SIZE) ? 1 : -1];
+typedef char flight_log_count_fits_byte[(FLIGHT_LOG_ENTRIES <= UINT8_MAX) ? 1 : -1];
+
+#if defined(__TI_COMPILER_VERSION__)
+#define flight_log_flash    ((flight_log_slot_t *)FLIGHT_LOG_ADDRESS)
+#else
+/* On the host the region is RAM, erased and programmed by the simulated FlashCtl */
+static flight_log_slot_t flight_log_flash[FLIGHT_LOG_SLOTS] __attribute__((aligned(FLIGHT_LOG_SLOT_SIZE)));
+#endif
+
+static flight_log_entry_t ring[FLIGHT_LOG_ENTRIES];
+static uint8_t ring_next = 0;
+static uint8_t ring_count = 0;
+static uint32_t recorded = 0;
+static volatile uint32_t time_ms = 0;
+static bool flushing = false;
+
+static uint32_t sum_words(const void *data, uint32_t bytes)
+{
+    const uint32_t *w = data;
+    uint32_t sum = 0;
+
+    for (; bytes >= 4; bytes -= 4)
+        sum += *w++;
+
+    return sum;
+}
+
+/*
+ *  Return the newest slot in flash with a valid log, or NULL if there is none.
+ */
+const flight_log_slot_t *flight_log_stored(void)
+{
+    const flight_log_slot_t *slot;
+    const flight_log_slot_t *newest = NULL;
+    uint8_t i;
+
+    for (i = 0; i < FLIGHT_LOG_SLOTS; i++)
+    {
+        slot = &flight_log_flash[i];
+
+        if (slot->header.magic != FLIGHT_LOG_MAGIC)
+            continue;
+
+        if (sum_words(&slot->header, offsetof(flight_log_header_t, check)) +
+            sum_words(slot->entries, slot->header.count * sizeof(flight_log_entry_t)) != slot->header.check)
+            continue;
+
+        if (!newest || ((int16_t)(slot->header.sequence - newest->header.sequence) > 0))
+            newest = slot;
+    }
+
+    return newest;
+}
+
+/*
+ *  Start a new log in RAM.  The log in flash is kept until the next flush.
+ */
+void flight_log_init(void)
+{
+    const flight_log_slot_t *stored = flight_log_stored();
+
+    ring_next = 0;
+    ring_count = 0;
+    recorded = 0;
+
+    flight_log_record(FL_BOOT, 0, 0, 0, stored ? stored->header.sequence : 0, 0);
+}
+
+/*
+ *  Call every millisecond from SysTick_Handler.  Runs from SRAM.
+ */
+RAMFUNC void flight_log_tick(void)
+{
+    time_ms++;
+}
+
+/*
+ *  Add an event to the ring, overwriting the oldest once it is full.  Safe
+ *  to call from an interrupt handler.
+ */
+void flight_log_record(flight_log_event_t type, uint8_t p0, uint8_t p1, uint8_t p2, int32_t v0, int32_t v1)
+{
+    flight_log_entry_t *e;
+    bool wasDisabled;
+
+    wasDisabled = MAP_Interrupt_disableMaster();
+
+    e = &ring[ring_next];
+    e->time_ms = time_ms;
+    e->type = type;
+    e->p0 = p0;
+    e->p1 = p1;
+    e->p2 = p2;
+    e->v0 = v0;
+    e->v1 = v1;
+
+    ring_next = (ring_next + 1) % FLIGHT_LOG_ENTRIES;
+    if (ring_count < FLIGHT_LOG_ENTRIES)
+        ring_count++;
+    recorded++;
+
+    if (!wasDisabled)
+        MAP_Interrupt_enableMaster();
+}
+
+/*
+ *  Write the ring to the older flash slot.  Takes about 15 ms, mostly the
+ *  sector erase, so call it with the robot stopped.  The ring is kept, later
+ *  events are added to it and the next flush writes the lot again.
+ *  Returns false if the flash could not be written.
+ */
+bool flight_log_flush(flight_log_reason_t reason)
+{
+    const flight_log_slot_t *stored;
+    flight_log_slot_t *slot;
+    flight_log_header_t header;
+    uint8_t oldest;
+    uint8_t first;
+    bool ok;
+
+    if (flushing)
+        return false;
+
+    flight_log_record(FL_FLUSH, reason, 0, 0, 0, 0);
+    flushing = true;
+
+    stored = flight_log_stored();
+    slot = &flight_log_flash[stored ? ((stored - flight_log_flash) ^ 1) : 0];
+
+    oldest = (ring_next + FLIGHT_LOG_ENTRIES - ring_count) % FLIGHT_LOG_ENTRIES;
+    first = (ring_count < FLIGHT_LOG_ENTRIES - oldest) ? ring_count : (FLIGHT_LOG_ENTRIES - oldest);
+
+    header.magic = FLIGHT_LOG_MAGIC;
+    header.sequence = stored ? (stored->header.sequence + 1) : 1;
+    header.reason = reason;
+    header.count = ring_count;
+    header.recorded = recorded;
+    header.check = sum_words(&header, offsetof(flight_log_header_t, check)) +
+                   sum_words(&ring[oldest], first * sizeof(flight_log_entry_t)) +
+                   sum_words(&ring[0], (ring_count - first) * sizeof(flight_log_entry_t));
+
+    MAP_FlashCtl_unprotectSector(FLASH_MAIN_MEMORY_SPACE_BANK1, FLASH_SECTOR30 | FLASH_SECTOR31);
+
+    ok = MAP_FlashCtl_eraseSector((uintptr_t)slot);
+
+    // Entries oldest first, unwrapping the ring
+    if (ok && first)
+        ok = MAP_FlashCtl_programMemory(&ring[oldest], &slot->entries[0],
+                                        first * sizeof(flight_log_entry_t));
+    if (ok && (ring_count > first))
+        ok = MAP_FlashCtl_programMemory(&ring[0], &slot->entries[first],
+                                        (ring_count - first) * sizeof(flight_log_entry_t));
+
+    // The header, magic last, makes the slot valid
+    if (ok)
+        ok = MAP_FlashCtl_programMemory(&header.sequence, &slot->header.sequence,
+                                        sizeof(header) - offsetof(flight_log_header_t, sequence));
+    if (ok)
+        ok = MAP_FlashCtl_programMemory(&header.magic, &slot->header.magic, sizeof(header.magic));
+
+    MAP_FlashCtl_protectSector(FLASH_MAIN_MEMORY_SPACE_BANK1, FLASH_SECTOR30 | FLASH_SECTOR31);
+
+    flushing = false;
+
+    return ok;
+}
+
+/*
+ *  Send the newest log in flash, header and entries as they are stored, out
+ *  of eUSCI_A0.  The UART must be set up (telemetry_init()) and idle.
+ */
+void flight_log_dump(void)
+{
+    const flight_log_slot_t *slot = flight_log_stored();
+    const uint8_t *p = (const uint8_t *)slot;
+    uint32_t length;
+    uint32_t i;
+
+    if (!slot)
+        return;
+
+    length = sizeof(flight_log_header_t) + slot->header.count * sizeof(flight_log_entry_t);
+
+    for (i = 0; i < length; i++)
+        MAP_UART_transmitData(EUSCI_A0_BASE, p[i]);
+}
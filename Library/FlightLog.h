@@ -0,0 +1,98 @@
+/*
+ *  FlightLog.h
+ *
+ *  Flight recorder ("black box").
+ *
+ *  Events of a run (state transitions, bumps, buttons, encoder snapshots,
+ *  move errors, faults) are recorded with a millisecond time stamp into a
+ *  ring in RAM that keeps the last FLIGHT_LOG_ENTRIES of them.
+ *  flight_log_flush() copies the ring to the FLIGHT_LOG region at the top of
+ *  MAIN flash (see msp432p401r.cmd), where it survives a reset, a power cycle
+ *  and reprogramming as long as the debugger's flash erase setting is
+ *  "necessary segments only".
+ *
+ *  The region holds two slots of one 4 KB sector.  A flush erases and writes
+ *  the older slot, header last, so a flush cut short by a reset or a fault
+ *  still leaves the previous log readable.
+ *
+ *  flight_log_dump() sends the newest slot out of the backchannel UART.
+ *  Host/flightlog/fldecode prints a capture of it, or a raw read of the
+ *  region, as a time line.
+ */
+#ifndef FLIGHTLOG_H_
+#define FLIGHTLOG_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define FLIGHT_LOG_ADDRESS      0x0003E000  // MAIN flash bank 1, sectors 30 and 31
+#define FLIGHT_LOG_SLOT_SIZE    0x1000      // one sector per slot
+#define FLIGHT_LOG_SLOTS        2
+#define FLIGHT_LOG_ENTRIES      255         // header and entries fill a slot
+
+#define FLIGHT_LOG_MAGIC        0x474F4C46  // "FLOG"
+
+#define FL_WATCHDOG_RESET       0xFF        // FL_WATCHDOG p0: the watchdog itself reset the device
+
+typedef enum
+{
+    FL_BOOT = 1,
+    FL_TRANSITION,      // p0 from state, p1 to state, p2 event
+    FL_BUMP,            // p0 bump switches, bit n set while switch n is pressed
+    FL_BUTTON,          // p0 1 for S1, 2 for S2
+    FL_ENCODER,         // v0 left count, v1 right count
+    FL_MOVE_ERROR,      // v0 left, v1 right: counts travelled minus the target
+    FL_FAULT,           // p0 exception number, v0 PC, v1 CFSR (FaultDump.h)
+    FL_FLUSH,           // p0 flight_log_reason_t
+    FL_BOOT_REPORT,     // p0 clock_status_t, v0 reset to ready us, v1 crystal start-up us
+    FL_WATCHDOG,        // p0 late supervisor task or FL_WATCHDOG_RESET, v0 ms since its check-in
+    FL_STACK,           // v0 deepest stack use, v1 stack size, bytes (StackMonitor.h)
+    FL_WHEEL,           // p0 wheel_condition_t, p1 wheels, v0 left, v1 right counts/s (WheelMonitor.h)
+    FL_MOTOR_MODEL,     // p0 wheel (0xFF: failed), p1 tau ms, v0 dead band x 1000, v1 gain counts/s (MotorModel.h)
+    FL_PID_TUNE         // p0 wheel, p1 Tu calls, v0 Ku x 1000, v1 amplitude counts; p0 2: v0 P x 1000, v1 I x 1000000; p0 0xFF: failed (PidTune.h)
+} flight_log_event_t;
+
+typedef enum
+{
+    FL_FLUSH_END_OF_RUN = 1,
+    FL_FLUSH_STOP,          // emergency stop, button S2
+    FL_FLUSH_FAULT,
+    FL_FLUSH_REQUEST,
+    FL_FLUSH_WATCHDOG       // a supervised task missed its deadline
+} flight_log_reason_t;
+
+typedef struct
+{
+    uint32_t time_ms;
+    uint8_t type;           // flight_log_event_t
+    uint8_t p0;
+    uint8_t p1;
+    uint8_t p2;
+    int32_t v0;
+    int32_t v1;
+} flight_log_entry_t;
+
+typedef struct
+{
+    uint32_t magic;         // FLIGHT_LOG_MAGIC, written last
+    uint16_t sequence;      // flush number, the higher of the two slots is newer
+    uint8_t reason;         // flight_log_reason_t
+    uint8_t count;          // entries stored, oldest first
+    uint32_t recorded;      // events since boot, more than count if the ring wrapped
+    uint32_t check;         // sum of the words above and of the entries
+} flight_log_header_t;
+
+typedef struct
+{
+    flight_log_header_t header;
+    flight_log_entry_t entries[FLIGHT_LOG_ENTRIES];
+} flight_log_slot_t;
+
+void flight_log_init(void);
+void flight_log_tick(void);
+void flight_log_record(flight_log_event_t type, uint8_t p0, uint8_t p1, uint8_t p2, int32_t v0, int32_t v1);
+bool flight_log_flush(flight_log_reason_t reason);
+const flight_log_slot_t *flight_log_stored(void);
+void flight_log_dump(void);
+
+#endif /* FLIGHTLOG_H_ */
@@ -0,0 +1,983 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2015, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+//****************************************************************************
+//
+// HAL_I2C.c - Hardware abstraction layer for I2C with MSP432P401R
+//
+//****************************************************************************
+
+#include <stddef.h>
+#include <ti/devices/msp432p4xx/driverlib/driverlib.h>
+#include "HAL_I2C.h"
+#include "Clock.h"
+#include "RamFunc.h"
+
+/* Interrupts used by the transaction engine */
+#define I2C_ENGINE_INTERRUPTS   (EUSCI_B_I2C_TRANSMIT_INTERRUPT0 + \
+                                 EUSCI_B_I2C_RECEIVE_INTERRUPT0 + \
+                                 EUSCI_B_I2C_STOP_INTERRUPT + \
+                                 EUSCI_B_I2C_NAK_INTERRUPT + \
+                                 EUSCI_B_I2C_ARBITRATIONLOST_INTERRUPT)
+
+/* Transaction engine phases, advanced by the eUSCI_B1 interrupt */
+#define I2C_PHASE_POINTER       0   /* START sent, send register pointer */
+#define I2C_PHASE_TX_MSB        1   /* write: send data MSB */
+#define I2C_PHASE_TX_LSB        2   /* write: send data LSB */
+#define I2C_PHASE_TX_STOP       3   /* write: last byte loaded, send STOP */
+#define I2C_PHASE_RESTART       4   /* read: pointer loaded, send repeated START */
+#define I2C_PHASE_RX_MSB        5   /* read: receive MSB, schedule STOP */
+#define I2C_PHASE_RX_LSB        6   /* read: receive LSB */
+#define I2C_PHASE_WAIT_STOP     7   /* wait for STOP to complete */
+
+
+/* I2C Master Configuration Parameter */
+eUSCI_I2C_MasterConfig i2cConfig =
+{
+        EUSCI_B_I2C_CLOCKSOURCE_SMCLK,          // SMCLK Clock Source
+        0,                                      // SMCLK, set by I2C_setClock()
+        EUSCI_B_I2C_SET_DATA_RATE_400KBPS,      // Desired I2C Clock of 400khz
+        0,                                      // No byte counter threshold
+        EUSCI_B_I2C_NO_AUTO_STOP                // No Autostop
+};
+
+/* Slave address used by I2C_read16/I2C_write16 */
+static unsigned int i2cSlaveAddress = 0;
+
+/* Result of the last blocking transfer */
+static i2c_status_t i2cLastStatus = I2C_OK;
+
+/* Set while a blocking transfer owns the bus, holds off the queue */
+static volatile bool i2cBlockingActive = false;
+
+/* SMCLK changed during a transfer, the divider follows once the bus is free */
+static volatile bool i2cClockPending = false;
+
+/* Transaction queue, circular buffer of caller owned descriptors */
+static i2c_transaction_t *i2cQueue[I2C_QUEUE_SIZE];
+static volatile uint8_t i2cQueueHead = 0;
+static volatile uint8_t i2cQueueTail = 0;
+static volatile uint8_t i2cQueueCount = 0;
+
+/* Transaction currently on the bus, NULL when the engine is idle */
+static i2c_transaction_t * volatile i2cCurrent = NULL;
+static volatile uint8_t i2cPhase;
+static volatile i2c_status_t i2cResult;
+static volatile uint16_t i2cCurrentAge;
+
+/* Per device error counters */
+static i2c_device_stats_t i2cDevices[I2C_MAX_DEVICES];
+static uint8_t i2cNumDevices = 0;
+
+void Init_I2C_GPIO()
+{
+    /* Select I2C function for I2C_SCL(P6.5) & I2C_SDA(P6.4) */
+    GPIO_setAsPeripheralModuleFunctionOutputPin(
+            GPIO_PORT_P6,
+            GPIO_PIN5,
+            GPIO_PRIMARY_MODULE_FUNCTION);
+
+    GPIO_setAsPeripheralModuleFunctionOutputPin(
+            GPIO_PORT_P6,
+            GPIO_PIN4,
+            GPIO_PRIMARY_MODULE_FUNCTION);
+}
+
+
+/***************************************************************************//**
+ * @brief  Set the clock in i2cConfig from SMCLK
+ * @param  none
+ * @return none
+ ******************************************************************************/
+
+static void I2C_setClock(void)
+{
+    uint32_t smclk = Clock_GetSMCLK();
+    uint32_t rate = i2cConfig.dataRate;
+
+    /*
+     * DriverLib divides i2cClk by the data rate and drops the remainder,
+     * pass SMCLK rounded up so SCL comes out at or below the data rate
+     */
+    i2cConfig.i2cClk = ((smclk + rate - 1) / rate) * rate;
+}
+
+
+/***************************************************************************//**
+ * @brief  Reprogram the bit rate divider for the current SMCLK
+ * @param  none
+ * @return none
+ * @note   The bus must be free.  Call with interrupts disabled.
+ ******************************************************************************/
+
+static void I2C_applyClock(void)
+{
+    i2cClockPending = false;
+
+    I2C_setClock();
+    I2C_initMaster(EUSCI_B1_BASE, &i2cConfig);
+    I2C_enableModule(EUSCI_B1_BASE);
+    I2C_disableInterrupt(EUSCI_B1_BASE, I2C_ENGINE_INTERRUPTS);
+}
+
+
+/***************************************************************************//**
+ * @brief  Reprogram the bit rate divider for the new SMCLK
+ * @param  none
+ * @return none
+ * @note   Clock change handler.  A transaction on the bus finishes first, at
+ *         whatever SCL the new SMCLK gives the old divider, and the divider
+ *         changes before the next one starts.  Never waits for the bus, so
+ *         it is safe with interrupts masked.
+ ******************************************************************************/
+
+static void I2C_clockChanged(void)
+{
+    bool wasDisabled;
+
+    wasDisabled = Interrupt_disableMaster();
+
+    if ((i2cCurrent == NULL) && !i2cBlockingActive)
+        I2C_applyClock();
+    else
+        i2cClockPending = true;
+
+    if (!wasDisabled)
+        Interrupt_enableMaster();
+}
+
+
+/***************************************************************************//**
+ * @brief  Configures I2C
+ * @param  none
+ * @return none
+ ******************************************************************************/
+
+void I2C_init(void)
+{
+    /* The bit rate divider follows SMCLK, also after a clock change */
+    I2C_setClock();
+    Clock_AddChangeHandler(I2C_clockChanged);
+
+        /* Initialize USCI_B0 and I2C Master to communicate with slave devices*/
+    I2C_initMaster(EUSCI_B1_BASE, &i2cConfig);
+
+    /* Disable I2C module to make changes */
+    I2C_disableModule(EUSCI_B1_BASE);
+
+    /* Enable I2C Module to start operations */
+    I2C_enableModule(EUSCI_B1_BASE);
+
+    /* Transaction engine interrupts are enabled per transaction */
+    I2C_disableInterrupt(EUSCI_B1_BASE, I2C_ENGINE_INTERRUPTS);
+    Interrupt_enableInterrupt(INT_EUSCIB1);
+
+    return;
+}
+
+
+/***************************************************************************//**
+ * @brief  Find the error counters for a slave, allocating them on first use
+ * @param  slaveAddress 7-bit slave address
+ * @return Counters, or NULL if the table is full
+ ******************************************************************************/
+
+static i2c_device_stats_t *I2C_findDevice(uint8_t slaveAddress)
+{
+    uint8_t i;
+
+    for (i = 0; i < i2cNumDevices; i++)
+    {
+        if (i2cDevices[i].slaveAddress == slaveAddress)
+            return &i2cDevices[i];
+    }
+
+    if (i2cNumDevices < I2C_MAX_DEVICES)
+    {
+        i2cDevices[i2cNumDevices].slaveAddress = slaveAddress;
+        return &i2cDevices[i2cNumDevices++];
+    }
+
+    return NULL;
+}
+
+
+/***************************************************************************//**
+ * @brief  Decide whether a transfer to a slave should go on the bus
+ * @param  slaveAddress 7-bit slave address
+ * @return false if the device is offline and this attempt is skipped
+ * @note   Call with interrupts disabled or from the I2C interrupt
+ ******************************************************************************/
+
+static bool I2C_deviceAttempt(uint8_t slaveAddress)
+{
+    i2c_device_stats_t *d = I2C_findDevice(slaveAddress);
+
+    if ((d == NULL) || (d->consecutiveErrors < I2C_OFFLINE_THRESHOLD))
+        return true;
+
+    /* Offline, let one probe through every I2C_RETRY_INTERVAL attempts */
+    if (d->retryCountdown == 0)
+    {
+        d->retryCountdown = I2C_RETRY_INTERVAL;
+        return true;
+    }
+
+    d->retryCountdown--;
+    d->skipped++;
+    return false;
+}
+
+
+/***************************************************************************//**
+ * @brief  Update the error counters of a slave after a transfer
+ * @param  slaveAddress 7-bit slave address
+ * @param  result Outcome of the transfer
+ * @return none
+ * @note   Call with interrupts disabled or from the I2C interrupt
+ ******************************************************************************/
+
+static void I2C_deviceResult(uint8_t slaveAddress, i2c_status_t result)
+{
+    i2c_device_stats_t *d = I2C_findDevice(slaveAddress);
+
+    if ((d == NULL) || (result == I2C_ERR_OFFLINE))
+        return;
+
+    d->transfers++;
+
+    if (result == I2C_OK)
+    {
+        d->consecutiveErrors = 0;
+        return;
+    }
+
+    d->errors++;
+    if (d->consecutiveErrors < 0xFF)
+        d->consecutiveErrors++;
+    if (d->consecutiveErrors == I2C_OFFLINE_THRESHOLD)
+        d->retryCountdown = I2C_RETRY_INTERVAL;
+
+    switch (result)
+    {
+    case I2C_ERR_NACK:
+        d->nacks++;
+        break;
+    case I2C_ERR_ARBITRATION:
+        d->arbitrationLost++;
+        break;
+    default:
+        d->timeouts++;
+        break;
+    }
+}
+
+
+/***************************************************************************//**
+ * @brief  Error counters for a slave
+ * @param  slaveAddress 7-bit slave address
+ * @return Counters, or NULL if no transfer to this slave has been made
+ ******************************************************************************/
+
+const i2c_device_stats_t *I2C_getDeviceStats(uint8_t slaveAddress)
+{
+    uint8_t i;
+
+    for (i = 0; i < i2cNumDevices; i++)
+    {
+        if (i2cDevices[i].slaveAddress == slaveAddress)
+            return &i2cDevices[i];
+    }
+
+    return NULL;
+}
+
+
+/***************************************************************************//**
+ * @brief  Check whether a slave is responding
+ * @param  slaveAddress 7-bit slave address
+ * @return false once the slave has failed I2C_OFFLINE_THRESHOLD transfers
+ *         in a row, true again after the next successful transfer
+ ******************************************************************************/
+
+bool I2C_isDeviceOnline(uint8_t slaveAddress)
+{
+    const i2c_device_stats_t *d = I2C_getDeviceStats(slaveAddress);
+
+    return (d == NULL) || (d->consecutiveErrors < I2C_OFFLINE_THRESHOLD);
+}
+
+
+/***************************************************************************//**
+ * @brief  Reset the eUSCI_B1 state machine, clearing all flags
+ * @param  none
+ * @return none
+ ******************************************************************************/
+
+static void I2C_resetModule(void)
+{
+    I2C_disableModule(EUSCI_B1_BASE);
+    I2C_enableModule(EUSCI_B1_BASE);
+}
+
+
+/***************************************************************************//**
+ * @brief  Release a bus held by a slave stuck in the middle of a byte
+ * @param  none
+ * @return none
+ * @note   Takes SCL(P6.5) and SDA(P6.4) back as GPIO, clocks SCL up to nine
+ *         times until the slave lets go of SDA, generates a STOP and hands
+ *         the pins back to eUSCI_B1.  Pins are driven open drain style,
+ *         output low or input with the bus pull-ups.
+ ******************************************************************************/
+
+void I2C_busClear(void)
+{
+    int i;
+
+    I2C_disableModule(EUSCI_B1_BASE);
+
+    /* SDA and SCL released */
+    GPIO_setAsInputPinWithPullUpResistor(GPIO_PORT_P6, GPIO_PIN4);
+    GPIO_setAsInputPinWithPullUpResistor(GPIO_PORT_P6, GPIO_PIN5);
+    Clock_Delay1us(5);
+
+    /* Clock out whatever the slave is still trying to send */
+    for (i = 0; i < 9; i++)
+    {
+        if (GPIO_getInputPinValue(GPIO_PORT_P6, GPIO_PIN4))
+            break;
+
+        GPIO_setOutputLowOnPin(GPIO_PORT_P6, GPIO_PIN5);
+        GPIO_setAsOutputPin(GPIO_PORT_P6, GPIO_PIN5);
+        Clock_Delay1us(5);
+        GPIO_setAsInputPinWithPullUpResistor(GPIO_PORT_P6, GPIO_PIN5);
+        Clock_Delay1us(5);
+    }
+
+    /* STOP: SDA low to high while SCL is high */
+    GPIO_setOutputLowOnPin(GPIO_PORT_P6, GPIO_PIN5);
+    GPIO_setAsOutputPin(GPIO_PORT_P6, GPIO_PIN5);
+    GPIO_setOutputLowOnPin(GPIO_PORT_P6, GPIO_PIN4);
+    GPIO_setAsOutputPin(GPIO_PORT_P6, GPIO_PIN4);
+    Clock_Delay1us(5);
+    GPIO_setAsInputPinWithPullUpResistor(GPIO_PORT_P6, GPIO_PIN5);
+    Clock_Delay1us(5);
+    GPIO_setAsInputPinWithPullUpResistor(GPIO_PORT_P6, GPIO_PIN4);
+    Clock_Delay1us(5);
+
+    Init_I2C_GPIO();
+    I2C_enableModule(EUSCI_B1_BASE);
+}
+
+
+/***************************************************************************//**
+ * @brief  Recover the bus after a failed transfer
+ * @param  result Reason the transfer failed
+ * @return none
+ ******************************************************************************/
+
+static void I2C_recover(i2c_status_t result)
+{
+    if ((result == I2C_ERR_TIMEOUT) || (result == I2C_ERR_BUS_BUSY))
+        I2C_busClear();
+    else
+        I2C_resetModule();
+}
+
+
+/***************************************************************************//**
+ * @brief  Start the next queued transaction if the bus is free
+ * @param  none
+ * @return none
+ * @note   Must be called with interrupts disabled or from the I2C interrupt.
+ *         Transactions for offline devices are failed without using the bus.
+ ******************************************************************************/
+
+static void I2C_startNext(void)
+{
+    i2c_transaction_t *t;
+
+    /* The clock changed during the last transfer, the bus is free now */
+    if (i2cClockPending && (i2cCurrent == NULL) && !i2cBlockingActive)
+        I2C_applyClock();
+
+    while (i2cCurrent == NULL)
+    {
+        if ((i2cQueueCount == 0) || i2cBlockingActive)
+        {
+            /* Nothing to do, leave the module quiet for blocking transfers */
+            I2C_disableInterrupt(EUSCI_B1_BASE, I2C_ENGINE_INTERRUPTS);
+            return;
+        }
+
+        t = i2cQueue[i2cQueueHead];
+        i2cQueueHead = (i2cQueueHead + 1) % I2C_QUEUE_SIZE;
+        i2cQueueCount--;
+
+        if (!I2C_deviceAttempt(t->slaveAddress))
+        {
+            t->result = I2C_ERR_OFFLINE;
+            t->status = I2C_TRANSACTION_ERROR;
+            if (t->callback)
+                t->callback(t);
+            continue;
+        }
+
+        i2cCurrent = t;
+        i2cPhase = I2C_PHASE_POINTER;
+        i2cResult = I2C_OK;
+        i2cCurrentAge = 0;
+        t->status = I2C_TRANSACTION_BUSY;
+
+        I2C_setSlaveAddress(EUSCI_B1_BASE, t->slaveAddress);
+        I2C_setMode(EUSCI_B1_BASE, EUSCI_B_I2C_TRANSMIT_MODE);
+        I2C_clearInterruptFlag(EUSCI_B1_BASE, I2C_ENGINE_INTERRUPTS);
+        I2C_enableInterrupt(EUSCI_B1_BASE, I2C_ENGINE_INTERRUPTS);
+
+        /* Address phase runs in hardware, TXIFG fires when the pointer can be sent */
+        I2C_masterSendStart(EUSCI_B1_BASE);
+    }
+}
+
+
+/***************************************************************************//**
+ * @brief  Finish the current transaction and start the next one
+ * @param  none
+ * @return none
+ ******************************************************************************/
+
+static void I2C_complete(void)
+{
+    i2c_transaction_t *t = i2cCurrent;
+
+    i2cCurrent = NULL;
+    I2C_deviceResult(t->slaveAddress, i2cResult);
+
+    t->result = i2cResult;
+    t->status = (i2cResult == I2C_OK) ? I2C_TRANSACTION_DONE : I2C_TRANSACTION_ERROR;
+
+    if (t->callback)
+        t->callback(t);
+
+    I2C_startNext();
+}
+
+
+/***************************************************************************//**
+ * @brief  Queue a transaction for the interrupt driven engine
+ * @param  transaction Descriptor, must stay valid until completion
+ * @return true if queued, false if the queue is full or the descriptor is
+ *         already queued
+ * @note   Returns immediately.  Completion is reported through the callback
+ *         or can be polled with I2C_isComplete().  Safe to call from
+ *         interrupts, including completion callbacks.
+ ******************************************************************************/
+
+bool I2C_submit(i2c_transaction_t *transaction)
+{
+    bool wasDisabled;
+    bool queued = false;
+
+    wasDisabled = Interrupt_disableMaster();
+
+    if ((transaction->status != I2C_TRANSACTION_QUEUED) &&
+        (transaction->status != I2C_TRANSACTION_BUSY) &&
+        (i2cQueueCount < I2C_QUEUE_SIZE))
+    {
+        transaction->status = I2C_TRANSACTION_QUEUED;
+        transaction->result = I2C_OK;
+        i2cQueue[i2cQueueTail] = transaction;
+        i2cQueueTail = (i2cQueueTail + 1) % I2C_QUEUE_SIZE;
+        i2cQueueCount++;
+        queued = true;
+
+        I2C_startNext();
+    }
+
+    if (!wasDisabled)
+        Interrupt_enableMaster();
+
+    return queued;
+}
+
+
+/***************************************************************************//**
+ * @brief  Check whether a submitted transaction has finished
+ * @param  transaction Descriptor passed to I2C_submit()
+ * @return true once the transaction is done or has failed
+ ******************************************************************************/
+
+bool I2C_isComplete(const i2c_transaction_t *transaction)
+{
+    return (transaction->status == I2C_TRANSACTION_DONE) ||
+           (transaction->status == I2C_TRANSACTION_ERROR);
+}
+
+
+/***************************************************************************//**
+ * @brief  Check whether the transaction engine has nothing left to do
+ * @param  none
+ * @return true if no transaction is queued or on the bus
+ ******************************************************************************/
+
+bool I2C_isIdle(void)
+{
+    return (i2cCurrent == NULL) && (i2cQueueCount == 0);
+}
+
+
+/***************************************************************************//**
+ * @brief  Transaction timeout supervision
+ * @param  none
+ * @return none
+ * @note   Call every millisecond (from SysTick).  A transaction that has been
+ *         on the bus for I2C_TRANSACTION_TIMEOUT_MS is aborted with
+ *         I2C_ERR_TIMEOUT, the bus is cleared and the queue moves on.
+ *         Runs from SRAM.
+ ******************************************************************************/
+
+RAMFUNC void I2C_service(void)
+{
+    bool wasDisabled;
+
+    wasDisabled = Interrupt_disableMaster();
+
+    if ((i2cCurrent != NULL) && (++i2cCurrentAge >= I2C_TRANSACTION_TIMEOUT_MS))
+    {
+        I2C_disableInterrupt(EUSCI_B1_BASE, I2C_ENGINE_INTERRUPTS);
+        I2C_busClear();
+        i2cResult = I2C_ERR_TIMEOUT;
+        I2C_complete();
+    }
+
+    if (!wasDisabled)
+        Interrupt_enableMaster();
+}
+
+
+/***************************************************************************//**
+ * @brief  Wait for an interrupt flag with a time limit
+ * @param  flag EUSCI_B_I2C_*_INTERRUPT flag to wait for
+ * @return I2C_OK, or the error that ended the wait
+ * @note   NACK and arbitration lost end the wait early
+ ******************************************************************************/
+
+static i2c_status_t I2C_waitForFlag(uint_fast16_t flag)
+{
+    uint32_t loops = 0;
+    uint_fast16_t ifg;
+
+    while (1)
+    {
+        ifg = I2C_getInterruptStatus(EUSCI_B1_BASE,
+            flag | EUSCI_B_I2C_NAK_INTERRUPT | EUSCI_B_I2C_ARBITRATIONLOST_INTERRUPT);
+
+        if (ifg & EUSCI_B_I2C_ARBITRATIONLOST_INTERRUPT)
+            return I2C_ERR_ARBITRATION;
+
+        if (ifg & EUSCI_B_I2C_NAK_INTERRUPT)
+            return I2C_ERR_NACK;
+
+        if (ifg & flag)
+            return I2C_OK;
+
+        if (++loops >= I2C_TIMEOUT_LOOPS)
+            return I2C_ERR_TIMEOUT;
+    }
+}
+
+
+/***************************************************************************//**
+ * @brief  Take the bus for a blocking transfer
+ * @param  slaveAddress 7-bit slave address
+ * @return I2C_OK, I2C_ERR_BUS_BUSY or I2C_ERR_OFFLINE
+ * @note   Waits a bounded time for queued transactions to drain.  The bus
+ *         is only held when I2C_OK is returned.  Do not call from an
+ *         interrupt handler.
+ ******************************************************************************/
+
+static i2c_status_t I2C_endBlocking(uint8_t slaveAddress, i2c_status_t result);
+
+static i2c_status_t I2C_beginBlocking(uint8_t slaveAddress)
+{
+    bool wasDisabled;
+    bool attempt;
+    uint32_t loops = 0;
+
+    while (1)
+    {
+        wasDisabled = Interrupt_disableMaster();
+
+        if (i2cCurrent == NULL)
+            break;
+
+        if (!wasDisabled)
+            Interrupt_enableMaster();
+
+        if (++loops >= (4 * I2C_TIMEOUT_LOOPS))
+        {
+            /* Queue is still using the bus, leave it alone */
+            i2cLastStatus = I2C_ERR_BUS_BUSY;
+            return I2C_ERR_BUS_BUSY;
+        }
+    }
+
+    attempt = I2C_deviceAttempt(slaveAddress);
+    if (attempt)
+    {
+        i2cBlockingActive = true;
+        I2C_disableInterrupt(EUSCI_B1_BASE, I2C_ENGINE_INTERRUPTS);
+    }
+
+    if (!wasDisabled)
+        Interrupt_enableMaster();
+
+    if (!attempt)
+    {
+        i2cLastStatus = I2C_ERR_OFFLINE;
+        return I2C_ERR_OFFLINE;
+    }
+
+    I2C_setSlaveAddress(EUSCI_B1_BASE, slaveAddress);
+
+    /* Wait until ready to write */
+    loops = 0;
+    while (I2C_isBusBusy(EUSCI_B1_BASE))
+    {
+        if (++loops >= I2C_TIMEOUT_LOOPS)
+            return I2C_endBlocking(slaveAddress, I2C_ERR_BUS_BUSY);
+    }
+
+    return I2C_OK;
+}
+
+
+/***************************************************************************//**
+ * @brief  Release the bus after a blocking transfer
+ * @param  slaveAddress 7-bit slave address
+ * @param  result Outcome of the transfer
+ * @return result
+ ******************************************************************************/
+
+static i2c_status_t I2C_endBlocking(uint8_t slaveAddress, i2c_status_t result)
+{
+    bool wasDisabled;
+
+    if (result != I2C_OK)
+    {
+        /* Release a slave that is still holding the bus */
+        if (result == I2C_ERR_NACK)
+        {
+            /*
+             * TXIFG may never come back after a NACK, so set UCTXSTP directly
+             * rather than through masterSendMultiByteStop() which polls it.
+             */
+            I2C_clearInterruptFlag(EUSCI_B1_BASE, EUSCI_B_I2C_NAK_INTERRUPT);
+            I2C_masterReceiveMultiByteStop(EUSCI_B1_BASE);
+            I2C_waitForFlag(EUSCI_B_I2C_STOP_INTERRUPT);
+        }
+        I2C_recover(result);
+    }
+
+    wasDisabled = Interrupt_disableMaster();
+
+    I2C_deviceResult(slaveAddress, result);
+
+    i2cBlockingActive = false;
+    I2C_startNext();
+
+    if (!wasDisabled)
+        Interrupt_enableMaster();
+
+    i2cLastStatus = result;
+    return result;
+}
+
+
+/***************************************************************************//**
+ * @brief  Send START and the register pointer
+ * @param  pointer Register address
+ * @return I2C_OK or error
+ ******************************************************************************/
+
+static i2c_status_t I2C_sendPointer(uint8_t pointer)
+{
+    i2c_status_t result;
+
+    /* Set master to transmit mode, clear any existing interrupt flags */
+    I2C_setMode(EUSCI_B1_BASE, EUSCI_B_I2C_TRANSMIT_MODE);
+    I2C_clearInterruptFlag(EUSCI_B1_BASE, I2C_ENGINE_INTERRUPTS);
+
+    /* START, TXIFG is set once the slave address is on its way */
+    I2C_masterSendStart(EUSCI_B1_BASE);
+    result = I2C_waitForFlag(EUSCI_B_I2C_TRANSMIT_INTERRUPT0);
+    if (result != I2C_OK)
+        return result;
+
+    I2C_masterSendMultiByteNext(EUSCI_B1_BASE, pointer);
+
+    /* Pointer moved to the shift register (address was acknowledged) */
+    return I2C_waitForFlag(EUSCI_B_I2C_TRANSMIT_INTERRUPT0);
+}
+
+
+/***************************************************************************//**
+ * @brief  Reads a 16-bit register, bounded time
+ * @param  slaveAddress 7-bit slave address
+ * @param  pointer Address of register to read from
+ * @param  value Register contents, unchanged on error
+ * @return I2C_OK or error
+ ******************************************************************************/
+
+i2c_status_t I2C_readRegister16(uint8_t slaveAddress, uint8_t pointer, uint16_t *value)
+{
+    i2c_status_t result;
+    uint16_t val;
+
+    result = I2C_beginBlocking(slaveAddress);
+    if (result != I2C_OK)
+        return result;
+
+    result = I2C_sendPointer(pointer);
+    if (result != I2C_OK)
+        return I2C_endBlocking(slaveAddress, result);
+
+    /* Repeated START in receive mode */
+    I2C_masterReceiveStart(EUSCI_B1_BASE);
+
+    result = I2C_waitForFlag(EUSCI_B_I2C_RECEIVE_INTERRUPT0);
+    if (result != I2C_OK)
+        return I2C_endBlocking(slaveAddress, result);
+
+    /* STOP must be requested while the last byte is being received */
+    I2C_masterReceiveMultiByteStop(EUSCI_B1_BASE);
+    val = (uint16_t)I2C_masterReceiveMultiByteNext(EUSCI_B1_BASE) << 8;
+
+    result = I2C_waitForFlag(EUSCI_B_I2C_RECEIVE_INTERRUPT0);
+    if (result != I2C_OK)
+        return I2C_endBlocking(slaveAddress, result);
+
+    val |= I2C_masterReceiveMultiByteNext(EUSCI_B1_BASE);
+
+    result = I2C_waitForFlag(EUSCI_B_I2C_STOP_INTERRUPT);
+    if (result == I2C_OK)
+        *value = val;
+
+    return I2C_endBlocking(slaveAddress, result);
+}
+
+
+/***************************************************************************//**
+ * @brief  Writes a 16-bit register, bounded time
+ * @param  slaveAddress 7-bit slave address
+ * @param  pointer Address of register you want to modify
+ * @param  value Data to be written to the specified register
+ * @return I2C_OK or error
+ ******************************************************************************/
+
+i2c_status_t I2C_writeRegister16(uint8_t slaveAddress, uint8_t pointer, uint16_t value)
+{
+    i2c_status_t result;
+
+    result = I2C_beginBlocking(slaveAddress);
+    if (result != I2C_OK)
+        return result;
+
+    result = I2C_sendPointer(pointer);
+    if (result != I2C_OK)
+        return I2C_endBlocking(slaveAddress, result);
+
+    /* Send the MSB to SENSOR */
+    I2C_masterSendMultiByteNext(EUSCI_B1_BASE, (uint8_t)(value >> 8));
+    result = I2C_waitForFlag(EUSCI_B_I2C_TRANSMIT_INTERRUPT0);
+    if (result != I2C_OK)
+        return I2C_endBlocking(slaveAddress, result);
+
+    /* Send the LSB */
+    I2C_masterSendMultiByteNext(EUSCI_B1_BASE, (uint8_t)(value & 0xFF));
+    result = I2C_waitForFlag(EUSCI_B_I2C_TRANSMIT_INTERRUPT0);
+    if (result != I2C_OK)
+        return I2C_endBlocking(slaveAddress, result);
+
+    I2C_masterSendMultiByteStop(EUSCI_B1_BASE);
+    result = I2C_waitForFlag(EUSCI_B_I2C_STOP_INTERRUPT);
+
+    return I2C_endBlocking(slaveAddress, result);
+}
+
+
+/***************************************************************************//**
+ * @brief  Result of the last blocking transfer
+ * @param  none
+ * @return I2C_OK or error
+ ******************************************************************************/
+
+i2c_status_t I2C_getLastStatus(void)
+{
+    return i2cLastStatus;
+}
+
+
+/***************************************************************************//**
+ * @brief  Reads data from the sensor
+ * @param  writeByte Address of register to read from
+ * @return Register contents, 0 on error (see I2C_getLastStatus())
+ ******************************************************************************/
+
+int I2C_read16(unsigned char writeByte)
+{
+    uint16_t val = 0;
+
+    I2C_readRegister16(i2cSlaveAddress, writeByte, &val);
+
+    return (int16_t)val;
+}
+
+
+/***************************************************************************//**
+ * @brief  Writes data to the sensor
+ * @param  pointer  Address of register you want to modify
+ * @param  writeByte Data to be written to the specified register
+ * @return none, see I2C_getLastStatus()
+ ******************************************************************************/
+
+void I2C_write16 (unsigned char pointer, unsigned int writeByte)
+{
+    I2C_writeRegister16(i2cSlaveAddress, pointer, (uint16_t)writeByte);
+}
+
+
+void I2C_setslave(unsigned int slaveAdr)
+{
+    /* Remember slave address for I2C_read16/I2C_write16 */
+    i2cSlaveAddress = slaveAdr;
+    return;
+}
+
+
+/***************************************************************************//**
+ * @brief  eUSCI_B1 interrupt, advances the current transaction one step
+ * @param  none
+ * @return none
+ ******************************************************************************/
+
+void EUSCIB1_IRQHandler(void)
+{
+    uint_fast16_t status;
+    i2c_transaction_t *t = i2cCurrent;
+
+    status = I2C_getEnabledInterruptStatus(EUSCI_B1_BASE);
+    I2C_clearInterruptFlag(EUSCI_B1_BASE, status);
+
+    if (t == NULL)
+        return;
+
+    /* Another master won the bus, the module has dropped to slave mode */
+    if (status & EUSCI_B_I2C_ARBITRATIONLOST_INTERRUPT)
+    {
+        I2C_disableInterrupt(EUSCI_B1_BASE, I2C_ENGINE_INTERRUPTS);
+        I2C_resetModule();
+        i2cResult = I2C_ERR_ARBITRATION;
+        I2C_complete();
+        return;
+    }
+
+    /* Slave did not acknowledge, release the bus and fail the transaction */
+    if (status & EUSCI_B_I2C_NAK_INTERRUPT)
+    {
+        i2cResult = I2C_ERR_NACK;
+        i2cPhase = I2C_PHASE_WAIT_STOP;
+        I2C_masterReceiveMultiByteStop(EUSCI_B1_BASE);     // sets UCTXSTP without waiting for TXIFG
+        return;
+    }
+
+    if (status & EUSCI_B_I2C_TRANSMIT_INTERRUPT0)
+    {
+        switch (i2cPhase)
+        {
+        case I2C_PHASE_POINTER:
+            I2C_masterSendMultiByteNext(EUSCI_B1_BASE, t->pointer);
+            i2cPhase = (t->op == I2C_OP_READ16) ? I2C_PHASE_RESTART : I2C_PHASE_TX_MSB;
+            break;
+
+        case I2C_PHASE_TX_MSB:
+            I2C_masterSendMultiByteNext(EUSCI_B1_BASE, (uint8_t)(t->data >> 8));
+            i2cPhase = I2C_PHASE_TX_LSB;
+            break;
+
+        case I2C_PHASE_TX_LSB:
+            I2C_masterSendMultiByteNext(EUSCI_B1_BASE, (uint8_t)(t->data & 0xFF));
+            i2cPhase = I2C_PHASE_TX_STOP;
+            break;
+
+        case I2C_PHASE_TX_STOP:
+            I2C_masterSendMultiByteStop(EUSCI_B1_BASE);
+            i2cPhase = I2C_PHASE_WAIT_STOP;
+            break;
+
+        case I2C_PHASE_RESTART:
+            /* Repeated START in receive mode once the pointer has gone out */
+            I2C_masterReceiveStart(EUSCI_B1_BASE);
+            i2cPhase = I2C_PHASE_RX_MSB;
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    if (status & EUSCI_B_I2C_RECEIVE_INTERRUPT0)
+    {
+        switch (i2cPhase)
+        {
+        case I2C_PHASE_RX_MSB:
+            /* STOP must be requested while the last byte is being received */
+            I2C_masterReceiveMultiByteStop(EUSCI_B1_BASE);
+            t->data = (uint16_t)I2C_masterReceiveMultiByteNext(EUSCI_B1_BASE) << 8;
+            i2cPhase = I2C_PHASE_RX_LSB;
+            break;
+
+        case I2C_PHASE_RX_LSB:
+            t->data |= I2C_masterReceiveMultiByteNext(EUSCI_B1_BASE);
+            i2cPhase = I2C_PHASE_WAIT_STOP;
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    if (status & EUSCI_B_I2C_STOP_INTERRUPT)
+    {
+        I2C_complete();
+    }
+}
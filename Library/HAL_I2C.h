@@ -0,0 +1,146 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2015, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+//****************************************************************************
+//
+// HAL_I2C.h - Prototypes of hardware abstraction layer for I2C between
+//             MSP432P401R and OPT3001
+//
+//****************************************************************************
+
+#ifndef __HAL_I2C_H_
+#define __HAL_I2C_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Maximum number of transactions waiting for the bus */
+#define I2C_QUEUE_SIZE 8
+
+/* Transaction types, all transfers are a register pointer plus 16 bits */
+#define I2C_OP_READ16   0
+#define I2C_OP_WRITE16  1
+
+/*
+ * Polling loops allowed for one bus phase (START, one byte, STOP) in the
+ * blocking functions.  One byte takes about 25us at 400 kbps, the limit is
+ * a few milliseconds at 48 MHz.
+ */
+#define I2C_TIMEOUT_LOOPS 5000
+
+/* Time limit for one queued transaction, in calls to I2C_service() (1 ms) */
+#define I2C_TRANSACTION_TIMEOUT_MS 5
+
+/*
+ * A device that fails this many transfers in a row is marked offline.  Only
+ * one in every I2C_RETRY_INTERVAL transfers to an offline device is put on
+ * the bus, the others fail immediately with I2C_ERR_OFFLINE.
+ */
+#define I2C_OFFLINE_THRESHOLD   3
+#define I2C_RETRY_INTERVAL      50
+
+/* Number of slave addresses tracked by the error counters */
+#define I2C_MAX_DEVICES 4
+
+typedef enum
+{
+    I2C_OK = 0,
+    I2C_ERR_TIMEOUT,            /* a bus phase did not finish in time */
+    I2C_ERR_NACK,               /* slave did not acknowledge */
+    I2C_ERR_ARBITRATION,        /* arbitration lost */
+    I2C_ERR_BUS_BUSY,           /* bus never became free */
+    I2C_ERR_OFFLINE             /* device marked offline, transfer skipped */
+} i2c_status_t;
+
+typedef enum
+{
+    I2C_TRANSACTION_IDLE = 0,   /* never submitted */
+    I2C_TRANSACTION_QUEUED,     /* waiting for the bus */
+    I2C_TRANSACTION_BUSY,       /* on the bus */
+    I2C_TRANSACTION_DONE,       /* completed, data is valid for reads */
+    I2C_TRANSACTION_ERROR       /* failed, see result */
+} i2c_transaction_status_t;
+
+typedef struct i2c_transaction i2c_transaction_t;
+
+/* Completion callback, called from the eUSCI_B1 interrupt */
+typedef void (*i2c_callback_t)(i2c_transaction_t *transaction);
+
+/*
+ * Transaction descriptor.  The caller owns the memory and must keep it
+ * alive (static or global) until the transaction has completed.
+ */
+struct i2c_transaction
+{
+    uint8_t slaveAddress;
+    uint8_t pointer;            /* register address */
+    uint8_t op;                 /* I2C_OP_READ16 or I2C_OP_WRITE16 */
+    uint16_t data;              /* value to write, or value read */
+    i2c_callback_t callback;    /* may be NULL, poll status instead */
+    volatile i2c_transaction_status_t status;
+    volatile i2c_status_t result;
+};
+
+/* Error counters kept for every slave address that has been used */
+typedef struct
+{
+    uint8_t slaveAddress;
+    uint32_t transfers;
+    uint32_t errors;
+    uint16_t nacks;
+    uint16_t timeouts;
+    uint16_t arbitrationLost;
+    uint16_t skipped;           /* transfers not attempted while offline */
+    uint8_t consecutiveErrors;
+    uint8_t retryCountdown;
+} i2c_device_stats_t;
+
+void Init_I2C_GPIO(void);
+void I2C_init(void);
+int I2C_read16(unsigned char);
+void I2C_write16(unsigned char pointer, unsigned int writeByte);
+void I2C_setslave(unsigned int slaveAdr);
+
+i2c_status_t I2C_readRegister16(uint8_t slaveAddress, uint8_t pointer, uint16_t *value);
+i2c_status_t I2C_writeRegister16(uint8_t slaveAddress, uint8_t pointer, uint16_t value);
+i2c_status_t I2C_getLastStatus(void);
+void I2C_busClear(void);
+
+bool I2C_submit(i2c_transaction_t *transaction);
+bool I2C_isComplete(const i2c_transaction_t *transaction);
+bool I2C_isIdle(void);
+void I2C_service(void);
+
+const i2c_device_stats_t *I2C_getDeviceStats(uint8_t slaveAddress);
+bool I2C_isDeviceOnline(uint8_t slaveAddress);
+
+
+#endif /* __HAL_I2C_H_ */
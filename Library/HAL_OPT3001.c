@@ -0,0 +1,536 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2015, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+//****************************************************************************
+//
+// HAL_OPT3001.c - Hardware abstraction layer for interfacing OPT3001
+//
+//****************************************************************************
+
+#include <stddef.h>
+#include <ti/devices/msp432p4xx/driverlib/driverlib.h>
+#include "HAL_I2C.h"
+#include "HAL_OPT3001.h"
+
+/* Configuration register as last written */
+static uint16_t configReg = DEFAULT_CONFIG_100;
+
+void OPT3001_init()
+{
+    /* Set Default configuration for OPT3001*/
+    OPT3001_configure(OPT3001_RANGE_AUTO, OPT3001_CONVERSION_100MS, OPT3001_MODE_CONTINUOUS);
+}
+
+/*
+ * Select range, conversion time and mode, e.g.
+ *   OPT3001_configure(OPT3001_RANGE_AUTO, OPT3001_CONVERSION_800MS, OPT3001_MODE_CONTINUOUS)
+ * for low noise readings.  The interrupt pin settings are kept.
+ * Returns false if the sensor did not answer.
+ */
+bool OPT3001_configure(uint16_t range, uint16_t conversionTime, uint16_t mode)
+{
+    uint16_t config;
+
+    config = (configReg & OPT3001_CONFIG_INT_MASK) |
+             (range & OPT3001_CONFIG_RANGE_MASK) |
+             (conversionTime & OPT3001_CONFIG_CT) |
+             (mode & OPT3001_CONFIG_MODE_MASK);
+
+    if (I2C_writeRegister16(OPT3001_SLAVE_ADDRESS, CONFIG_REG, config) != I2C_OK)
+        return false;
+
+    configReg = config;
+    return true;
+}
+
+/*
+ * Start one conversion in single shot mode.  The sensor returns to shutdown
+ * once the result is ready (INT pin / OPT3001_getSampleCount()).
+ */
+bool OPT3001_startConversion()
+{
+    return OPT3001_configure(configReg & OPT3001_CONFIG_RANGE_MASK,
+                             configReg & OPT3001_CONFIG_CT,
+                             OPT3001_MODE_SINGLE_SHOT);
+}
+
+/* Conversion time of the current configuration in ms */
+uint16_t OPT3001_getConversionTimeMs()
+{
+    return (configReg & OPT3001_CONFIG_CT) ? 800 : 100;
+}
+
+unsigned int OPT3001_readManufacturerId()
+{
+    /* Specify slave address for OPT3001 */
+    I2C_setslave(OPT3001_SLAVE_ADDRESS);
+
+    return I2C_read16(MANUFACTUREID_REG);
+}
+unsigned int OPT3001_readDeviceId()
+{
+    /* Specify slave address for OPT3001 */
+    I2C_setslave(OPT3001_SLAVE_ADDRESS);
+
+    return I2C_read16(DEVICEID_REG);
+}
+unsigned int OPT3001_readConfigReg()
+{
+    /* Specify slave address for OPT3001 */
+    I2C_setslave(OPT3001_SLAVE_ADDRESS);
+
+    return I2C_read16(CONFIG_REG);
+}
+unsigned int OPT3001_readLowLimitReg()
+{
+    /* Specify slave address for OPT3001 */
+    I2C_setslave(OPT3001_SLAVE_ADDRESS);
+
+    return I2C_read16(LOWLIMIT_REG);
+}
+unsigned int OPT3001_readHighLimitReg()
+{
+    /* Specify slave address for OPT3001 */
+    I2C_setslave(OPT3001_SLAVE_ADDRESS);
+
+    return I2C_read16(HIGHLIMIT_REG);
+}
+/*
+ * LSB weight of the mantissa in centi-lux for each exponent, 0.01 lux * 2^E.
+ * Exponents 12 to 15 are reserved and convert to 0.
+ */
+static const uint16_t OPT3001_exponentScale[16] =
+{
+    1, 2, 4, 8, 16, 32, 64, 128, 256, 512, 1024, 2048,
+    0, 0, 0, 0
+};
+
+/* Convert a raw result register value to centi-lux (lux * 100), exact */
+static uint32_t OPT3001_convertCentiLux(uint16_t raw)
+{
+    return (uint32_t)(raw & 0x0FFF) * OPT3001_exponentScale[raw >> 12];
+}
+
+/* Background result register read, owned by the I2C transaction engine while queued */
+static i2c_transaction_t luxTransaction;
+static volatile uint32_t lastCentiLux = 0;
+
+/*
+ * INT pin.  In conversion ready mode every falling edge queues a read of the
+ * result register followed by a read of the configuration register, which
+ * releases the latched INT pin for the next conversion.  In limit mode the
+ * pin reports the window comparator, see OPT3001_enableLimitInterrupt().
+ */
+#define INT_MODE_OFF                0
+#define INT_MODE_CONVERSION_READY   1
+#define INT_MODE_LIMIT              2
+
+static i2c_transaction_t clearTransaction;
+static volatile uint8_t intMode = INT_MODE_OFF;
+static volatile uint32_t sampleCount = 0;
+
+/* Limit mode state, written from the INT pin interrupt */
+static volatile opt3001_light_event_t lightEvent = OPT3001_LIGHT_NONE;
+static volatile bool aboveLimit = false;
+static volatile uint32_t lightEventCount = 0;
+
+/*
+ * Blocking read of the result register in centi-lux (lux * 100).  If the
+ * sensor does not answer the last good reading is returned, see I2C_getLastStatus() for the error.
+ * With the conversion ready interrupt enabled no bus access is made, the
+ * value cached from the last completed conversion is returned.
+ */
+uint32_t OPT3001_getCentiLux()
+{
+    uint16_t raw;
+
+    if (intMode == INT_MODE_CONVERSION_READY)
+        return lastCentiLux;
+
+    if (I2C_readRegister16(OPT3001_SLAVE_ADDRESS, RESULT_REG, &raw) == I2C_OK)
+        lastCentiLux = OPT3001_convertCentiLux(raw);
+
+    return lastCentiLux;
+}
+
+/* As OPT3001_getCentiLux(), truncated to whole lux */
+unsigned long int OPT3001_getLux()
+{
+    return OPT3001_getCentiLux() / 100;
+}
+
+/* As OPT3001_getCentiLux(), in lux */
+float OPT3001_getLuxFloat()
+{
+    return OPT3001_getCentiLux() * 0.01f;
+}
+
+static void OPT3001_luxReadComplete(i2c_transaction_t *t)
+{
+    if (t->status == I2C_TRANSACTION_DONE)
+    {
+        lastCentiLux = OPT3001_convertCentiLux(t->data);
+        sampleCount++;
+    }
+}
+
+/*
+ * Queue a non-blocking read of the result register.  The converted value is
+ * available from OPT3001_getLastLux() once the transaction completes.
+ * Returns false if the previous request has not finished yet.
+ */
+bool OPT3001_requestLux()
+{
+    if ((luxTransaction.status == I2C_TRANSACTION_QUEUED) ||
+        (luxTransaction.status == I2C_TRANSACTION_BUSY))
+        return false;
+
+    luxTransaction.slaveAddress = OPT3001_SLAVE_ADDRESS;
+    luxTransaction.pointer = RESULT_REG;
+    luxTransaction.op = I2C_OP_READ16;
+    luxTransaction.callback = OPT3001_luxReadComplete;
+
+    return I2C_submit(&luxTransaction);
+}
+
+/* Most recent lux value read by OPT3001_requestLux() */
+unsigned long int OPT3001_getLastLux()
+{
+    return lastCentiLux / 100;
+}
+
+static bool OPT3001_isPending(const i2c_transaction_t *t)
+{
+    return (t->status == I2C_TRANSACTION_QUEUED) || (t->status == I2C_TRANSACTION_BUSY);
+}
+
+/* Queue the result read and the INT release for one finished conversion */
+static void OPT3001_requestSample(void)
+{
+    if (OPT3001_isPending(&clearTransaction))
+        return;
+
+    OPT3001_requestLux();
+
+    clearTransaction.slaveAddress = OPT3001_SLAVE_ADDRESS;
+    clearTransaction.pointer = CONFIG_REG;
+    clearTransaction.op = I2C_OP_READ16;
+    clearTransaction.callback = NULL;
+
+    I2C_submit(&clearTransaction);
+}
+
+/* Latched mode: the config read that releases INT also says which limit was crossed */
+static void OPT3001_limitFlagsRead(i2c_transaction_t *t)
+{
+    if (t->status != I2C_TRANSACTION_DONE)
+        return;
+
+    if (t->data & OPT3001_CONFIG_FH)
+        lightEvent = OPT3001_LIGHT_HIGH;
+    else if (t->data & OPT3001_CONFIG_FL)
+        lightEvent = OPT3001_LIGHT_LOW;
+    else
+        return;
+
+    aboveLimit = (lightEvent == OPT3001_LIGHT_HIGH);
+    lightEventCount++;
+}
+
+/* Queue the config read that reports and clears the latched comparator flags */
+static void OPT3001_requestLimitFlags(void)
+{
+    if (OPT3001_isPending(&clearTransaction))
+        return;
+
+    clearTransaction.slaveAddress = OPT3001_SLAVE_ADDRESS;
+    clearTransaction.pointer = CONFIG_REG;
+    clearTransaction.op = I2C_OP_READ16;
+    clearTransaction.callback = OPT3001_limitFlagsRead;
+
+    I2C_submit(&clearTransaction);
+}
+
+/* Set the latch bit, keeping the rest of the configuration */
+static bool OPT3001_setLatch(bool latched)
+{
+    uint16_t config = latched ? (configReg | OPT3001_CONFIG_L) : (configReg & ~OPT3001_CONFIG_L);
+
+    if (I2C_writeRegister16(OPT3001_SLAVE_ADDRESS, CONFIG_REG, config) != I2C_OK)
+        return false;
+
+    configReg = config;
+    return true;
+}
+
+/* INT is open drain, active low */
+static void OPT3001_enableIntPin(uint_fast8_t edge)
+{
+    MAP_GPIO_disableInterrupt(OPT3001_INT_PORT, OPT3001_INT_PIN);
+    MAP_GPIO_setAsInputPinWithPullUpResistor(OPT3001_INT_PORT, OPT3001_INT_PIN);
+    MAP_GPIO_interruptEdgeSelect(OPT3001_INT_PORT, OPT3001_INT_PIN, edge);
+    MAP_GPIO_clearInterruptFlag(OPT3001_INT_PORT, OPT3001_INT_PIN);
+    MAP_GPIO_enableInterrupt(OPT3001_INT_PORT, OPT3001_INT_PIN);
+    MAP_Interrupt_enableInterrupt(OPT3001_INT_INTERRUPT);
+}
+
+/*
+ * Transparent limit mode: arm the edge that leaves the level INT is at now
+ * and return that level, true when the light is above the limit.  A change
+ * while re-arming is caught by reading the pin again after the flag, which
+ * writing PxIES may set, is cleared.
+ */
+static bool OPT3001_armLevelChange(void)
+{
+    bool above;
+
+    do
+    {
+        above = !MAP_GPIO_getInputPinValue(OPT3001_INT_PORT, OPT3001_INT_PIN);
+        MAP_GPIO_interruptEdgeSelect(OPT3001_INT_PORT, OPT3001_INT_PIN,
+            above ? GPIO_LOW_TO_HIGH_TRANSITION : GPIO_HIGH_TO_LOW_TRANSITION);
+        MAP_GPIO_clearInterruptFlag(OPT3001_INT_PORT, OPT3001_INT_PIN);
+    } while (above != !MAP_GPIO_getInputPinValue(OPT3001_INT_PORT, OPT3001_INT_PIN));
+
+    return above;
+}
+
+/*
+ * Convert centi-lux to the limit register format, rounded down to the
+ * nearest value the register can hold.
+ */
+static uint16_t OPT3001_encodeLimit(uint32_t centiLux)
+{
+    uint16_t exponent = 0;
+
+    while ((centiLux > 0x0FFF) && (exponent < 11))
+    {
+        centiLux >>= 1;
+        exponent++;
+    }
+
+    if (centiLux > 0x0FFF)
+        centiLux = 0x0FFF;
+
+    return (exponent << 12) | (uint16_t)centiLux;
+}
+
+/*
+ * Program the low and high limit registers, in centi-lux.
+ * Returns false if the sensor did not answer.
+ */
+bool OPT3001_setLimits(uint32_t lowCentiLux, uint32_t highCentiLux)
+{
+    if (I2C_writeRegister16(OPT3001_SLAVE_ADDRESS, LOWLIMIT_REG, OPT3001_encodeLimit(lowCentiLux)) != I2C_OK)
+        return false;
+
+    return I2C_writeRegister16(OPT3001_SLAVE_ADDRESS, HIGHLIMIT_REG, OPT3001_encodeLimit(highCentiLux)) == I2C_OK;
+}
+
+/*
+ * Switch the INT pin to end-of-conversion mode and sample on every
+ * conversion.  Needs I2C_init() and OPT3001_init() first.
+ */
+void OPT3001_enableConversionReadyInterrupt()
+{
+    /* Exponent field 1100b in the low limit register selects end-of-conversion mode */
+    I2C_writeRegister16(OPT3001_SLAVE_ADDRESS, LOWLIMIT_REG, END_OF_CONVERSION_LIMIT);
+
+    /* INT stays low until the configuration register is read */
+    OPT3001_setLatch(true);
+
+    OPT3001_enableIntPin(GPIO_HIGH_TO_LOW_TRANSITION);
+    intMode = INT_MODE_CONVERSION_READY;
+
+    /* A conversion may already have finished and latched INT low */
+    OPT3001_service();
+}
+
+/*
+ * Go back to reading the sensor on every OPT3001_getLux() call.
+ */
+void OPT3001_disableConversionReadyInterrupt()
+{
+    MAP_GPIO_disableInterrupt(OPT3001_INT_PORT, OPT3001_INT_PIN);
+    intMode = INT_MODE_OFF;
+}
+
+/*
+ * Report brightness threshold crossings on the INT pin, limits in centi-lux.
+ *
+ * latched = false (transparent): the limits give hysteresis.  INT goes low
+ * when the light rises above the high limit and is released when it falls
+ * below the low limit.  Both edges are caught, so no I2C traffic is needed.
+ *
+ * latched = true (window): INT goes low when the light leaves the window
+ * [low, high] and stays low until the configuration register is read.  That
+ * one read, made from the interrupt, tells which limit was crossed.
+ *
+ * Events are collected with OPT3001_getLightEvent().  Replaces the conversion
+ * ready interrupt, OPT3001_getLux() reads the sensor again.
+ */
+bool OPT3001_enableLimitInterrupt(uint32_t lowCentiLux, uint32_t highCentiLux, bool latched)
+{
+    bool wasDisabled;
+
+    intMode = INT_MODE_OFF;
+    MAP_GPIO_disableInterrupt(OPT3001_INT_PORT, OPT3001_INT_PIN);
+
+    if (!OPT3001_setLimits(lowCentiLux, highCentiLux) || !OPT3001_setLatch(latched))
+        return false;
+
+    wasDisabled = MAP_Interrupt_disableMaster();
+
+    lightEvent = OPT3001_LIGHT_NONE;
+
+    if (latched)
+    {
+        aboveLimit = false;
+        OPT3001_enableIntPin(GPIO_HIGH_TO_LOW_TRANSITION);
+    }
+    else
+    {
+        /* Start from the current pin level and wait for it to change */
+        OPT3001_enableIntPin(GPIO_HIGH_TO_LOW_TRANSITION);
+        aboveLimit = OPT3001_armLevelChange();
+    }
+
+    intMode = INT_MODE_LIMIT;
+
+    if (!wasDisabled)
+        MAP_Interrupt_enableMaster();
+
+    /* Window already left before the edge interrupt was armed */
+    OPT3001_service();
+
+    return true;
+}
+
+/*
+ * Stop reporting threshold crossings.
+ */
+void OPT3001_disableLimitInterrupt()
+{
+    MAP_GPIO_disableInterrupt(OPT3001_INT_PORT, OPT3001_INT_PIN);
+    intMode = INT_MODE_OFF;
+}
+
+/*
+ * Most recent threshold crossing since the last call, OPT3001_LIGHT_NONE if
+ * there was none.  A memory read, safe to call every loop.
+ */
+opt3001_light_event_t OPT3001_getLightEvent()
+{
+    opt3001_light_event_t event = lightEvent;
+
+    lightEvent = OPT3001_LIGHT_NONE;
+    return event;
+}
+
+/* true after crossing the high limit, false after crossing the low limit */
+bool OPT3001_isAboveLimit()
+{
+    return aboveLimit;
+}
+
+/* Number of threshold crossings since the limit interrupt was enabled */
+uint32_t OPT3001_getLightEventCount()
+{
+    return lightEventCount;
+}
+
+/*
+ * Recover from a missed edge.  If a latched INT is still held low once the
+ * queued reads have finished (e.g. the release read failed) the reads are
+ * requested again.  Cheap, call from the main loop.
+ */
+void OPT3001_service()
+{
+    if (((intMode == INT_MODE_CONVERSION_READY) || ((intMode == INT_MODE_LIMIT) && (configReg & OPT3001_CONFIG_L))) &&
+        !MAP_GPIO_getInputPinValue(OPT3001_INT_PORT, OPT3001_INT_PIN) &&
+        !OPT3001_isPending(&clearTransaction))
+    {
+        if (intMode == INT_MODE_CONVERSION_READY)
+            OPT3001_requestSample();
+        else
+            OPT3001_requestLimitFlags();
+    }
+}
+
+/* Number of conversions read since reset */
+uint32_t OPT3001_getSampleCount()
+{
+    return sampleCount;
+}
+
+/*
+ * OPT3001 INT pin interrupt
+ */
+void PORT4_IRQHandler(void)
+{
+    uint32_t status;
+    bool above;
+
+    status = MAP_GPIO_getEnabledInterruptStatus(OPT3001_INT_PORT);
+    MAP_GPIO_clearInterruptFlag(OPT3001_INT_PORT, status);
+
+    if (!(status & OPT3001_INT_PIN))
+        return;
+
+    switch (intMode)
+    {
+    case INT_MODE_CONVERSION_READY:
+        OPT3001_requestSample();
+        break;
+
+    case INT_MODE_LIMIT:
+        if (configReg & OPT3001_CONFIG_L)
+        {
+            OPT3001_requestLimitFlags();
+        }
+        else
+        {
+            /* Transparent, the pin level is the comparator output.  A
+               pulse shorter than the interrupt latency is not an event. */
+            above = OPT3001_armLevelChange();
+            if (above != aboveLimit)
+            {
+                aboveLimit = above;
+                lightEvent = above ? OPT3001_LIGHT_HIGH : OPT3001_LIGHT_LOW;
+                lightEventCount++;
+            }
+        }
+        break;
+
+    default:
+        break;
+    }
+}
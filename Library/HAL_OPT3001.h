@@ -38,10 +38,23 @@
 #ifndef __HAL_OPT3001_H_
 #define __HAL_OPT3001_H_
 
+#include <stdint.h>
+#include <stdbool.h>
+
 /*CONSTANTS*/
 #define OPT3001_SLAVE_ADDRESS 0x47
 
-#define OPT_INTERRUPT_PIN 11
+#define OPT_INTERRUPT_PIN 5
+/*
+ * INT on BoosterPack pin 5 (J1.5), P4.1 on the LaunchPad.  Not the sensor
+ * BoosterPack's J2.11: that is P3.6, the right motor driver's nSLP on the
+ * RSLK, and INT pulling it low would put the motor to sleep.  Wire INT to
+ * J1.5 and leave J2.11 of the sensor board unconnected.
+ */
+#define OPT3001_INT_PORT GPIO_PORT_P4
+#define OPT3001_INT_PIN GPIO_PIN1
+#define OPT3001_INT_INTERRUPT INT_PORT4
+
 #define RESULT_REG 0x00
 #define CONFIG_REG 0x01
 #define LOWLIMIT_REG 0x02
@@ -52,6 +65,25 @@
 #define DEFAULT_CONFIG 0xCC10 // 800ms
 #define DEFAULT_CONFIG_100 0xC410 // 100ms
 
+/* Configuration register fields, see OPT3001_configure() */
+#define OPT3001_CONFIG_RANGE_MASK   0xF000
+#define OPT3001_CONFIG_CT           0x0800
+#define OPT3001_CONFIG_MODE_MASK    0x0600
+#define OPT3001_CONFIG_INT_MASK     0x001F  // L, POL, ME, FC1, FC0
+#define OPT3001_CONFIG_FH           0x0040
+#define OPT3001_CONFIG_FL           0x0020
+#define OPT3001_CONFIG_L            0x0010
+
+#define OPT3001_RANGE_AUTO          0xC000
+#define OPT3001_RANGE_FULL_SCALE(n) ((uint16_t)(n) << 12)  // n = 0 (40.95 lux) to 11 (83865.6 lux)
+#define OPT3001_CONVERSION_100MS    0x0000
+#define OPT3001_CONVERSION_800MS    0x0800
+#define OPT3001_MODE_SHUTDOWN       0x0000
+#define OPT3001_MODE_SINGLE_SHOT    0x0200
+#define OPT3001_MODE_CONTINUOUS     0x0400
+
+#define END_OF_CONVERSION_LIMIT 0xC000 // low limit exponent 1100b, INT flags every conversion
+
 /* CONFIG REGISTER BITS: RN3 RN2 RN1 RN0 CT M1 M0 OVF CRF FH FL L Pol ME FC1 FC0
 RN3 to RN0 = Range select:
 1100 by default, enables auto-range
@@ -78,8 +110,33 @@ ME (Bit 2) � Exponent mask. In fixed range modes masks the exponent bits in th
 FC1 to FC0 - Fault count bits. Read/write bits. Default �00� - the first fault will trigger the alert pin.
 */
 
+/* Brightness threshold crossing reported by the limit interrupt */
+typedef enum
+{
+    OPT3001_LIGHT_NONE = 0,
+    OPT3001_LIGHT_HIGH,     // rose above the high limit
+    OPT3001_LIGHT_LOW       // fell below the low limit
+} opt3001_light_event_t;
+
 void OPT3001_init(void);
+bool OPT3001_configure(uint16_t range, uint16_t conversionTime, uint16_t mode);
+bool OPT3001_startConversion(void);
+uint16_t OPT3001_getConversionTimeMs(void);
+uint32_t OPT3001_getCentiLux(void);
 unsigned long int OPT3001_getLux(void);
+float OPT3001_getLuxFloat(void);
+bool OPT3001_requestLux(void);
+unsigned long int OPT3001_getLastLux(void);
+void OPT3001_enableConversionReadyInterrupt(void);
+void OPT3001_disableConversionReadyInterrupt(void);
+bool OPT3001_setLimits(uint32_t lowCentiLux, uint32_t highCentiLux);
+bool OPT3001_enableLimitInterrupt(uint32_t lowCentiLux, uint32_t highCentiLux, bool latched);
+void OPT3001_disableLimitInterrupt(void);
+opt3001_light_event_t OPT3001_getLightEvent(void);
+bool OPT3001_isAboveLimit(void);
+uint32_t OPT3001_getLightEventCount(void);
+void OPT3001_service(void);
+uint32_t OPT3001_getSampleCount(void);
 unsigned int OPT3001_readManufacturerId(void);
 unsigned int OPT3001_readDeviceId(void);
 unsigned int OPT3001_readConfigReg(void);
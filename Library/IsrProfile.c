@@ -0,0 +1,382 @@
+/*
+ * IsrProfile.c
+ *
+ * Interrupt latency and CPU load profiler.  See IsrProfile.h.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include "msp.h"
+#include <ti/devices/msp432p4xx/driverlib/driverlib.h>
+#include "IsrProfile.h"
+#include "Clock.h"
+
+isr_profile_t isr_profile;
+
+/* Default budgets, in 0.01 % of the CPU */
+static const struct
+{
+    const char *name;
+    uint16_t budget;
+} isr_defaults[NUM_ISR_VECTORS] =
+{
+    { "SysTick", 200 },     // ISR_SYSTICK, 1 kHz tick and I2C timeouts
+    { "PORT1",   50  },     // ISR_PORT1, buttons
+    { "PORT5",   500 },     // ISR_PORT5, encoder edges at full speed
+};
+
+static uint32_t cycles_per_ms = 48000;
+
+// Per nesting level, the entry time and the cycles spent in preempting handlers
+static uint32_t entry_time[ISR_PROFILE_MAX_DEPTH];
+static uint32_t nested_cycles[ISR_PROFILE_MAX_DEPTH];
+
+// Running total of cycles in profiled handlers, wraps
+static volatile uint32_t isr_cycles;
+
+static uint32_t window_start;
+static uint32_t window_idle;
+static uint32_t idle_start_time;
+static uint32_t idle_start_isr_cycles;
+
+/*
+ *  Clock change handler.  The loads are ratios of MCLK cycles, so a window
+ *  with cycles at two rates in it would weigh them wrongly: drop what the
+ *  window has so far and start a new one at the new MCLK.
+ */
+static void isr_profile_clock_changed(void)
+{
+    bool wasDisabled;
+    uint8_t i;
+
+    wasDisabled = MAP_Interrupt_disableMaster();
+
+    cycles_per_ms = Clock_GetMCLK() / 1000;
+    if (cycles_per_ms == 0)
+        cycles_per_ms = 1;
+
+    for (i = 0; i < NUM_ISR_VECTORS; i++)
+    {
+        isr_profile.vectors[i].window_count = 0;
+        isr_profile.vectors[i].window_cycles = 0;
+    }
+
+    window_start = DWT->CYCCNT;
+    window_idle = 0;
+
+    // A wait the change happened in only counts from here
+    idle_start_time = window_start;
+    idle_start_isr_cycles = isr_cycles;
+
+    if (!wasDisabled)
+        MAP_Interrupt_enableMaster();
+}
+
+/*
+ *  Start the cycle counter and clear all figures.
+ */
+void isr_profile_init(void)
+{
+    uint8_t i;
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    isr_profile_clock_changed();
+    Clock_AddChangeHandler(isr_profile_clock_changed);
+
+    for (i = 0; i < NUM_ISR_VECTORS; i++)
+    {
+        isr_profile.vectors[i].name = isr_defaults[i].name;
+        isr_profile.vectors[i].budget = isr_defaults[i].budget;
+    }
+
+    isr_profile_reset();
+}
+
+/*
+ *  Clear all figures, keeping the names and budgets.
+ */
+void isr_profile_reset(void)
+{
+    isr_stat_t *s;
+    bool wasDisabled;
+    uint8_t i;
+
+    wasDisabled = MAP_Interrupt_disableMaster();
+
+    for (i = 0; i < NUM_ISR_VECTORS; i++)
+    {
+        s = &isr_profile.vectors[i];
+
+        s->count = 0;
+        s->exec_last = 0;
+        s->exec_max = 0;
+        s->exec_total = 0;
+        s->latency_count = 0;
+        s->latency_last = 0;
+        s->latency_max = 0;
+        s->latency_total = 0;
+        s->nested = 0;
+        s->max_depth = 0;
+        s->rate = 0;
+        s->load = 0;
+        s->peak_load = 0;
+        s->over_budget = false;
+        s->window_count = 0;
+        s->window_cycles = 0;
+    }
+
+    isr_profile.isr_load = 0;
+    isr_profile.main_load = 0;
+    isr_profile.idle_load = 0;
+    isr_profile.peak_isr_load = 0;
+    isr_profile.windows = 0;
+
+    window_start = DWT->CYCCNT;
+    window_idle = 0;
+
+    if (!wasDisabled)
+        MAP_Interrupt_enableMaster();
+}
+
+void isr_profile_set_budget(isr_vector_t vector, uint16_t hundredths_percent)
+{
+    if (vector < NUM_ISR_VECTORS)
+        isr_profile.vectors[vector].budget = hundredths_percent;
+}
+
+/*
+ *  Called by a wrapper before it runs the handler.
+ *
+ *  latency is the entry latency in cycles or ISR_NO_LATENCY.  A handler that
+ *  preempts this one runs its own enter and exit in between, so the depth
+ *  is back where it was by the time this one exits.
+ */
+void isr_profile_enter(isr_vector_t vector, uint32_t latency)
+{
+    isr_stat_t *s = &isr_profile.vectors[vector];
+    uint8_t depth = isr_profile.depth++;
+
+    if (depth < ISR_PROFILE_MAX_DEPTH)
+    {
+        nested_cycles[depth] = 0;
+        entry_time[depth] = DWT->CYCCNT;
+    }
+
+    s->count++;
+    s->window_count++;
+
+    if (depth > 0)
+        s->nested++;
+
+    if (depth + 1 > s->max_depth)
+        s->max_depth = depth + 1;
+
+    if (latency != ISR_NO_LATENCY)
+    {
+        s->latency_count++;
+        s->latency_last = latency;
+        s->latency_total += latency;
+        if (latency > s->latency_max)
+            s->latency_max = latency;
+    }
+}
+
+/*
+ *  Called by a wrapper after the handler returns.
+ */
+void isr_profile_exit(isr_vector_t vector)
+{
+    isr_stat_t *s = &isr_profile.vectors[vector];
+    uint32_t now = DWT->CYCCNT;
+    uint8_t depth = --isr_profile.depth;
+    uint32_t total;
+    uint32_t exec;
+
+    if (depth >= ISR_PROFILE_MAX_DEPTH)
+        return;
+
+    total = now - entry_time[depth];
+    exec = total - nested_cycles[depth];
+
+    if (depth > 0)
+        nested_cycles[depth - 1] += total;
+    else
+        isr_cycles += total;
+
+    s->exec_last = exec;
+    s->exec_total += exec;
+    s->window_cycles += exec;
+    if (exec > s->exec_max)
+        s->exec_max = exec;
+}
+
+/*
+ *  Mark the main loop's wait, for example around Clock_Delay1ms().  Interrupt
+ *  time during the wait is not counted as idle.
+ */
+void isr_profile_idle_start(void)
+{
+    idle_start_isr_cycles = isr_cycles;
+    idle_start_time = DWT->CYCCNT;
+}
+
+void isr_profile_idle_end(void)
+{
+    uint32_t elapsed = DWT->CYCCNT - idle_start_time;
+    uint32_t in_isr = isr_cycles - idle_start_isr_cycles;
+
+    if (elapsed > in_isr)
+        window_idle += elapsed - in_isr;
+}
+
+static uint16_t hundredths(uint32_t part, uint32_t whole)
+{
+    if (part >= whole)
+        return 10000;
+
+    return (uint16_t)(((uint64_t)part * 10000) / whole);
+}
+
+/*
+ *  Close the load window once ISR_PROFILE_WINDOW_MS have passed.  Call once
+ *  per main loop pass.  Returns true when new load figures are available.
+ */
+bool isr_profile_update(void)
+{
+    uint32_t window_cycles[NUM_ISR_VECTORS];
+    uint32_t window_count[NUM_ISR_VECTORS];
+    uint32_t elapsed;
+    uint32_t isr_total = 0;
+    uint32_t now;
+    bool wasDisabled;
+    isr_stat_t *s;
+    uint8_t i;
+
+    now = DWT->CYCCNT;
+    elapsed = now - window_start;
+
+    if (elapsed < ISR_PROFILE_WINDOW_MS * cycles_per_ms)
+        return false;
+
+    // Take the window's figures in one go so no handler is half counted
+    wasDisabled = MAP_Interrupt_disableMaster();
+    for (i = 0; i < NUM_ISR_VECTORS; i++)
+    {
+        window_cycles[i] = isr_profile.vectors[i].window_cycles;
+        window_count[i] = isr_profile.vectors[i].window_count;
+        isr_profile.vectors[i].window_cycles = 0;
+        isr_profile.vectors[i].window_count = 0;
+    }
+    if (!wasDisabled)
+        MAP_Interrupt_enableMaster();
+
+    for (i = 0; i < NUM_ISR_VECTORS; i++)
+    {
+        s = &isr_profile.vectors[i];
+
+        s->load = hundredths(window_cycles[i], elapsed);
+        s->rate = (uint32_t)(((uint64_t)window_count[i] * 1000 * cycles_per_ms) / elapsed);
+        s->over_budget = (s->load > s->budget);
+        if (s->load > s->peak_load)
+            s->peak_load = s->load;
+
+        isr_total += window_cycles[i];
+    }
+
+    isr_profile.isr_load = hundredths(isr_total, elapsed);
+    isr_profile.idle_load = hundredths(window_idle, elapsed);
+    if (isr_profile.isr_load + isr_profile.idle_load > 10000)
+        isr_profile.idle_load = 10000 - isr_profile.isr_load;
+    isr_profile.main_load = 10000 - isr_profile.isr_load - isr_profile.idle_load;
+    if (isr_profile.isr_load > isr_profile.peak_isr_load)
+        isr_profile.peak_isr_load = isr_profile.isr_load;
+    isr_profile.windows++;
+
+    window_start = now;
+    window_idle = 0;
+
+    return true;
+}
+
+/*
+ *  Print the per vector budget table.  Times are in cycles, loads in percent
+ *  of the CPU over the last window.
+ */
+void isr_profile_report(void)
+{
+    const isr_stat_t *s;
+    uint8_t i;
+
+    printf("%-8s %8s %7s %8s %8s %8s %8s %6s %6s %6s %7s\n", "vector", "calls", "rate/s",
+           "exec avg", "exec max", "lat avg", "lat max", "nested", "load%", "peak%", "budget%");
+
+    for (i = 0; i < NUM_ISR_VECTORS; i++)
+    {
+        s = &isr_profile.vectors[i];
+
+        printf("%-8s %8lu %7lu %8lu %8lu ", s->name,
+               (unsigned long)s->count, (unsigned long)s->rate,
+               (unsigned long)(s->count ? s->exec_total / s->count : 0),
+               (unsigned long)s->exec_max);
+
+        if (s->latency_count)
+            printf("%8lu %8lu ", (unsigned long)(s->latency_total / s->latency_count),
+                   (unsigned long)s->latency_max);
+        else
+            printf("%8s %8s ", "-", "-");
+
+        printf("%6lu %3u.%02u %3u.%02u %4u.%02u%s\n", (unsigned long)s->nested,
+               s->load / 100, s->load % 100,
+               s->peak_load / 100, s->peak_load % 100,
+               s->budget / 100, s->budget % 100,
+               s->over_budget ? " OVER" : "");
+    }
+
+    printf("cpu: interrupts %u.%02u%%  main loop %u.%02u%%  idle %u.%02u%%\n",
+           isr_profile.isr_load / 100, isr_profile.isr_load % 100,
+           isr_profile.main_load / 100, isr_profile.main_load % 100,
+           isr_profile.idle_load / 100, isr_profile.idle_load % 100);
+}
+
+//-----------------------------------
+//        Vector table wrappers
+//-----------------------------------
+
+/*
+ * Always built: the library is compiled once for every lab, and these are
+ * only linked in when the startup file refers to them under ISR_PROFILE.
+ */
+void SysTick_Handler(void);
+void PORT1_IRQHandler(void);
+void PORT5_IRQHandler(void);
+
+/*
+ * The SysTick interrupt is raised as the counter goes from 1 to 0 and the
+ * next clock reloads it, so the counter tells how long ago that was.
+ */
+void SysTick_ProfiledHandler(void)
+{
+    uint32_t val = SysTick->VAL;
+    uint32_t latency = val ? (SysTick->LOAD + 1 - val) : 0;
+
+    isr_profile_enter(ISR_SYSTICK, latency);
+    SysTick_Handler();
+    isr_profile_exit(ISR_SYSTICK);
+}
+
+void PORT1_ProfiledIRQHandler(void)
+{
+    isr_profile_enter(ISR_PORT1, ISR_NO_LATENCY);
+    PORT1_IRQHandler();
+    isr_profile_exit(ISR_PORT1);
+}
+
+void PORT5_ProfiledIRQHandler(void)
+{
+    isr_profile_enter(ISR_PORT5, ISR_NO_LATENCY);
+    PORT5_IRQHandler();
+    isr_profile_exit(ISR_PORT5);
+}
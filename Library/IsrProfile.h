@@ -0,0 +1,105 @@
+/*
+ *  IsrProfile.h
+ *
+ *  Interrupt latency and CPU load profiler.
+ *
+ *  With ISR_PROFILE defined, startup_msp432p401r_ccs.c points the SysTick,
+ *  PORT1 and PORT5 vectors at the wrappers in IsrProfile.c instead of the
+ *  handlers themselves.  Each wrapper times its handler with the DWT cycle
+ *  counter and records, per vector:
+ *
+ *    - execution time, excluding any handler that preempted it
+ *    - entry latency, for SysTick only: the cycles from the counter reaching
+ *      zero to the wrapper running.  The port interrupts have no timestamp
+ *      of the edge that raised them.
+ *    - nesting: how often the handler preempted another and the deepest
+ *      nesting level it ran at
+ *
+ *  The main loop marks the time it spends waiting with isr_profile_idle_start()
+ *  and isr_profile_idle_end() and calls isr_profile_update() once per pass.
+ *  Every ISR_PROFILE_WINDOW_MS the CPU time is split into interrupt, main
+ *  loop and idle load, and each vector's load and rate are compared with its
+ *  budget.  Everything is kept in isr_profile for the debugger and
+ *  isr_profile_report() prints the budget table.
+ */
+#ifndef ISRPROFILE_H_
+#define ISRPROFILE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define ISR_PROFILE_WINDOW_MS   1000    // load is measured over this window
+#define ISR_PROFILE_MAX_DEPTH   4       // deepest nesting tracked
+#define ISR_NO_LATENCY          0xFFFFFFFF
+
+typedef enum
+{
+    ISR_SYSTICK = 0,
+    ISR_PORT1,
+    ISR_PORT5,
+    NUM_ISR_VECTORS
+} isr_vector_t;
+
+typedef struct
+{
+    const char *name;
+    uint16_t budget;            // CPU share the vector is allowed, 0.01 %
+
+    uint32_t count;             // calls since reset
+    uint32_t exec_last;         // cycles, nested handlers excluded
+    uint32_t exec_max;
+    uint64_t exec_total;
+
+    uint32_t latency_count;     // calls with a measured latency
+    uint32_t latency_last;      // cycles
+    uint32_t latency_max;
+    uint64_t latency_total;
+
+    uint32_t nested;            // calls that preempted another handler
+    uint8_t max_depth;          // 1 = never preempted anything
+
+    // Last complete window
+    uint32_t rate;              // calls per second
+    uint16_t load;              // 0.01 %
+    uint16_t peak_load;
+    bool over_budget;
+
+    // Window being measured
+    uint32_t window_count;
+    uint32_t window_cycles;
+} isr_stat_t;
+
+typedef struct
+{
+    isr_stat_t vectors[NUM_ISR_VECTORS];
+
+    // Last complete window, in 0.01 % of the CPU
+    uint16_t isr_load;
+    uint16_t main_load;
+    uint16_t idle_load;
+    uint16_t peak_isr_load;
+    uint32_t windows;           // completed windows
+
+    uint8_t depth;              // handlers currently running
+} isr_profile_t;
+
+extern isr_profile_t isr_profile;
+
+void isr_profile_init(void);
+void isr_profile_reset(void);
+void isr_profile_set_budget(isr_vector_t vector, uint16_t hundredths_percent);
+
+void isr_profile_enter(isr_vector_t vector, uint32_t latency);
+void isr_profile_exit(isr_vector_t vector);
+
+void isr_profile_idle_start(void);
+void isr_profile_idle_end(void);
+bool isr_profile_update(void);
+void isr_profile_report(void);
+
+// Vector table entries used with ISR_PROFILE
+void SysTick_ProfiledHandler(void);
+void PORT1_ProfiledIRQHandler(void);
+void PORT5_ProfiledIRQHandler(void);
+
+#endif /* ISRPROFILE_H_ */
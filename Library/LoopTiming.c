@@ -0,0 +1,224 @@
+/*
+ * LoopTiming.c
+ *
+ * Main loop timing and jitter instrumentation.  See LoopTiming.h.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "msp.h"
+#include <ti/devices/msp432p4xx/driverlib/driverlib.h>
+#include "LoopTiming.h"
+#include "Clock.h"
+
+loop_timing_t loop_timing;
+
+static uint32_t cycles_per_us = 48;
+
+/*
+ *  Clear the figures of one statistic, keeping its name and histogram layout.
+ */
+static void lt_clear(lt_stat_t *stat)
+{
+    uint8_t i;
+
+    stat->last = 0;
+    stat->min = 0xFFFFFFFF;
+    stat->max = 0;
+    stat->max_iteration = 0;
+    stat->count = 0;
+    stat->total = 0;
+
+    for (i = 0; i < LT_NUM_BUCKETS; i++)
+        stat->histogram[i] = 0;
+}
+
+/*
+ *  Start an interval at now.
+ */
+static void lt_mark(lt_stat_t *stat, uint32_t now)
+{
+    stat->started = now;
+    stat->carried = 0;
+}
+
+/*
+ *  Microseconds since a statistic's start mark.
+ */
+static uint32_t lt_elapsed_us(const lt_stat_t *stat, uint32_t now)
+{
+    return stat->carried + (now - stat->started) / cycles_per_us;
+}
+
+/*
+ *  Add the interval that ends now to a statistic.
+ */
+static void lt_record(lt_stat_t *stat, uint32_t now)
+{
+    uint32_t us = lt_elapsed_us(stat, now);
+    uint32_t bucket;
+
+    stat->last = us;
+    stat->count++;
+    stat->total += us;
+
+    if (us < stat->min)
+        stat->min = us;
+
+    if (us > stat->max)
+    {
+        stat->max = us;
+        stat->max_iteration = loop_timing.iteration;
+    }
+
+    bucket = (us > stat->origin) ? (us - stat->origin) / stat->bucket_width : 0;
+    if (bucket >= LT_NUM_BUCKETS)
+        bucket = LT_NUM_BUCKETS - 1;
+
+    stat->histogram[bucket]++;
+}
+
+/*
+ *  Clock change handler: count the cycles of every open interval so far at
+ *  the old MCLK, the rest at the new one
+ */
+static void lt_clock_changed(void)
+{
+    uint32_t now = DWT->CYCCNT;
+    uint8_t i;
+
+    loop_timing.period.carried = lt_elapsed_us(&loop_timing.period, now);
+    loop_timing.period.started = now;
+    loop_timing.exec.carried = lt_elapsed_us(&loop_timing.exec, now);
+    loop_timing.exec.started = now;
+
+    for (i = 0; i < loop_timing.num_sections; i++)
+    {
+        loop_timing.sections[i].carried = lt_elapsed_us(&loop_timing.sections[i], now);
+        loop_timing.sections[i].started = now;
+    }
+
+    cycles_per_us = Clock_GetMCLK() / 1000000;
+    if (cycles_per_us == 0)
+        cycles_per_us = 1;
+}
+
+/*
+ *  Start timing the main loop.
+ *
+ *  period_us is the intended loop period.  The period histogram is centred on
+ *  it, each bucket 1/32 of the period wide, so it spans +/- 25%.  budget_us is
+ *  the execution time allowed per iteration, longer iterations are counted in
+ *  loop_timing.overruns.  Section names are not copied.
+ */
+void lt_init(const char *const *section_names, uint8_t num_sections,
+             uint32_t period_us, uint32_t budget_us)
+{
+    uint32_t width;
+    uint8_t i;
+
+    if (num_sections > LT_MAX_SECTIONS)
+        num_sections = LT_MAX_SECTIONS;
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    lt_clock_changed();
+    Clock_AddChangeHandler(lt_clock_changed);
+
+    loop_timing.budget_us = budget_us;
+    loop_timing.num_sections = num_sections;
+
+    width = period_us / 32;
+    if (width == 0)
+        width = 1;
+
+    loop_timing.period.name = "period";
+    lt_set_histogram(&loop_timing.period, period_us - (LT_NUM_BUCKETS / 2) * width, width);
+
+    loop_timing.exec.name = "exec";
+    lt_set_histogram(&loop_timing.exec, 0, LT_EXEC_BUCKET_US);
+
+    for (i = 0; i < num_sections; i++)
+    {
+        loop_timing.sections[i].name = section_names[i];
+        lt_set_histogram(&loop_timing.sections[i], 0, LT_SECTION_BUCKET_US);
+    }
+
+    lt_reset();
+}
+
+/*
+ *  Clear all figures, for example after start up or from the debugger.
+ */
+void lt_reset(void)
+{
+    uint8_t i;
+
+    loop_timing.iteration = 0;
+    loop_timing.overruns = 0;
+
+    lt_clear(&loop_timing.period);
+    lt_clear(&loop_timing.exec);
+
+    for (i = 0; i < loop_timing.num_sections; i++)
+        lt_clear(&loop_timing.sections[i]);
+}
+
+/*
+ *  Change the histogram range of a statistic and clear it.
+ */
+void lt_set_histogram(lt_stat_t *stat, uint32_t origin_us, uint32_t bucket_width_us)
+{
+    stat->origin = origin_us;
+    stat->bucket_width = bucket_width_us ? bucket_width_us : 1;
+    lt_clear(stat);
+}
+
+/*
+ *  Mark the start of a loop iteration, call first thing in the loop.
+ */
+void lt_loop_start(void)
+{
+    uint32_t now = DWT->CYCCNT;
+
+    // No period until the second iteration
+    if (loop_timing.iteration > 0)
+        lt_record(&loop_timing.period, now);
+
+    lt_mark(&loop_timing.period, now);
+    lt_mark(&loop_timing.exec, now);
+}
+
+/*
+ *  Mark the end of the work in a loop iteration, call before the loop waits.
+ */
+void lt_loop_end(void)
+{
+    lt_record(&loop_timing.exec, DWT->CYCCNT);
+
+    if (loop_timing.exec.last > loop_timing.budget_us)
+        loop_timing.overruns++;
+
+    loop_timing.iteration++;
+}
+
+void lt_section_start(uint8_t section)
+{
+    if (section < loop_timing.num_sections)
+        lt_mark(&loop_timing.sections[section], DWT->CYCCNT);
+}
+
+void lt_section_end(uint8_t section)
+{
+    if (section < loop_timing.num_sections)
+        lt_record(&loop_timing.sections[section], DWT->CYCCNT);
+}
+
+/*
+ *  Average of a statistic in us.
+ */
+uint32_t lt_average(const lt_stat_t *stat)
+{
+    return stat->count ? (uint32_t)(stat->total / stat->count) : 0;
+}
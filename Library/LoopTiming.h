@@ -0,0 +1,75 @@
+/*
+ *  LoopTiming.h
+ *
+ *  Main loop timing and jitter instrumentation.
+ *
+ *  The main loop marks the start and end of every iteration and of each named
+ *  section inside it.  Timestamps come from the DWT cycle counter and are
+ *  kept in microseconds so the figures can be read directly in the debugger:
+ *
+ *    loop_timing.period      start of one iteration to the start of the next
+ *    loop_timing.exec        start to end of an iteration (the work done)
+ *    loop_timing.sections[]  start to end of each section
+ *
+ *  Each keeps the last, minimum, average and worst case value, the iteration
+ *  the worst case happened on and a fixed bucket histogram.  The last bucket
+ *  also counts everything above the histogram range.  An interval the MCLK
+ *  changed in counts its cycles at the rate each ran at.
+ */
+#ifndef LOOPTIMING_H_
+#define LOOPTIMING_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define LT_NUM_BUCKETS      16
+#define LT_MAX_SECTIONS     8
+
+#define LT_EXEC_BUCKET_US       100     // exec histogram 0 - 1.6 ms
+#define LT_SECTION_BUCKET_US    25      // section histograms 0 - 400 us
+
+typedef struct
+{
+    const char *name;
+    uint32_t last;              // us
+    uint32_t min;
+    uint32_t max;               // worst case
+    uint32_t max_iteration;     // loop iteration of the worst case
+    uint32_t count;
+    uint64_t total;             // for the average, total / count
+
+    uint32_t origin;            // us, lower edge of bucket 0
+    uint32_t bucket_width;      // us
+    uint32_t histogram[LT_NUM_BUCKETS];
+
+    uint32_t started;           // CYCCNT at the last start mark, or the last clock change since
+    uint32_t carried;           // us counted at an earlier MCLK since the start mark
+} lt_stat_t;
+
+typedef struct
+{
+    uint32_t iteration;         // number of completed loop iterations
+    uint32_t budget_us;         // exec time allowed per iteration
+    uint32_t overruns;          // iterations whose exec time exceeded the budget
+
+    lt_stat_t period;
+    lt_stat_t exec;
+    lt_stat_t sections[LT_MAX_SECTIONS];
+    uint8_t num_sections;
+} loop_timing_t;
+
+extern loop_timing_t loop_timing;
+
+void lt_init(const char *const *section_names, uint8_t num_sections,
+             uint32_t period_us, uint32_t budget_us);
+void lt_reset(void);
+void lt_set_histogram(lt_stat_t *stat, uint32_t origin_us, uint32_t bucket_width_us);
+
+void lt_loop_start(void);
+void lt_loop_end(void);
+void lt_section_start(uint8_t section);
+void lt_section_end(uint8_t section);
+
+uint32_t lt_average(const lt_stat_t *stat);
+
+#endif /* LOOPTIMING_H_ */
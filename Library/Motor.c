@@ -5,36 +5,77 @@
 // Sever nSLPL=nSLPR jumper.
 // This separates P3.7 and P3.6 allowing for independent control
 //
-// Left motor direction connected to P1.7 (J2.14)
+// Left motor direction connected to P5.4
 // Left motor PWM connected to P2.7/TA0CCP4 (J4.40)
 // Left motor enable connected to P3.7 (J4.31)
-// Right motor direction connected to P1.6 (J2.15)
+// Right motor direction connected to P5.5
 // Right motor PWM connected to P2.6/TA0CCP3 (J4.39)
 // Right motor enable connected to P3.6 (J2.11)
+//
+// This code does not drive the enables, it relies on the VCCMD=VREG and
+// nSLPL=nSLPR jumpers keeping both drivers awake.  Nothing else may pull
+// P3.6 or P3.7 low either, which is why the OPT3001 INT is on P4.1
+// (HAL_OPT3001.h).
 
 #include <stdint.h>
+#include <stdlib.h>
+#include <math.h>
 #include "msp.h"
 #include <ti/devices/msp432p4xx/driverlib/driverlib.h>
 #include "Motor.h"
 #include "Encoder.h"
+#include "MotorModel.h"
+#include "Clock.h"
+#include "RamFunc.h"
+
 
+/*
+ * Tuning of rotate_motors_by_counts() and rotate_motors_by_counts_pid().
+ * These are globals so they can be changed from the debugger, or by the
+ * host parameter sweep (Host/sweep), without rebuilding.  The relay
+ * autotuner (PidTune.h) sets the PI gains for each robot.
+ */
+float motor_pid_p = 0.3;
+float motor_pid_i = 0.001;
+int motor_stop_threshold = 8;       // counts, rotate_motors_by_counts() stops each motor inside this
+int motor_pid_stop_threshold = 2;   // counts, rotate_motors_by_counts_pid() is done inside this
+
+/*
+ * Most power set_left_motor_pwm() and set_right_motor_pwm() give, from their
+ * next call.  Lowered by the wheel monitor while a wheel is stalled.
+ */
+float motor_power_limit = 1.0;
 
 /* Timer_A PWM Configuration Parameter */
 /*
  * Configure a timer to provide a PWM signal to each motor.
  * Use Timer_A along with two compare registers to generate two different PWM signals
  *
- * SMCLK = 12Mhz
- * Divide by 12 to get a 1Mhz timer clock source
- * Set divider to 1000 to get a 1000Hz pwm rate
- * Start off at 0 * 1/64 for the high time
- * Range will be 0-1000
+ * The timer divides SMCLK down to MOTOR_PWM_HZ * MOTOR_PWM_STEPS, 1Mhz:
+ * SMCLK = 12Mhz after Clock_Init48MHz(), divide by 12
+ * Set the period to 1000 to get a 1000Hz pwm rate
+ * Start off at 0 for the high time
+ * Range will be 0-motor_pwm_period, 1000 unless SMCLK is too slow for it
  */
+#define MOTOR_PWM_HZ    1000
+#define MOTOR_PWM_STEPS 1000
+
+static uint16_t motor_pwm_period = MOTOR_PWM_STEPS;
+
+static bool left_motor_forward = true;
+static bool right_motor_forward = true;
+
+/* The Timer_A input dividers, in ascending order */
+static const uint8_t motor_pwm_dividers[] =
+{
+        1, 2, 3, 4, 5, 6, 7, 8, 10, 12, 14, 16, 20, 24, 28, 32, 40, 48, 56, 64
+};
+
 Timer_A_PWMConfig right_motor_pwm_config =
 {
         TIMER_A_CLOCKSOURCE_SMCLK,
         TIMER_A_CLOCKSOURCE_DIVIDER_12,
-        1000,
+        MOTOR_PWM_STEPS,
         TIMER_A_CAPTURECOMPARE_REGISTER_3,
         TIMER_A_OUTPUTMODE_RESET_SET,
         0
@@ -43,12 +84,54 @@ Timer_A_PWMConfig left_motor_pwm_config =
 {
         TIMER_A_CLOCKSOURCE_SMCLK,
         TIMER_A_CLOCKSOURCE_DIVIDER_12,
-        1000,
+        MOTOR_PWM_STEPS,
         TIMER_A_CAPTURECOMPARE_REGISTER_4,
         TIMER_A_OUTPUTMODE_RESET_SET,
         0
 };
 
+/*
+ *  Pick the smallest Timer_A divider that gives a period of at most
+ *  MOTOR_PWM_STEPS at MOTOR_PWM_HZ from the current SMCLK.  The TIMER_A
+ *  divider constants are the divider values themselves.
+ */
+static void motor_pwm_set_clock(void)
+{
+    uint32_t smclk = Clock_GetSMCLK();
+    uint32_t period = 0;
+    uint32_t i;
+
+    for (i = 0; i < sizeof(motor_pwm_dividers); i++) {
+        period = smclk / ((uint32_t)motor_pwm_dividers[i] * MOTOR_PWM_HZ);
+        if (period <= MOTOR_PWM_STEPS)
+            break;
+    }
+    if (i == sizeof(motor_pwm_dividers))
+        i--;
+    if (period == 0)
+        period = 1;
+
+    right_motor_pwm_config.clockSourceDivider = motor_pwm_dividers[i];
+    left_motor_pwm_config.clockSourceDivider = motor_pwm_dividers[i];
+    right_motor_pwm_config.timerPeriod = period;
+    left_motor_pwm_config.timerPeriod = period;
+    motor_pwm_period = period;
+}
+
+/*
+ *  Clock change handler: keep the PWM rate and the duty cycles
+ */
+static void motor_clock_changed(void)
+{
+    uint16_t old_period = motor_pwm_period;
+
+    motor_pwm_set_clock();
+    right_motor_pwm_config.dutyCycle = (uint32_t)right_motor_pwm_config.dutyCycle * motor_pwm_period / old_period;
+    left_motor_pwm_config.dutyCycle = (uint32_t)left_motor_pwm_config.dutyCycle * motor_pwm_period / old_period;
+    MAP_Timer_A_generatePWM(TIMER_A0_BASE, &right_motor_pwm_config);
+    MAP_Timer_A_generatePWM(TIMER_A0_BASE, &left_motor_pwm_config);
+}
+
 void motor_init(void){
     /*
     * Configuring GPIO2.6 as peripheral output for PWM of Right Motor
@@ -73,9 +156,10 @@ void motor_init(void){
     MAP_GPIO_setOutputLowOnPin(GPIO_PORT_P5, GPIO_PIN4);
 
     /*
-    * Configuring Timer_A to have a period of approximately 500ms and
-    * an initial duty cycle of 10% of that (3200 ticks)
+    * Configuring Timer_A for the 1000Hz pwm rate from the current SMCLK
     */
+    motor_pwm_set_clock();
+    Clock_AddChangeHandler(motor_clock_changed);
     MAP_Timer_A_generatePWM(TIMER_A0_BASE, &right_motor_pwm_config);
   
     set_left_motor_pwm(0);
@@ -87,12 +171,13 @@ void motor_init(void){
  *
  *  Power is given in a range of 0.0 - 1.0
  */
-void set_left_motor_pwm(float pwm_normal)
+RAMFUNC void set_left_motor_pwm(float pwm_normal)
 {
     int pwm;
 
-    pwm = 1000 * pwm_normal;
-    if (pwm>1000) pwm=1000;
+    if (pwm_normal > motor_power_limit) pwm_normal = motor_power_limit;
+    pwm = motor_pwm_period * pwm_normal;
+    if (pwm>motor_pwm_period) pwm=motor_pwm_period;
     if (pwm<0) pwm=0;
     left_motor_pwm_config.dutyCycle = pwm;
     MAP_Timer_A_generatePWM(TIMER_A0_BASE, &left_motor_pwm_config);
@@ -103,13 +188,14 @@ void set_left_motor_pwm(float pwm_normal)
  *
  *  Power is given in a range of 0.0 - 1.0
  */
-void set_right_motor_pwm(float pwm_normal)
+RAMFUNC void set_right_motor_pwm(float pwm_normal)
 {
     int pwm;
 
-    pwm = 1000 * pwm_normal;
+    if (pwm_normal > motor_power_limit) pwm_normal = motor_power_limit;
+    pwm = motor_pwm_period * pwm_normal;
 
-    if (pwm>1000) pwm=1000;
+    if (pwm>motor_pwm_period) pwm=motor_pwm_period;
     if (pwm<0) pwm=0;
     right_motor_pwm_config.dutyCycle = pwm;
     MAP_Timer_A_generatePWM(TIMER_A0_BASE, &right_motor_pwm_config);
@@ -121,8 +207,9 @@ void set_right_motor_pwm(float pwm_normal)
  *  True: forward
  *  False: reverse
  */
-void set_left_motor_direction(bool dir)
+RAMFUNC void set_left_motor_direction(bool dir)
 {
+    left_motor_forward = dir;
     if (dir)
         MAP_GPIO_setOutputLowOnPin(GPIO_PORT_P5, GPIO_PIN4);
     else
@@ -135,14 +222,39 @@ void set_left_motor_direction(bool dir)
  *  True: forward
  *  False: reverse
  */
-void set_right_motor_direction(bool dir)
+RAMFUNC void set_right_motor_direction(bool dir)
 {
+    right_motor_forward = dir;
     if (dir)
         MAP_GPIO_setOutputLowOnPin(GPIO_PORT_P5, GPIO_PIN5);
     else
         MAP_GPIO_setOutputHighOnPin(GPIO_PORT_P5, GPIO_PIN5);
 }
 
+/*
+ *  Power the left motor is driven with, as set above.
+ *
+ *  -1.0 full reverse to 1.0 full forward
+ */
+RAMFUNC float get_left_motor_power(void)
+{
+    float power = (float)left_motor_pwm_config.dutyCycle / motor_pwm_period;
+
+    return left_motor_forward ? power : -power;
+}
+
+/*
+ *  Power the right motor is driven with, as set above.
+ *
+ *  -1.0 full reverse to 1.0 full forward
+ */
+RAMFUNC float get_right_motor_power(void)
+{
+    float power = (float)right_motor_pwm_config.dutyCycle / motor_pwm_period;
+
+    return right_motor_forward ? power : -power;
+}
+
 /*
  *  Rotate both left and right motors by a given encoder count.
  *
@@ -181,18 +293,18 @@ bool rotate_motors_by_counts(motor_mode_t mode, float speed_factor, int left_cou
         set_right_motor_direction(right_error>=0);
 
         // Stop individual motor if we are within the threshold
-        if (abs(left_error)>8)
+        if (abs(left_error)>motor_stop_threshold)
             set_left_motor_pwm(speed_factor);
         else
             set_left_motor_pwm(0);
 
-        if (abs(right_error)>8)
+        if (abs(right_error)>motor_stop_threshold)
             set_right_motor_pwm(speed_factor);
         else
             set_right_motor_pwm(0);
 
         // if both motors are within the threshold then return true to signal "all done"
-        if ((abs(left_error) <= 8) && (abs(right_error) <= 8))
+        if ((abs(left_error) <= motor_stop_threshold) && (abs(right_error) <= motor_stop_threshold))
             r = true;
     break;
     }
@@ -207,8 +319,11 @@ bool rotate_motors_by_counts(motor_mode_t mode, float speed_factor, int left_cou
  *  This routine is called in two parts, first call is with mode=INITIAL to set up some initial static variables,
  *  second call is with mode=CONTINUOUS.  This call will process the PID loop and return after one iteration.  It
  *  should be called until the return value is TRUE, signifying that the motors have reached the threshold around the target count.
+ *
+ *  With a motor model in use (motor_model_use()) the PI output is a speed, which its feed-forward turns into each
+ *  wheel's duty past its dead band.
  */
-bool rotate_motors_by_counts_pid(motor_mode_t mode, float speed_factor, int left_count, int right_count)
+RAMFUNC bool rotate_motors_by_counts_pid(motor_mode_t mode, float speed_factor, int left_count, int right_count)
 {
     static int left_target;
     static int right_target;
@@ -217,8 +332,8 @@ bool rotate_motors_by_counts_pid(motor_mode_t mode, float speed_factor, int left
     int right_error;
     static int left_error_sum;
     static int right_error_sum;
-    float P = 0.3;
-    float I = 0.001;
+    float P = motor_pid_p;
+    float I = motor_pid_i;
     float left_motor_speed;
     float right_motor_speed;
 
@@ -265,11 +380,11 @@ bool rotate_motors_by_counts_pid(motor_mode_t mode, float speed_factor, int left
         set_right_motor_direction(right_motor_speed>=0);
 
         // Set motors to run at calculated speed times a speed factor
-        set_left_motor_pwm(fabs(left_motor_speed * speed_factor));
-        set_right_motor_pwm(fabs(right_motor_speed * speed_factor));
+        set_left_motor_pwm(motor_model_feed_forward(MOTOR_LEFT, fabs(left_motor_speed * speed_factor)));
+        set_right_motor_pwm(motor_model_feed_forward(MOTOR_RIGHT, fabs(right_motor_speed * speed_factor)));
 
         // Stop if within a treshold
-        if ((abs(left_error) < 2) && (abs(right_error) < 2))
+        if ((abs(left_error) < motor_pid_stop_threshold) && (abs(right_error) < motor_pid_stop_threshold))
             r = true;
     break;
     }
@@ -1,21 +1,29 @@
-#ifndef MOTOR_H_
-#define MOTOR_H_
-
-
-
-typedef enum
-{
-    INITIAL,
-    CONTINUOUS
-} motor_mode_t;
-
-void motor_init(void);
-void set_left_motor_pwm(float);
-void set_right_motor_pwm(float);
-void set_left_motor_direction(bool);
-void set_right_motor_direction(bool);
-bool rotate_motors_by_counts(motor_mode_t, float, int, int);
-bool rotate_motors_by_counts_pid(motor_mode_t, float, int, int);
-
-
-#endif /* MOTOR_H_ */
+#ifndef MOTOR_H_
+#define MOTOR_H_
+
+
+
+typedef enum
+{
+    INITIAL,
+    CONTINUOUS
+} motor_mode_t;
+
+extern float motor_pid_p;
+extern float motor_pid_i;
+extern int motor_stop_threshold;
+extern int motor_pid_stop_threshold;
+extern float motor_power_limit;
+
+void motor_init(void);
+void set_left_motor_pwm(float);
+void set_right_motor_pwm(float);
+void set_left_motor_direction(bool);
+void set_right_motor_direction(bool);
+float get_left_motor_power(void);
+float get_right_motor_power(void);
+bool rotate_motors_by_counts(motor_mode_t, float, int, int);
+bool rotate_motors_by_counts_pid(motor_mode_t, float, int, int);
+
+
+#endif /* MOTOR_H_ */
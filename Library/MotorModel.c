@@ -0,0 +1,255 @@
+/*
+ * MotorModel.c
+ *
+ * Per wheel motor model and feed-forward.  See MotorModel.h.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "msp.h"
+#include "Motor.h"
+#include "Encoder.h"
+#include "Clock.h"
+#include "RamFunc.h"
+#include "MotorModel.h"
+
+#define MODEL_MIN_SPEED     20.0        // counts/s, slower points are in the dead band
+#define MODEL_MIN_POINTS    3
+#define MODEL_MAX_DEADBAND  0.5
+#define MODEL_REST_MS       1000
+#define MODEL_REST_TIMEOUT  (4 * MODEL_REST_MS)
+
+static const motor_model_t *model_in_use;
+static float top_speed;                 // counts/s both wheels reach
+
+static void model_counts(int count[2])
+{
+    count[MOTOR_LEFT] = get_left_motor_count();
+    count[MOTOR_RIGHT] = get_right_motor_count();
+}
+
+static void model_drive(float duty)
+{
+    set_left_motor_pwm(duty);
+    set_right_motor_pwm(duty);
+}
+
+/*
+ *  Counts each wheel turns in ms, and the time that took in seconds
+ *  measured with the cycle counter
+ */
+static float model_travel(uint32_t ms, int travel[2])
+{
+    int before[2], after[2];
+    uint32_t start;
+    float seconds;
+
+    model_counts(before);
+    start = DWT->CYCCNT;
+    Clock_Delay1ms(ms);
+    seconds = (float)(DWT->CYCCNT - start) / Clock_GetMCLK();
+    model_counts(after);
+
+    travel[MOTOR_LEFT] = after[MOTOR_LEFT] - before[MOTOR_LEFT];
+    travel[MOTOR_RIGHT] = after[MOTOR_RIGHT] - before[MOTOR_RIGHT];
+
+    return seconds;
+}
+
+/*
+ *  Stop both wheels and wait until neither moves.  Returns false if one still
+ *  turns after MODEL_REST_TIMEOUT ms, say the robot is off its stand or an
+ *  encoder is picking up noise.
+ */
+static bool model_rest(void)
+{
+    int travel[2];
+    uint32_t waited = 0;
+
+    model_drive(0);
+    do
+    {
+        if (waited >= MODEL_REST_TIMEOUT)
+            return false;
+
+        model_travel(MODEL_REST_MS / 4, travel);
+        waited += MODEL_REST_MS / 4;
+    } while (travel[MOTOR_LEFT] || travel[MOTOR_RIGHT]);
+
+    return true;
+}
+
+/*
+ *  Least squares line through the points above the dead band
+ */
+static bool model_fit(const float *duty, const float *speed, motor_wheel_model_t *wheel)
+{
+    float sx = 0, sy = 0, sxx = 0, sxy = 0;
+    float slope, intercept;
+    uint8_t i, n = 0;
+
+    for (i = 0; i < MODEL_STEPS; i++)
+    {
+        if (speed[i] < MODEL_MIN_SPEED)
+            continue;
+
+        sx += duty[i];
+        sy += speed[i];
+        sxx += duty[i] * duty[i];
+        sxy += duty[i] * speed[i];
+        n++;
+    }
+
+    if ((n < MODEL_MIN_POINTS) || (n * sxx - sx * sx <= 0))
+        return false;
+
+    slope = (n * sxy - sx * sy) / (n * sxx - sx * sx);
+    intercept = (sy - slope * sx) / n;
+    if (slope <= 0)
+        return false;
+
+    wheel->gain = slope;
+    wheel->deadband = -intercept / slope;
+    if (wheel->deadband < 0)
+        wheel->deadband = 0;
+
+    return wheel->deadband <= MODEL_MAX_DEADBAND;
+}
+
+/*
+ *  Characterise both motors, driving them forward.  The robot has to be on
+ *  a stand.  Needs the encoders, the SysTick or other interrupts running and
+ *  the DWT cycle counter.  Returns false, with model->valid clear, if a
+ *  wheel did not turn, the fit makes no sense or the wheels do not come to
+ *  rest before the step.
+ */
+bool motor_model_measure(motor_model_t *model)
+{
+    float duty[MODEL_STEPS];
+    float speed[2][MODEL_STEPS];
+    float seconds, settled;
+    int travel[2];
+    uint8_t i, side;
+
+    model->valid = false;
+
+    if (!(DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk))
+    {
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    }
+
+    set_left_motor_direction(true);
+    set_right_motor_direction(true);
+
+    // Settled speed at each duty
+    for (i = 0; i < MODEL_STEPS; i++)
+    {
+        duty[i] = MODEL_MIN_DUTY + i * MODEL_DUTY_STEP;
+        model_drive(duty[i]);
+        Clock_Delay1ms(MODEL_SETTLE_MS);
+
+        seconds = model_travel(MODEL_MEASURE_MS, travel);
+        for (side = 0; side < 2; side++)
+            speed[side][i] = travel[side] / seconds;
+    }
+
+    for (side = 0; side < 2; side++)
+    {
+        if (!model_fit(duty, speed[side], &model->wheel[side]))
+        {
+            model_drive(0);
+            return false;
+        }
+    }
+
+    /*
+     * Time constant from a step from rest: after t >> tau a first order lag
+     * has travelled speed * (t - tau)
+     */
+    if (!model_rest())
+        return false;
+
+    model_drive(MODEL_STEP_DUTY);
+    seconds = model_travel(MODEL_MEASURE_MS, travel);
+    model_drive(0);
+
+    for (side = 0; side < 2; side++)
+    {
+        settled = model->wheel[side].gain * (MODEL_STEP_DUTY - model->wheel[side].deadband);
+        model->wheel[side].tau_ms = 1000 * (seconds - travel[side] / settled);
+        if (model->wheel[side].tau_ms < 0)
+            model->wheel[side].tau_ms = 0;
+    }
+
+    model->valid = true;
+
+    return true;
+}
+
+/*
+ *  Use model, which must stay in place, for the feed-forward from now on.
+ *  NULL or an invalid model turns it off.
+ */
+void motor_model_use(const motor_model_t *model)
+{
+    const motor_wheel_model_t *w;
+    float top;
+    uint8_t side;
+
+    model_in_use = NULL;
+
+    if (!model || !model->valid)
+        return;
+
+    top_speed = 0;
+    for (side = 0; side < 2; side++)
+    {
+        w = &model->wheel[side];
+        if ((w->gain <= 0) || (w->deadband < 0) || (w->deadband > MODEL_MAX_DEADBAND))
+            return;
+
+        top = w->gain * (1.0f - w->deadband);
+        if ((side == 0) || (top < top_speed))
+            top_speed = top;
+    }
+
+    model_in_use = model;
+}
+
+/*
+ *  Duty to turn a wheel at speed counts/s, or otherwise without a model
+ */
+float motor_model_duty(uint8_t side, float speed, float otherwise)
+{
+    const motor_wheel_model_t *w;
+    float duty;
+
+    if (!model_in_use)
+        return otherwise;
+
+    w = &model_in_use->wheel[side & 1];
+    duty = w->deadband + speed / w->gain;
+
+    return (duty > 1.0f) ? 1.0f : duty;
+}
+
+/*
+ *  Duty for a controller output of 0.0 - 1.0 of the speed both wheels can
+ *  reach.  The output itself without a model.  Runs from SRAM, it is in the
+ *  PI controller's step.
+ */
+RAMFUNC float motor_model_feed_forward(uint8_t side, float output)
+{
+    const motor_wheel_model_t *w;
+    float duty;
+
+    if (!model_in_use || (output <= 0))
+        return output;
+
+    w = &model_in_use->wheel[side & 1];
+    duty = w->deadband + output * top_speed / w->gain;
+
+    return (duty > 1.0f) ? 1.0f : duty;
+}
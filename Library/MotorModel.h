@@ -0,0 +1,62 @@
+/*
+ *  MotorModel.h
+ *
+ *  Per wheel motor model and feed-forward.
+ *
+ *  The two motors need different duty to start turning and turn at
+ *  different speeds for the same duty.  Each wheel is modelled as
+ *
+ *    speed = gain * (duty - deadband)     counts/s, above the dead band
+ *
+ *  reaching it with a first order lag of time constant tau_ms.
+ *  motor_model_measure() finds these on the robot, with it on a stand: it
+ *  steps both wheels through MODEL_STEPS duties, measures the settled speed
+ *  of each, fits the line, then times a step from rest to MODEL_STEP_DUTY.
+ *  It takes about 10 s.  Calibration.c keeps the result in flash.
+ *
+ *  Once motor_model_use() is given a model:
+ *
+ *    motor_model_duty()           is the duty for a speed, so both wheels
+ *                                 can be asked for the same one
+ *    motor_model_feed_forward()   turns a controller output (0.0 - 1.0 of
+ *                                 the top speed both wheels reach) into
+ *                                 each wheel's duty, past its dead band.
+ *                                 rotate_motors_by_counts_pid() uses it
+ *
+ *  Without a model both pass the duty straight through.
+ */
+#ifndef MOTORMODEL_H_
+#define MOTORMODEL_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define MOTOR_LEFT          0
+#define MOTOR_RIGHT         1
+
+#define MODEL_STEPS         10          // duties measured, MODEL_MIN_DUTY and up
+#define MODEL_MIN_DUTY      0.04
+#define MODEL_DUTY_STEP     0.04
+#define MODEL_STEP_DUTY     0.40        // for the time constant
+#define MODEL_SETTLE_MS     400
+#define MODEL_MEASURE_MS    500
+
+typedef struct
+{
+    float deadband;             // duty below which the wheel does not turn
+    float gain;                 // counts/s per unit of duty above the dead band
+    float tau_ms;               // time constant
+} motor_wheel_model_t;
+
+typedef struct
+{
+    bool valid;
+    motor_wheel_model_t wheel[2];   // MOTOR_LEFT, MOTOR_RIGHT
+} motor_model_t;
+
+bool motor_model_measure(motor_model_t *model);
+void motor_model_use(const motor_model_t *model);
+float motor_model_duty(uint8_t side, float speed, float otherwise);
+float motor_model_feed_forward(uint8_t side, float output);
+
+#endif /* MOTORMODEL_H_ */
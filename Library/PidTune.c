@@ -0,0 +1,184 @@
+/*
+ * PidTune.c
+ *
+ * Relay autotuner for rotate_motors_by_counts_pid().  See PidTune.h.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+#include "Motor.h"
+#include "Encoder.h"
+#include "Clock.h"
+#include "MotorModel.h"
+#include "PidTune.h"
+
+#define PI 3.14159265f
+
+/*
+ * Relay output, 0.0 - 1.0 of the PI controller's output.  A global so it
+ * can be changed from the debugger.
+ */
+float pid_tune_relay = 1.0;
+
+typedef struct
+{
+    int target;
+    bool forward;               // relay output
+    uint8_t cycles;             // switches to forward so far
+    uint32_t first_step;        // step measuring started
+    int min_error;
+    int max_error;
+    bool done;
+} pid_tune_relay_t;
+
+static int pid_tune_count(uint8_t side)
+{
+    return (side == MOTOR_LEFT) ? get_left_motor_count() : get_right_motor_count();
+}
+
+static void pid_tune_drive(uint8_t side, bool forward, float duty)
+{
+    if (side == MOTOR_LEFT)
+    {
+        set_left_motor_direction(forward);
+        set_left_motor_pwm(duty);
+    }
+    else
+    {
+        set_right_motor_direction(forward);
+        set_right_motor_pwm(duty);
+    }
+}
+
+/*
+ *  One step of a wheel's relay.  Returns true once it has measured its
+ *  cycles, which leaves the wheel stopped.
+ */
+static bool pid_tune_step(pid_tune_relay_t *relay, uint8_t side, uint32_t step, float duty,
+                          pid_tune_wheel_t *wheel)
+{
+    int error = relay->target - pid_tune_count(side);
+    bool forward = relay->forward;
+
+    if (relay->done)
+        return true;
+
+    if (error > PID_TUNE_HYSTERESIS)
+        forward = true;
+    else if (error < -PID_TUNE_HYSTERESIS)
+        forward = false;
+
+    if (forward && !relay->forward)
+    {
+        relay->cycles++;
+
+        if (relay->cycles == PID_TUNE_SKIP)
+        {
+            relay->first_step = step;
+            relay->min_error = error;
+            relay->max_error = error;
+        }
+        else if (relay->cycles == PID_TUNE_SKIP + PID_TUNE_CYCLES)
+        {
+            pid_tune_drive(side, true, 0);
+            wheel->tu = (float)(step - relay->first_step) / PID_TUNE_CYCLES;
+            wheel->amplitude = (relay->max_error - relay->min_error) / 2.0f;
+            relay->done = true;
+            return true;
+        }
+    }
+
+    if (relay->cycles >= PID_TUNE_SKIP)
+    {
+        if (error < relay->min_error)
+            relay->min_error = error;
+        if (error > relay->max_error)
+            relay->max_error = error;
+    }
+
+    relay->forward = forward;
+    pid_tune_drive(side, forward, duty);
+
+    return false;
+}
+
+/*
+ *  Run the relay experiment on both wheels and work out the PI gains for
+ *  rotate_motors_by_counts_pid() called with speed_factor every
+ *  PID_TUNE_PERIOD_MS.  Uses the motor model in use, if any, as the
+ *  controller does.  Returns false, with tune->valid clear, if a wheel
+ *  did not settle into a limit cycle in PID_TUNE_TIMEOUT_MS.
+ */
+bool pid_tune_measure(float speed_factor, pid_tune_t *tune)
+{
+    pid_tune_relay_t relay[2];
+    pid_tune_wheel_t *wheel;
+    float duty, p, i, a;
+    uint32_t step;
+    uint8_t side;
+    bool done = false;
+
+    tune->valid = false;
+    tune->speed_factor = speed_factor;
+
+    for (side = 0; side < 2; side++)
+    {
+        relay[side].target = pid_tune_count(side);
+        relay[side].forward = true;
+        relay[side].cycles = 0;
+        relay[side].done = false;
+    }
+
+    for (step = 0; (step < PID_TUNE_TIMEOUT_MS / PID_TUNE_PERIOD_MS) && !done; step++)
+    {
+        done = true;
+        for (side = 0; side < 2; side++)
+        {
+            duty = motor_model_feed_forward(side, pid_tune_relay * speed_factor);
+            done &= pid_tune_step(&relay[side], side, step, duty, &tune->wheel[side]);
+        }
+
+        Clock_Delay1ms(PID_TUNE_PERIOD_MS);
+    }
+
+    pid_tune_drive(MOTOR_LEFT, true, 0);
+    pid_tune_drive(MOTOR_RIGHT, true, 0);
+
+    if (!done)
+        return false;
+
+    for (side = 0; side < 2; side++)
+    {
+        wheel = &tune->wheel[side];
+        if ((wheel->amplitude <= PID_TUNE_HYSTERESIS) || (wheel->tu <= 0))
+            return false;
+
+        a = wheel->amplitude;
+        wheel->ku = 4 * pid_tune_relay / (PI * sqrtf(a * a - PID_TUNE_HYSTERESIS * PID_TUNE_HYSTERESIS));
+
+        // Ziegler-Nichols PI, the smaller gains of the two wheels
+        p = 0.45f * wheel->ku;
+        i = p * 1.2f / wheel->tu;
+        if ((side == 0) || (p < tune->p))
+            tune->p = p;
+        if ((side == 0) || (i < tune->i))
+            tune->i = i;
+    }
+
+    tune->valid = true;
+
+    return true;
+}
+
+/*
+ *  Set motor_pid_p and motor_pid_i from tune, if it is valid
+ */
+void pid_tune_use(const pid_tune_t *tune)
+{
+    if (!tune || !tune->valid || (tune->p <= 0) || (tune->i <= 0))
+        return;
+
+    motor_pid_p = tune->p;
+    motor_pid_i = tune->i;
+}
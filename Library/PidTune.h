@@ -0,0 +1,59 @@
+/*
+ *  PidTune.h
+ *
+ *  Relay autotuner for rotate_motors_by_counts_pid().
+ *
+ *  The PI gains that settle a move quickly depend on the floor, the
+ *  battery and the motors.  pid_tune_measure() finds them with a relay
+ *  experiment (Astrom and Hagglund): each wheel is held around its current
+ *  count by driving it at +pid_tune_relay when short of it and
+ *  -pid_tune_relay when past it, through the same speed factor and motor
+ *  feed-forward as the PI controller.  The wheel settles into a limit
+ *  cycle.  Its amplitude a counts and period Tu give the ultimate gain
+ *
+ *    Ku = 4 * relay / (pi * sqrt(a * a - h * h))   h: the relay's hysteresis
+ *
+ *  from which Ziegler-Nichols' PI rule gives
+ *
+ *    p = 0.45 Ku     i = p / (Tu / 1.2)   per PID_TUNE_PERIOD_MS call
+ *
+ *  The controller has one pair of gains for both wheels, so the smaller of
+ *  each wheel's is used.  Both wheels run at once and rock a few counts
+ *  back and forth, on the floor or on a stand, for about two seconds.
+ *  Calibration.c keeps the result in flash; pid_tune_use() sets
+ *  motor_pid_p and motor_pid_i from it.
+ */
+#ifndef PIDTUNE_H_
+#define PIDTUNE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define PID_TUNE_PERIOD_MS  10          // relay step, the rate the PI controller is called at
+#define PID_TUNE_HYSTERESIS 2           // counts either side of the target before the relay switches
+#define PID_TUNE_SKIP       2           // limit cycles let settle before measuring
+#define PID_TUNE_CYCLES     4           // limit cycles measured
+#define PID_TUNE_TIMEOUT_MS 5000
+
+typedef struct
+{
+    float ku;                   // ultimate gain, PI output per count
+    float tu;                   // ultimate period, calls of PID_TUNE_PERIOD_MS
+    float amplitude;            // counts, half the peak to peak error
+} pid_tune_wheel_t;
+
+typedef struct
+{
+    bool valid;
+    float speed_factor;         // rotate_motors_by_counts_pid() speed factor tuned for
+    pid_tune_wheel_t wheel[2];  // MOTOR_LEFT, MOTOR_RIGHT
+    float p;                    // motor_pid_p
+    float i;                    // motor_pid_i
+} pid_tune_t;
+
+extern float pid_tune_relay;
+
+bool pid_tune_measure(float speed_factor, pid_tune_t *tune);
+void pid_tune_use(const pid_tune_t *tune);
+
+#endif /* PIDTUNE_H_ */
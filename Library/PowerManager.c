@@ -0,0 +1,176 @@
+/*
+ * PowerManager.c
+ *
+ * Frequency and core voltage scaling.  See PowerManager.h.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "msp.h"
+#include <ti/devices/msp432p4xx/driverlib/driverlib.h>
+#include "PowerManager.h"
+#include "Clock.h"
+
+// The run clocks, as Clock_Init48MHz() sets them
+#define POWER_RUN_MCLK_DIV      1
+#define POWER_RUN_HSMCLK_DIV    2
+#define POWER_RUN_SMCLK_DIV     4
+
+// PCM active mode requests (AMR) and current modes (CPM)
+#define AM_LDO_VCORE0           PCM_CTL0_AMR_0
+#define AM_LDO_VCORE1           PCM_CTL0_AMR_1
+#define AM_DCDC_VCORE0          PCM_CTL0_AMR_4
+
+#define PCM_ERROR_FLAGS         (PCM_IFG_AM_INVALID_TR_IFG | PCM_IFG_DCDC_ERROR_IFG)
+
+power_state_t power;
+
+/*
+ *  Wait for the PCM to finish the last request.  Returns false on timeout.
+ */
+static bool power_wait_idle(void)
+{
+    uint32_t loops = 0;
+
+    while (PCM->CTL1 & PCM_CTL1_PMR_BUSY)
+    {
+        if (++loops >= POWER_TIMEOUT_LOOPS)
+            return false;
+    }
+
+    return true;
+}
+
+/*
+ *  Request an active mode and wait for the PCM to get there.  Returns false
+ *  if the transition is invalid, the DC-DC regulator fails to start (the PCM
+ *  then stays on the LDO) or the change does not complete.
+ */
+static bool power_request(uint32_t amr)
+{
+    uint32_t loops = 0;
+
+    if (!power_wait_idle())
+        return false;
+
+    PCM->CTL0 = (PCM->CTL0 & ~(0xFFFF0000 | PCM_CTL0_AMR_MASK)) |    // clear key and AMR
+                PCM_CTL0_KEY_VAL | amr;
+
+    while (((PCM->CTL0 & PCM_CTL0_CPM_MASK) >> PCM_CTL0_CPM_OFS) != amr)
+    {
+        if ((PCM->IFG & PCM_ERROR_FLAGS) || (++loops >= POWER_TIMEOUT_LOOPS))
+            break;
+    }
+
+    if (PCM->IFG & PCM_ERROR_FLAGS)
+    {
+        PCM->CLRIFG = PCM_CLRIFG_CLR_AM_INVALID_TR_IFG | PCM_CLRIFG_CLR_DCDC_ERROR_IFG;
+        power_wait_idle();
+        return false;
+    }
+
+    return power_wait_idle() &&
+           (((PCM->CTL0 & PCM_CTL0_CPM_MASK) >> PCM_CTL0_CPM_OFS) == amr);
+}
+
+/*
+ *  Start in POWER_RUN, call after Clock_Init48MHz().  With use_dcdc the
+ *  idle mode runs on the DC-DC regulator, which needs the inductor fitted
+ *  on the LaunchPad.
+ */
+void power_init(bool use_dcdc)
+{
+    uint8_t i;
+
+    power.mode = POWER_RUN;
+    power.use_dcdc = use_dcdc;
+    power.dcdc_active = false;
+    power.transitions = 0;
+    power.failures = 0;
+
+    for (i = 0; i < NUM_POWER_MODES; i++)
+        power.mode_ms[i] = 0;
+}
+
+/*
+ *  48 MHz at VCORE1 to the idle clocks at VCORE0
+ */
+static bool power_enter_idle(void)
+{
+    Clock_SetDividers(POWER_IDLE_MCLK_DIV, POWER_IDLE_HSMCLK_DIV, POWER_IDLE_SMCLK_DIV);
+
+    if (!power_request(AM_LDO_VCORE0))
+    {
+        Clock_SetDividers(POWER_RUN_MCLK_DIV, POWER_RUN_HSMCLK_DIV, POWER_RUN_SMCLK_DIV);
+        return false;
+    }
+
+    // Idle on the LDO if the DC-DC regulator does not start
+    if (power.use_dcdc)
+    {
+        power.dcdc_active = power_request(AM_DCDC_VCORE0);
+        if (!power.dcdc_active)
+            power.failures++;
+    }
+
+    return true;
+}
+
+/*
+ *  Back to VCORE1 and 48 MHz
+ */
+static bool power_enter_run(void)
+{
+    if (power.dcdc_active)
+    {
+        if (!power_request(AM_LDO_VCORE0))
+            return false;
+        power.dcdc_active = false;
+    }
+
+    if (!power_request(AM_LDO_VCORE1))
+        return false;
+
+    Clock_SetDividers(POWER_RUN_MCLK_DIV, POWER_RUN_HSMCLK_DIV, POWER_RUN_SMCLK_DIV);
+
+    return true;
+}
+
+/*
+ *  Change mode.  Returns false, staying in the current mode, if the PCM
+ *  refused the change.
+ */
+bool power_set_mode(power_mode_t mode)
+{
+    bool ok;
+
+    if (mode == power.mode)
+        return true;
+
+    ok = (mode == POWER_IDLE) ? power_enter_idle() : power_enter_run();
+
+    if (ok)
+    {
+        power.mode = mode;
+        power.transitions++;
+    }
+    else
+    {
+        power.failures++;
+    }
+
+    return ok;
+}
+
+power_mode_t power_get_mode(void)
+{
+    return power.mode;
+}
+
+/*
+ *  Call every millisecond from SysTick_Handler.
+ */
+void power_tick(void)
+{
+    power.mode_ms[power.mode]++;
+}
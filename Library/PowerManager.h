@@ -0,0 +1,63 @@
+/*
+ *  PowerManager.h
+ *
+ *  Frequency and core voltage scaling between the active and idle phases
+ *  of a program.
+ *
+ *  POWER_RUN is what Clock_Init48MHz() sets up: MCLK 48 MHz, HSMCLK 24 MHz
+ *  and SMCLK 12 MHz from the crystal, on the LDO at VCORE1.  POWER_IDLE
+ *  divides the crystal down to POWER_IDLE_MCLK_DIV etc. and drops the core
+ *  to VCORE0, and optionally onto the DC-DC regulator (the __REGULATOR
+ *  option of system_msp432p401r.c).  VCORE0 allows 24 MHz at most, so the
+ *  clocks come down before the voltage and the voltage goes up before the
+ *  clocks.  The DC-DC regulator can only be switched at a fixed VCORE, so
+ *  it is left for the LDO first on the way back.
+ *
+ *  The clock changes go through Clock_SetDividers(), so the drivers that
+ *  registered a change handler (I2C, motor PWM, telemetry UART, SysTick)
+ *  keep their rates in both modes.
+ *
+ *  Call power_set_mode() from the main loop, for example when the state
+ *  machine enters and leaves its waiting state.  The time spent in each
+ *  mode is counted by power_tick() in power.
+ */
+#ifndef POWERMANAGER_H_
+#define POWERMANAGER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Idle clocks, dividers of the 48 MHz crystal.  SMCLK at 6 MHz still gives
+// 400 kHz I2C, a 1 kHz PWM with 1000 steps and 460800 baud.
+#define POWER_IDLE_MCLK_DIV     8       // 6 MHz
+#define POWER_IDLE_HSMCLK_DIV   8       // 6 MHz
+#define POWER_IDLE_SMCLK_DIV    8       // 6 MHz
+
+// Polling loops allowed for the PCM to finish a mode change
+#define POWER_TIMEOUT_LOOPS     100000
+
+typedef enum
+{
+    POWER_RUN,                  // 48 MHz, LDO, VCORE1
+    POWER_IDLE,                 // POWER_IDLE_*_DIV, VCORE0, LDO or DC-DC
+    NUM_POWER_MODES
+} power_mode_t;
+
+typedef struct
+{
+    power_mode_t mode;
+    bool use_dcdc;              // idle on the DC-DC regulator
+    bool dcdc_active;           // the regulator is on DC-DC now
+    uint32_t transitions;       // successful mode changes
+    uint32_t failures;          // mode changes the PCM refused, DC-DC errors included
+    uint32_t mode_ms[NUM_POWER_MODES];  // time spent in each mode
+} power_state_t;
+
+extern power_state_t power;
+
+void power_init(bool use_dcdc);
+bool power_set_mode(power_mode_t mode);
+power_mode_t power_get_mode(void);
+void power_tick(void);
+
+#endif /* POWERMANAGER_H_ */
@@ -0,0 +1,25 @@
+/*
+ *  RamFunc.h
+ *
+ *  RAMFUNC places a function in the .TI.ramfunc section.  The linker command
+ *  files load that section into flash and copy it to SRAM_CODE at boot
+ *  (table(BINIT)), so the function runs from SRAM without flash wait states.
+ *  Used for the handlers and the control step, which run every millisecond
+ *  or on every encoder edge:
+ *
+ *    RAMFUNC void PORT5_IRQHandler(void)
+ *
+ *  Define NO_RAMFUNC for the Library and the lab to build everything in
+ *  flash, for example to compare benchmark figures.  On the host build it
+ *  has no effect.
+ */
+#ifndef RAMFUNC_H_
+#define RAMFUNC_H_
+
+#if defined(__TI_COMPILER_VERSION__) && !defined(NO_RAMFUNC)
+#define RAMFUNC __attribute__((ramfunc))
+#else
+#define RAMFUNC
+#endif
+
+#endif /* RAMFUNC_H_ */
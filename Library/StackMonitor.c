@@ -0,0 +1,97 @@
+/*
+ * StackMonitor.c
+ *
+ * Stack high-water mark and overflow guard.  See StackMonitor.h.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "msp.h"
+#include "StackMonitor.h"
+
+#define STACK_PAINT_MARGIN  16          // words left alone below the caller's frame
+#define STACK_GUARD_SIZE    4           // RASR.SIZE: 2^(4+1) = 32 bytes
+#define STACK_GUARD_AP      0           // RASR.AP: no access
+
+#ifdef __TI_COMPILER_VERSION__
+// Defined by the run-time library and the linker
+extern uint32_t __stack;
+extern uint32_t __STACK_END;
+#define STACK_BASE          (&__stack)
+#define STACK_END           (&__STACK_END)
+#else
+static uint32_t stack_host[512 / 4];
+#define STACK_BASE          (stack_host)
+#define STACK_END           (stack_host + 512 / 4)
+#endif
+
+stack_monitor_t stack_monitor;
+
+/*
+ *  Paint the stack below the caller and, if guard, put the MPU guard at its
+ *  bottom.  Call it once, early in main(), from the top level: anything
+ *  using the stack below main()'s frame at the time is overwritten.
+ */
+void stack_init(bool guard)
+{
+    uint32_t here = 0;
+    uint32_t *limit = (uint32_t *)((uintptr_t)&here - 4 * STACK_PAINT_MARGIN);
+    uintptr_t guard_base;
+    uint32_t primask;
+    uint32_t *p;
+
+    stack_monitor.top = STACK_END;
+    stack_monitor.bottom = STACK_BASE;
+    stack_monitor.high_water = 0;
+    stack_monitor.guarded = false;
+
+    // Not on this stack (the host build): all of it is unused
+    if ((limit < STACK_BASE) || (limit > STACK_END))
+        limit = STACK_END;
+
+    // An interrupt handler runs below this frame, keep them out while painting
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    for (p = STACK_BASE; p < limit; p++)
+        *p = STACK_PAINT;
+
+    __set_PRIMASK(primask);
+
+    if (guard)
+    {
+        // A region is aligned to its size
+        guard_base = ((uintptr_t)STACK_BASE + STACK_GUARD_BYTES - 1) & ~(uintptr_t)(STACK_GUARD_BYTES - 1);
+
+        MPU->RNR = STACK_GUARD_REGION;
+        MPU->RBAR = (uint32_t)guard_base;
+        MPU->RASR = MPU_RASR_XN_Msk | (STACK_GUARD_AP << MPU_RASR_AP_Pos) |
+                    (STACK_GUARD_SIZE << MPU_RASR_SIZE_Pos) | MPU_RASR_ENABLE_Msk;
+
+        // The default memory map everywhere else, also for the fault handlers
+        MPU->CTRL = MPU_CTRL_PRIVDEFENA_Msk | MPU_CTRL_ENABLE_Msk;
+        __DSB();
+        __ISB();
+
+        stack_monitor.bottom = (uint32_t *)(guard_base + STACK_GUARD_BYTES);
+        stack_monitor.guarded = true;
+    }
+
+    stack_monitor.size = 4 * (stack_monitor.top - stack_monitor.bottom);
+}
+
+/*
+ *  Deepest stack use since stack_init(), in bytes, also kept in
+ *  stack_monitor.high_water.  Takes a few cycles per unused word.
+ */
+uint32_t stack_high_water(void)
+{
+    uint32_t *p = stack_monitor.bottom;
+
+    while ((p < stack_monitor.top) && (*p == STACK_PAINT))
+        p++;
+
+    stack_monitor.high_water = 4 * (stack_monitor.top - p);
+
+    return stack_monitor.high_water;
+}
@@ -0,0 +1,49 @@
+/*
+ *  StackMonitor.h
+ *
+ *  Stack high-water mark and overflow guard.
+ *
+ *  Everything runs on the one main stack (.stack, --stack_size in the
+ *  project): main() and, on top of whatever it is using at the time, every
+ *  interrupt handler, with 104 bytes of exception frame each when the FPU
+ *  context is stacked.  stack_init() fills the part below the caller with
+ *  STACK_PAINT, so stack_high_water() can later find the deepest the stack
+ *  has been by looking for the lowest word that was overwritten.
+ *
+ *  With a guard the lowest STACK_GUARD_BYTES of the stack become an MPU
+ *  region nothing may access.  A stack that grows into it is a MemManage
+ *  fault, caught and recorded by FaultDump.c, instead of silently
+ *  overwriting the data below it.  The guard comes out of the stack size set
+ *  in the project; stack_monitor.size is what is left above it.
+ *
+ *    stack_monitor.size         bytes above the guard
+ *    stack_monitor.high_water   deepest use seen by stack_high_water()
+ *    stack_monitor.guarded      the MPU guard is on
+ *
+ *  On the host the firmware runs on the PC's stack, which is not measured.
+ */
+#ifndef STACKMONITOR_H_
+#define STACKMONITOR_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define STACK_PAINT         0x5AC5AC5A
+#define STACK_GUARD_BYTES   32          // the smallest MPU region
+#define STACK_GUARD_REGION  7           // highest priority MPU region
+
+typedef struct
+{
+    uint32_t *bottom;           // lowest usable word, above the guard
+    uint32_t *top;              // initial stack pointer
+    uint32_t size;
+    uint32_t high_water;
+    bool guarded;
+} stack_monitor_t;
+
+extern stack_monitor_t stack_monitor;
+
+void stack_init(bool guard);
+uint32_t stack_high_water(void);
+
+#endif /* STACKMONITOR_H_ */
@@ -0,0 +1,137 @@
+/*
+ * StateMachine.c
+ *
+ * Table driven state machine runtime.  See StateMachine.h.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "StateMachine.h"
+
+/*
+ *  Record a transition in the history ring buffer.
+ */
+static void sm_record(state_machine_t *sm, sm_state_t from, sm_state_t to, sm_event_t event)
+{
+    sm_history_entry_t *h = &sm->history[sm->history_next];
+
+    h->step = sm->step;
+    h->from = from;
+    h->to = to;
+    h->event = event;
+
+    sm->history_next = (sm->history_next + 1) % SM_HISTORY_SIZE;
+    sm->transition_count++;
+}
+
+/*
+ *  Leave the current state and enter a new one, running the exit and entry handlers.
+ */
+static void sm_enter(state_machine_t *sm, sm_state_t to, sm_event_t event)
+{
+    sm_state_t from = sm->current;
+
+    if (sm->states[from].exit)
+        sm->states[from].exit();
+
+    sm_record(sm, from, to, event);
+    sm->current = to;
+
+    if (sm->states[to].entry)
+        sm->states[to].entry();
+
+    if (sm->on_transition)
+        sm->on_transition(from, to, event);
+}
+
+/*
+ *  Initialize a state machine and enter the initial state.
+ *
+ *  The state and transition tables are not copied, they should be declared const
+ *  so they stay in flash.
+ */
+void sm_init(state_machine_t *sm,
+             const sm_state_handlers_t *states, uint8_t num_states,
+             const sm_transition_t *transitions, uint8_t num_transitions,
+             sm_state_t initial)
+{
+    sm->states = states;
+    sm->num_states = num_states;
+    sm->transitions = transitions;
+    sm->num_transitions = num_transitions;
+    sm->step = 0;
+    sm->history_next = 0;
+    sm->transition_count = 0;
+    sm->on_transition = NULL;
+    sm->current = initial;
+
+    sm_record(sm, initial, initial, SM_NO_EVENT);
+
+    if (sm->states[initial].entry)
+        sm->states[initial].entry();
+}
+
+/*
+ *  Send an event to the state machine.
+ *
+ *  The transition table is searched in order and the first row matching the
+ *  current state (or SM_ANY_STATE) and the event is taken.  Returns true if a
+ *  transition was taken, false if the event is ignored in the current state.
+ */
+bool sm_dispatch(state_machine_t *sm, sm_event_t event)
+{
+    uint8_t i;
+    const sm_transition_t *t;
+
+    if (event == SM_NO_EVENT)
+        return false;
+
+    for (i = 0; i < sm->num_transitions; i++)
+    {
+        t = &sm->transitions[i];
+
+        if ((t->event == event) && ((t->from == sm->current) || (t->from == SM_ANY_STATE)))
+        {
+            sm_enter(sm, t->to, event);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*
+ *  Run one pass of the current state's do handler.
+ *
+ *  Call once per main loop iteration.  If the do handler returns an event it is
+ *  dispatched before returning.
+ */
+void sm_run(state_machine_t *sm)
+{
+    sm_event_t event = SM_NO_EVENT;
+
+    sm->step++;
+
+    if (sm->states[sm->current].during)
+        event = sm->states[sm->current].during();
+
+    sm_dispatch(sm, event);
+}
+
+/*
+ *  Return the current state.
+ */
+sm_state_t sm_get_state(const state_machine_t *sm)
+{
+    return sm->current;
+}
+
+/*
+ *  Call hook after every transition, once the new state's entry handler has
+ *  run.  Pass NULL to remove it.
+ */
+void sm_set_transition_hook(state_machine_t *sm, sm_transition_hook_t hook)
+{
+    sm->on_transition = hook;
+}
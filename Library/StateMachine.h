@@ -0,0 +1,81 @@
+/*
+ *  StateMachine.h
+ *
+ *  Table driven state machine runtime.
+ *
+ *  A state machine is described by two const tables (kept in flash):
+ *    - a state table giving the entry, do and exit handler of every state
+ *    - a transition table of {from state, event, to state} rows
+ *
+ *  Entry and exit handlers run only when a transition is taken, so actuators
+ *  are written once per transition instead of on every pass of the main loop.
+ *  The do handler runs on every call to sm_run() and may return an event
+ *  (for example "target reached") which is dispatched immediately.
+ */
+#ifndef STATEMACHINE_H_
+#define STATEMACHINE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define SM_NO_EVENT     0xFF    // returned by a do handler that has nothing to report
+#define SM_ANY_STATE    0xFF    // "from" wildcard, matches every state
+#define SM_HISTORY_SIZE 16      // number of transitions kept for debugging
+
+typedef uint8_t sm_state_t;
+typedef uint8_t sm_event_t;
+
+typedef void (*sm_action_t)(void);
+typedef sm_event_t (*sm_do_action_t)(void);
+typedef void (*sm_transition_hook_t)(sm_state_t from, sm_state_t to, sm_event_t event);
+
+typedef struct
+{
+    sm_action_t entry;          // called once when the state is entered, may be NULL
+    sm_do_action_t during;      // called every sm_run(), may be NULL
+    sm_action_t exit;           // called once when the state is left, may be NULL
+} sm_state_handlers_t;
+
+typedef struct
+{
+    sm_state_t from;            // SM_ANY_STATE matches every state
+    sm_event_t event;
+    sm_state_t to;
+} sm_transition_t;
+
+typedef struct
+{
+    uint32_t step;              // value of the step counter when the transition was taken
+    sm_state_t from;
+    sm_state_t to;
+    sm_event_t event;
+} sm_history_entry_t;
+
+typedef struct
+{
+    const sm_state_handlers_t *states;
+    uint8_t num_states;
+    const sm_transition_t *transitions;
+    uint8_t num_transitions;
+
+    sm_state_t current;
+    uint32_t step;              // number of sm_run() calls
+
+    // Ring buffer of the most recent transitions, newest at history_next-1
+    sm_history_entry_t history[SM_HISTORY_SIZE];
+    uint8_t history_next;
+    uint32_t transition_count;
+
+    sm_transition_hook_t on_transition;     // called after every transition, may be NULL
+} state_machine_t;
+
+void sm_init(state_machine_t *sm,
+             const sm_state_handlers_t *states, uint8_t num_states,
+             const sm_transition_t *transitions, uint8_t num_transitions,
+             sm_state_t initial);
+bool sm_dispatch(state_machine_t *sm, sm_event_t event);
+void sm_run(state_machine_t *sm);
+sm_state_t sm_get_state(const state_machine_t *sm);
+void sm_set_transition_hook(state_machine_t *sm, sm_transition_hook_t hook);
+
+#endif /* STATEMACHINE_H_ */
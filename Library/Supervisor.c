@@ -0,0 +1,156 @@
+/*
+ * Supervisor.c
+ *
+ * Watchdog supervision of the program's critical tasks.  See Supervisor.h.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "msp.h"
+#include <ti/devices/msp432p4xx/driverlib/driverlib.h>
+#include "RamFunc.h"
+#include "Supervisor.h"
+
+// Watchdog periods from the 32768 Hz ACLK, shortest first
+typedef struct
+{
+    uint_fast8_t iterations;
+    uint32_t ms;
+} sup_period_t;
+
+static const sup_period_t sup_periods[] =
+{
+    { WDT_A_CLOCKITERATIONS_512,    15 },
+    { WDT_A_CLOCKITERATIONS_8192,   250 },
+    { WDT_A_CLOCKITERATIONS_32K,    1000 },
+    { WDT_A_CLOCKITERATIONS_512K,   16000 },
+};
+
+#define NUM_SUP_PERIODS (sizeof(sup_periods) / sizeof(sup_periods[0]))
+
+supervisor_t supervisor;
+
+static sup_expiry_handler_t expiry_handler;
+
+/*
+ *  Call early in main(), before anything resets the reset source flags.
+ *  Clears the task table.
+ */
+void sup_init(void)
+{
+    supervisor.watchdog_reset = (MAP_ResetCtl_getHardResetSource() & RESET_SRC_1) != 0;
+    MAP_ResetCtl_clearHardResetSource(RESET_SRC_1);
+
+    supervisor.running = false;
+    supervisor.watchdog_ms = 0;
+    supervisor.kicks = 0;
+    supervisor.num_tasks = 0;
+}
+
+/*
+ *  Register a task that checks in at least every deadline_ms.  Returns its
+ *  number for sup_checkin(), SUP_MAX_TASKS if the table is full.  The name
+ *  is not copied.
+ */
+uint8_t sup_add_task(const char *name, uint32_t deadline_ms)
+{
+    sup_task_t *task;
+
+    if (supervisor.running || (supervisor.num_tasks >= SUP_MAX_TASKS))
+        return SUP_MAX_TASKS;
+
+    task = &supervisor.tasks[supervisor.num_tasks];
+    task->name = name;
+    task->deadline_ms = deadline_ms;
+    task->since_ms = 0;
+    task->worst_ms = 0;
+    task->checkins = 0;
+
+    return supervisor.num_tasks++;
+}
+
+/*
+ *  Start the watchdog and the deadline checks.  Returns false if the
+ *  longest deadline does not fit the longest watchdog period.
+ */
+bool sup_start(sup_expiry_handler_t on_expiry)
+{
+    uint32_t longest = 0;
+    uint8_t i;
+
+    for (i = 0; i < supervisor.num_tasks; i++)
+    {
+        supervisor.tasks[i].since_ms = 0;
+        if (supervisor.tasks[i].deadline_ms > longest)
+            longest = supervisor.tasks[i].deadline_ms;
+    }
+
+    // Long enough that a late task is caught by sup_tick() first
+    for (i = 0; i < NUM_SUP_PERIODS; i++)
+    {
+        if (sup_periods[i].ms >= 2 * longest)
+            break;
+    }
+
+    if (i == NUM_SUP_PERIODS)
+        return false;
+
+    expiry_handler = on_expiry;
+    supervisor.watchdog_ms = sup_periods[i].ms;
+
+    MAP_WDT_A_initWatchdogTimer(WDT_A_CLOCKSOURCE_ACLK, sup_periods[i].iterations);
+    MAP_WDT_A_setTimeoutReset(WDT_A_HARD_RESET);    // a soft reset leaves the PWM running
+    MAP_WDT_A_startTimer();
+
+    supervisor.running = true;
+
+    return true;
+}
+
+/*
+ *  The task is alive.  Call from its own context, not from an interrupt
+ *  handler that would keep running if the task hung.
+ */
+void sup_checkin(uint8_t task)
+{
+    sup_task_t *t;
+
+    if (task >= supervisor.num_tasks)
+        return;
+
+    t = &supervisor.tasks[task];
+    if (t->since_ms > t->worst_ms)
+        t->worst_ms = t->since_ms;
+    t->since_ms = 0;
+    t->checkins++;
+}
+
+/*
+ *  Call every millisecond from SysTick_Handler.
+ */
+RAMFUNC void sup_tick(void)
+{
+    uint8_t i;
+
+    if (!supervisor.running)
+        return;
+
+    for (i = 0; i < supervisor.num_tasks; i++)
+    {
+        if (++supervisor.tasks[i].since_ms > supervisor.tasks[i].deadline_ms)
+        {
+            supervisor.running = false;
+
+            // A full period for the handler, the watchdog still catches it hanging
+            MAP_WDT_A_clearTimer();
+            if (expiry_handler)
+                expiry_handler(i, supervisor.tasks[i].since_ms);
+
+            MAP_ResetCtl_initiateHardReset();
+            return;
+        }
+    }
+
+    MAP_WDT_A_clearTimer();
+    supervisor.kicks++;
+}
@@ -0,0 +1,64 @@
+/*
+ *  Supervisor.h
+ *
+ *  Watchdog supervision of the program's critical tasks.
+ *
+ *  Each task is registered with a deadline and checks in at least that
+ *  often, the main loop for example once per iteration.  sup_tick(), from
+ *  the 1 ms SysTick interrupt, counts the time since every task's last
+ *  check-in and clears the WDT_A watchdog while all of them are on time.
+ *
+ *  When a task misses its deadline the program's expiry handler is called
+ *  to put the outputs in a safe state and log the cause, then the device
+ *  is reset.  If the SysTick interrupt itself stops, interrupts stay
+ *  masked or the handler hangs, nothing clears the watchdog and it resets
+ *  the device on its own.  The watchdog runs from ACLK (the 32 kHz REFO),
+ *  so its period does not change with the power manager's clock dividers;
+ *  sup_start() picks the shortest one at least twice the longest deadline.
+ *
+ *  After a reset sup_init() tells whether the watchdog caused it:
+ *  supervisor.watchdog_reset.
+ */
+#ifndef SUPERVISOR_H_
+#define SUPERVISOR_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define SUP_MAX_TASKS       4
+
+/*
+ *  Called from the SysTick interrupt when a task is late, before the reset.
+ *  task is the number sup_add_task() returned, late_ms the time since its
+ *  last check-in.
+ */
+typedef void (*sup_expiry_handler_t)(uint8_t task, uint32_t late_ms);
+
+typedef struct
+{
+    const char *name;
+    uint32_t deadline_ms;
+    uint32_t since_ms;          // since the last check-in
+    uint32_t worst_ms;          // longest gap between check-ins
+    uint32_t checkins;
+} sup_task_t;
+
+typedef struct
+{
+    bool running;
+    bool watchdog_reset;        // the last reset was a watchdog time-out
+    uint32_t watchdog_ms;       // hardware watchdog period
+    uint32_t kicks;             // watchdog clears
+    sup_task_t tasks[SUP_MAX_TASKS];
+    uint8_t num_tasks;
+} supervisor_t;
+
+extern supervisor_t supervisor;
+
+void sup_init(void);
+uint8_t sup_add_task(const char *name, uint32_t deadline_ms);
+bool sup_start(sup_expiry_handler_t on_expiry);
+void sup_checkin(uint8_t task);
+void sup_tick(void);
+
+#endif /* SUPERVISOR_H_ */
@@ -0,0 +1,368 @@
+/*
+ * Telemetry.c
+ *
+ * Binary telemetry stream on the backchannel UART.  See Telemetry.h.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "msp.h"
+#include <ti/devices/msp432p4xx/driverlib/driverlib.h>
+#include "Telemetry.h"
+#include "Clock.h"
+#include "RamFunc.h"
+
+#define TM_DMA_CHANNEL  0
+
+/*
+ * The baud rate dividers are worked out from SMCLK by tm_uart_init(), for
+ * the 12 MHz SMCLK: N = 26.04, oversampling with UCBRx = 1, UCBRFx = 10,
+ * UCBRSx = 0x00, as in the MSP432 TRM baud rate table.
+ */
+eUSCI_UART_Config telemetryUartConfig =
+{
+    EUSCI_A_UART_CLOCKSOURCE_SMCLK,                 // SMCLK Clock Source
+    1,                                              // BRDIV
+    10,                                             // UCxBRF
+    0x00,                                           // UCxBRS
+    EUSCI_A_UART_NO_PARITY,                         // No Parity
+    EUSCI_A_UART_LSB_FIRST,                         // LSB First
+    EUSCI_A_UART_ONE_STOP_BIT,                      // One stop bit
+    EUSCI_A_UART_MODE,                              // UART mode
+    EUSCI_A_UART_OVERSAMPLING_BAUDRATE_GENERATION   // Oversampling
+};
+
+/* The uDMA control table, 8 channels primary and alternate, must be 256 byte aligned */
+#if defined(__TI_COMPILER_VERSION__)
+#pragma DATA_ALIGN(telemetryDmaTable, 256)
+DMA_ControlTable telemetryDmaTable[16];
+#else
+DMA_ControlTable telemetryDmaTable[16] __attribute__((aligned(256)));
+#endif
+
+/*
+ * UCBRSx for the fractional part of N = SMCLK / baud, in 1/10000
+ * (MSP432 TRM table 24-4): the last entry not above the fraction.
+ */
+static const struct
+{
+    uint16_t fraction;
+    uint8_t brs;
+} tm_brs_table[] =
+{
+    {    0, 0x00 }, {  529, 0x01 }, {  715, 0x02 }, {  835, 0x04 },
+    { 1001, 0x08 }, { 1252, 0x10 }, { 1430, 0x20 }, { 1670, 0x11 },
+    { 2147, 0x21 }, { 2224, 0x22 }, { 2503, 0x44 }, { 3000, 0x25 },
+    { 3335, 0x49 }, { 3575, 0x4A }, { 3753, 0x52 }, { 4003, 0x92 },
+    { 4286, 0x53 }, { 4378, 0x55 }, { 5002, 0xAA }, { 5715, 0x6B },
+    { 6003, 0xAD }, { 6254, 0xB5 }, { 6432, 0xB6 }, { 6667, 0xD6 },
+    { 7001, 0xB7 }, { 7147, 0xBB }, { 7503, 0xDD }, { 7861, 0xED },
+    { 8004, 0xEE }, { 8333, 0xBF }, { 8464, 0xDF }, { 8572, 0xEF },
+    { 8751, 0xF7 }, { 9004, 0xFB }, { 9170, 0xFD }, { 9288, 0xFE }
+};
+
+static const uint8_t tm_type_size[NUM_TM_TYPES] = { 1, 1, 2, 2, 4, 4, 4 };
+
+typedef struct
+{
+    const char *name;
+    const volatile void *address;
+    tm_type_t type;
+} tm_signal_t;
+
+static tm_signal_t signals[TM_MAX_SIGNALS];
+static uint8_t num_signals = 0;
+static uint16_t data_length = 0;            // payload bytes of a data frame
+static uint16_t descriptor_length = 1;      // payload bytes of the descriptor
+
+static uint8_t frame[TM_HEADER_SIZE + TM_MAX_PAYLOAD + TM_CHECK_SIZE];
+
+static bool enabled = false;
+static uint16_t period_ms = 10;
+static uint16_t countdown = 0;
+static uint16_t descriptor_countdown = 0;   // 0 sends the descriptor next
+static uint16_t sequence = 0;
+static uint32_t time_ms = 0;
+
+uint32_t telemetry_frames = 0;
+uint32_t telemetry_dropped = 0;
+
+/*
+ *  Work out the TELEMETRY_BAUD dividers from SMCLK and (re)start the UART
+ */
+static void tm_uart_init(void)
+{
+    uint32_t smclk = Clock_GetSMCLK();
+    uint32_t n10000 = (uint32_t)(((uint64_t)smclk * 10000) / TELEMETRY_BAUD);
+    uint32_t n = n10000 / 10000;
+    uint32_t i;
+
+    if (n >= 16)
+    {
+        telemetryUartConfig.overSampling = EUSCI_A_UART_OVERSAMPLING_BAUDRATE_GENERATION;
+        telemetryUartConfig.clockPrescalar = n / 16;
+        telemetryUartConfig.firstModReg = n % 16;
+    }
+    else
+    {
+        telemetryUartConfig.overSampling = EUSCI_A_UART_LOW_FREQUENCY_BAUDRATE_GENERATION;
+        telemetryUartConfig.clockPrescalar = n ? n : 1;
+        telemetryUartConfig.firstModReg = 0;
+    }
+
+    for (i = 0; (i + 1 < sizeof(tm_brs_table) / sizeof(tm_brs_table[0])) &&
+                (tm_brs_table[i + 1].fraction <= n10000 % 10000); i++)
+        ;
+    telemetryUartConfig.secondModReg = tm_brs_table[i].brs;
+
+    MAP_UART_initModule(EUSCI_A0_BASE, &telemetryUartConfig);
+    MAP_UART_enableModule(EUSCI_A0_BASE);
+}
+
+/*
+ *  Clock change handler: let the frame on the wire finish, then move the
+ *  UART to the new SMCLK
+ */
+static void telemetry_clock_changed(void)
+{
+    bool wasDisabled;
+
+    for (;;)
+    {
+        wasDisabled = MAP_Interrupt_disableMaster();
+        if (!MAP_DMA_isChannelEnabled(TM_DMA_CHANNEL) &&
+            !MAP_UART_queryStatusFlags(EUSCI_A0_BASE, EUSCI_A_UART_BUSY))
+            break;
+        if (!wasDisabled)
+            MAP_Interrupt_enableMaster();
+    }
+
+    tm_uart_init();
+
+    if (!wasDisabled)
+        MAP_Interrupt_enableMaster();
+}
+
+/*
+ *  Set up the UART and its DMA channel and send rate_hz frames per second.
+ *  Register the signals with telemetry_add_signal() before the first tick.
+ */
+void telemetry_init(uint16_t rate_hz)
+{
+    /* P1.2 and P1.3 in UART mode */
+    MAP_GPIO_setAsPeripheralModuleFunctionInputPin(GPIO_PORT_P1,
+            GPIO_PIN2 | GPIO_PIN3, GPIO_PRIMARY_MODULE_FUNCTION);
+
+    tm_uart_init();
+    Clock_AddChangeHandler(telemetry_clock_changed);
+
+    MAP_DMA_enableModule();
+    MAP_DMA_setControlBase(telemetryDmaTable);
+    MAP_DMA_assignChannel(DMA_CH0_EUSCIA0TX);
+    MAP_DMA_disableChannelAttribute(DMA_CH0_EUSCIA0TX,
+            UDMA_ATTR_ALTSELECT | UDMA_ATTR_USEBURST | UDMA_ATTR_HIGH_PRIORITY | UDMA_ATTR_REQMASK);
+    MAP_DMA_setChannelControl(UDMA_PRI_SELECT | DMA_CH0_EUSCIA0TX,
+            UDMA_SIZE_8 | UDMA_SRC_INC_8 | UDMA_DST_INC_NONE | UDMA_ARB_1);
+
+    telemetry_set_rate(rate_hz);
+    descriptor_countdown = 0;
+    enabled = true;
+}
+
+/*
+ *  Add a signal to every data frame.  The name is not copied.  Returns false
+ *  if the frame has no room for it.
+ */
+bool telemetry_add_signal(const char *name, const volatile void *address, tm_type_t type)
+{
+    uint8_t name_length = strlen(name);
+
+    if (name_length > TM_MAX_NAME)
+        name_length = TM_MAX_NAME;
+
+    if ((num_signals >= TM_MAX_SIGNALS) || (type >= NUM_TM_TYPES) ||
+        (data_length + tm_type_size[type] > TM_MAX_PAYLOAD) ||
+        (descriptor_length + 2 + name_length > TM_MAX_PAYLOAD))
+        return false;
+
+    signals[num_signals].name = name;
+    signals[num_signals].address = address;
+    signals[num_signals].type = type;
+    num_signals++;
+
+    data_length += tm_type_size[type];
+    descriptor_length += 2 + name_length;
+    descriptor_countdown = 0;
+
+    return true;
+}
+
+/*
+ *  Frames per second, 1 to 1000.  Frames that do not fit in the time the
+ *  previous one takes on the wire are dropped and counted.
+ */
+void telemetry_set_rate(uint16_t rate_hz)
+{
+    if (rate_hz == 0)
+        rate_hz = 1;
+
+    period_ms = (rate_hz >= 1000) ? 1 : (1000 / rate_hz);
+    countdown = 0;
+}
+
+void telemetry_enable(bool enable)
+{
+    enabled = enable;
+}
+
+static uint8_t *put16(uint8_t *p, uint16_t v)
+{
+    *p++ = v;
+    *p++ = v >> 8;
+    return p;
+}
+
+static uint8_t *put32(uint8_t *p, uint32_t v)
+{
+    *p++ = v;
+    *p++ = v >> 8;
+    *p++ = v >> 16;
+    *p++ = v >> 24;
+    return p;
+}
+
+static uint8_t *pack_data(uint8_t *p)
+{
+    const volatile void *a;
+    uint32_t v;
+    uint8_t i;
+
+    for (i = 0; i < num_signals; i++)
+    {
+        a = signals[i].address;
+
+        switch (signals[i].type)
+        {
+        case TM_U8:
+        case TM_I8:
+            *p++ = *(const volatile uint8_t *)a;
+            break;
+        case TM_U16:
+        case TM_I16:
+            p = put16(p, *(const volatile uint16_t *)a);
+            break;
+        case TM_FLOAT:
+            memcpy(&v, (const void *)a, 4);
+            p = put32(p, v);
+            break;
+        default:
+            p = put32(p, *(const volatile uint32_t *)a);
+            break;
+        }
+    }
+
+    return p;
+}
+
+static uint8_t *pack_descriptor(uint8_t *p)
+{
+    uint8_t name_length;
+    uint8_t i;
+
+    *p++ = num_signals;
+
+    for (i = 0; i < num_signals; i++)
+    {
+        name_length = strlen(signals[i].name);
+        if (name_length > TM_MAX_NAME)
+            name_length = TM_MAX_NAME;
+
+        *p++ = signals[i].type;
+        *p++ = name_length;
+        memcpy(p, signals[i].name, name_length);
+        p += name_length;
+    }
+
+    return p;
+}
+
+/*
+ *  Pack one frame into the DMA buffer and start sending it.
+ */
+static void telemetry_send(void)
+{
+    uint8_t *p = frame;
+    uint8_t *payload;
+    uint32_t sum1 = 0;
+    uint32_t sum2 = 0;
+    uint16_t length;
+    uint16_t i;
+
+    if (MAP_DMA_isChannelEnabled(TM_DMA_CHANNEL))
+    {
+        telemetry_dropped++;
+        return;
+    }
+
+    *p++ = TM_SYNC1;
+    *p++ = TM_SYNC2;
+
+    if (descriptor_countdown == 0)
+    {
+        descriptor_countdown = TM_DESCRIPTOR_PERIOD;
+        *p++ = TM_FRAME_DESCRIPTOR;
+        payload = p + 7;
+        p = pack_descriptor(payload);
+    }
+    else
+    {
+        descriptor_countdown--;
+        *p++ = TM_FRAME_DATA;
+        payload = p + 7;
+        p = pack_data(payload);
+    }
+
+    frame[3] = p - payload;
+    put16(&frame[4], sequence++);
+    put32(&frame[6], time_ms);
+
+    // Fletcher-16, the sums are small enough to reduce once at the end
+    length = p - frame;
+    for (i = 2; i < length; i++)
+    {
+        sum1 += frame[i];
+        sum2 += sum1;
+    }
+    *p++ = sum1 % 255;
+    *p++ = sum2 % 255;
+    length += TM_CHECK_SIZE;
+
+    MAP_DMA_setChannelTransfer(UDMA_PRI_SELECT | DMA_CH0_EUSCIA0TX, UDMA_MODE_BASIC, frame,
+            (void *)(uintptr_t)MAP_UART_getTransmitBufferAddressForDMA(EUSCI_A0_BASE), length);
+    MAP_DMA_enableChannel(TM_DMA_CHANNEL);
+
+    // The DMA is started by TXIFG rising.  If TXBUF is already empty there is
+    // no edge to come, so move the first byte by software.
+    if (MAP_UART_getInterruptStatus(EUSCI_A0_BASE, EUSCI_A_UART_TRANSMIT_INTERRUPT_FLAG))
+        MAP_DMA_requestSoftwareTransfer(TM_DMA_CHANNEL);
+
+    telemetry_frames++;
+}
+
+/*
+ *  Call every millisecond from SysTick_Handler.  Runs from SRAM.
+ */
+RAMFUNC void telemetry_tick(void)
+{
+    time_ms++;
+
+    if (!enabled || (num_signals == 0))
+        return;
+
+    if (++countdown < period_ms)
+        return;
+
+    countdown = 0;
+    telemetry_send();
+}
@@ -0,0 +1,67 @@
+/*
+ *  Telemetry.h
+ *
+ *  Binary telemetry stream on the backchannel UART.
+ *
+ *  eUSCI_A0 (P1.2 RX, P1.3 TX) is wired to the XDS110 debug probe and shows up
+ *  on the PC as a virtual COM port.  Signals are registered once by address
+ *  and type.  At a fixed rate, from the SysTick interrupt, their current
+ *  values are packed into a frame which DMA channel 0 feeds to the UART, so
+ *  the CPU never waits on the UART and never copies a byte to it.
+ *
+ *  Frame, multi byte fields little endian:
+ *
+ *    0xA5 0x5A  type  length  sequence(2)  time_ms(4)  payload(length)  check(2)
+ *
+ *  type TM_FRAME_DATA carries the signal values in registration order.
+ *  type TM_FRAME_DESCRIPTOR lists the signals, a count and then for each a
+ *  tm_type_t byte, a name length byte and the name.  It is sent first and
+ *  then every TM_DESCRIPTOR_PERIOD frames so a decoder can join at any time.
+ *  check is a Fletcher-16 checksum (sum1, then sum2) of type to the end of
+ *  the payload.
+ *
+ *  Host/telemetry/tmdecode turns a captured stream into CSV.
+ */
+#ifndef TELEMETRY_H_
+#define TELEMETRY_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define TELEMETRY_BAUD          460800
+
+#define TM_MAX_SIGNALS          16
+#define TM_MAX_NAME             15
+#define TM_MAX_PAYLOAD          255
+#define TM_DESCRIPTOR_PERIOD    100     // data frames between descriptors
+
+#define TM_SYNC1                0xA5
+#define TM_SYNC2                0x5A
+#define TM_HEADER_SIZE          10
+#define TM_CHECK_SIZE           2
+
+#define TM_FRAME_DATA           0x01
+#define TM_FRAME_DESCRIPTOR     0x02
+
+typedef enum
+{
+    TM_U8 = 0,
+    TM_I8,
+    TM_U16,
+    TM_I16,
+    TM_U32,
+    TM_I32,
+    TM_FLOAT,
+    NUM_TM_TYPES
+} tm_type_t;
+
+extern uint32_t telemetry_frames;       // frames handed to the DMA
+extern uint32_t telemetry_dropped;      // frames skipped, the previous one was still being sent
+
+void telemetry_init(uint16_t rate_hz);
+bool telemetry_add_signal(const char *name, const volatile void *address, tm_type_t type);
+void telemetry_set_rate(uint16_t rate_hz);
+void telemetry_enable(bool enable);
+void telemetry_tick(void);
+
+#endif /* TELEMETRY_H_ */
@@ -0,0 +1,204 @@
+/*
+ * WheelMonitor.c
+ *
+ * Wheel stall, slip and encoder failure detection.  See WheelMonitor.h.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <math.h>
+#include "Motor.h"
+#include "Encoder.h"
+#include "RamFunc.h"
+#include "WheelMonitor.h"
+
+/*
+ * Tuning, globals so they can be changed from the debugger
+ */
+float wheel_min_power = 0.06;       // below this a motor is in its dead band and is not checked
+int32_t wheel_stall_rate = 20;      // counts/s, a driven wheel slower than this is not turning
+float wheel_slip_ratio = 0.5;       // counts/s per unit power of the two wheels differ by this much
+uint8_t wheel_confirm_windows = 3;  // windows in a row before a condition is reported
+float wheel_stall_power = 0.25;     // motor_power_limit while stalled
+
+wheel_monitor_t wheel_monitor;
+
+static uint16_t window_ms;
+static int last_count[2];
+static wheel_condition_t candidate;
+static uint8_t candidate_sides;
+static uint8_t candidate_drive;
+static uint8_t streak;
+static bool started;
+static volatile wheel_condition_t pending;
+
+/*
+ *  Start watching from the current encoder counts.  Call after
+ *  encoder_init(); wheel_tick() does nothing until then, so a motor
+ *  calibration can drive the wheels in their dead band first.
+ */
+void wheel_init(void)
+{
+    uint8_t i;
+
+    wheel_monitor.condition = WHEEL_OK;
+    wheel_monitor.sides = 0;
+    for (i = 0; i < NUM_WHEEL_CONDITIONS; i++)
+        wheel_monitor.seen[i] = 0;
+
+    last_count[0] = get_left_motor_count();
+    last_count[1] = get_right_motor_count();
+    window_ms = 0;
+    candidate = WHEEL_OK;
+    streak = 0;
+    pending = WHEEL_OK;
+    motor_power_limit = 1.0;
+    started = true;
+}
+
+/*
+ *  What the last window shows, and in *sides the wheels it is about
+ */
+static wheel_condition_t wheel_classify(uint8_t *sides)
+{
+    bool driven[2], turning[2];
+    float per_power[2];
+    uint8_t i;
+
+    *sides = 0;
+
+    for (i = 0; i < 2; i++)
+    {
+        driven[i] = fabsf(wheel_monitor.power[i]) >= wheel_min_power;
+        turning[i] = abs(wheel_monitor.rate[i]) >= wheel_stall_rate;
+        per_power[i] = driven[i] ? abs(wheel_monitor.rate[i]) / fabsf(wheel_monitor.power[i]) : 0;
+
+        // Counting against the direction it is driven in
+        if (driven[i] && turning[i] && ((wheel_monitor.rate[i] > 0) != (wheel_monitor.power[i] > 0)))
+            *sides |= 1 << i;
+    }
+
+    if (*sides)
+        return WHEEL_ENCODER;
+
+    if (!driven[0] && !driven[1])
+        return WHEEL_OK;
+
+    // No driven wheel turns
+    if ((!driven[0] || !turning[0]) && (!driven[1] || !turning[1]))
+    {
+        *sides = (driven[0] ? WHEEL_LEFT : 0) | (driven[1] ? WHEEL_RIGHT : 0);
+        return WHEEL_STALL;
+    }
+
+    // One does, the robot is not pinned: the other one's encoder is silent
+    for (i = 0; i < 2; i++)
+        if (driven[i] && !turning[i])
+            *sides |= 1 << i;
+
+    if (*sides)
+        return WHEEL_ENCODER;
+
+    if (driven[0] && driven[1] &&
+        (fabsf(per_power[0] - per_power[1]) > wheel_slip_ratio * fmaxf(per_power[0], per_power[1])))
+    {
+        *sides = WHEEL_LEFT | WHEEL_RIGHT;
+        return WHEEL_SLIP;
+    }
+
+    return WHEEL_OK;
+}
+
+/*
+ *  Which wheels are driven and which way, a new combination is a new move
+ */
+static uint8_t wheel_drive(void)
+{
+    uint8_t drive = 0;
+    uint8_t i;
+
+    for (i = 0; i < 2; i++)
+    {
+        if (fabsf(wheel_monitor.power[i]) >= wheel_min_power)
+            drive |= (wheel_monitor.power[i] > 0) ? (1 << (2 * i)) : (2 << (2 * i));
+    }
+
+    return drive;
+}
+
+/*
+ *  Call every 1 ms, from the SysTick interrupt.  Does its work once per
+ *  WHEEL_WINDOW_MS.
+ */
+RAMFUNC void wheel_tick(void)
+{
+    wheel_condition_t condition;
+    uint8_t sides, drive;
+    int count[2];
+
+    if (!started || (++window_ms < WHEEL_WINDOW_MS))
+        return;
+    window_ms = 0;
+
+    count[0] = get_left_motor_count();
+    count[1] = get_right_motor_count();
+    wheel_monitor.rate[0] = (count[0] - last_count[0]) * (1000 / WHEEL_WINDOW_MS);
+    wheel_monitor.rate[1] = (count[1] - last_count[1]) * (1000 / WHEEL_WINDOW_MS);
+    last_count[0] = count[0];
+    last_count[1] = count[1];
+
+    wheel_monitor.power[0] = get_left_motor_power();
+    wheel_monitor.power[1] = get_right_motor_power();
+
+    condition = wheel_classify(&sides);
+    drive = wheel_drive();
+
+    // The same condition through a new move, backing off a stall for
+    // example, is reported again
+    if ((condition == candidate) && (sides == candidate_sides) && (drive == candidate_drive))
+    {
+        if (streak < 255)
+            streak++;
+    }
+    else
+    {
+        candidate = condition;
+        candidate_sides = sides;
+        candidate_drive = drive;
+        streak = 1;
+    }
+
+    if (condition == WHEEL_OK)
+    {
+        if (wheel_monitor.condition == WHEEL_STALL)
+            motor_power_limit = 1.0;
+        wheel_monitor.condition = WHEEL_OK;
+        wheel_monitor.sides = 0;
+    }
+    else if (streak == wheel_confirm_windows)
+    {
+        if (condition == WHEEL_STALL)
+            motor_power_limit = wheel_stall_power;
+        else if (wheel_monitor.condition == WHEEL_STALL)
+            motor_power_limit = 1.0;
+
+        wheel_monitor.condition = condition;
+        wheel_monitor.sides = sides;
+        wheel_monitor.seen[condition]++;
+        pending = condition;
+    }
+}
+
+/*
+ *  The condition reported since the last call, WHEEL_OK if none.  For the
+ *  main loop.
+ */
+wheel_condition_t wheel_event(void)
+{
+    wheel_condition_t event = pending;
+
+    pending = WHEEL_OK;
+
+    return event;
+}
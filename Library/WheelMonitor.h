@@ -0,0 +1,69 @@
+/*
+ *  WheelMonitor.h
+ *
+ *  Wheel stall, slip and encoder failure detection.
+ *
+ *  wheel_tick(), from the 1 ms SysTick interrupt, compares the power each
+ *  motor is driven with (get_left_motor_power(), get_right_motor_power())
+ *  with the encoder counts every WHEEL_WINDOW_MS.  A condition has to last
+ *  wheel_confirm_windows windows in a row before it is reported, which
+ *  rides out the motors spinning up and the PI controller reversing near
+ *  its target:
+ *
+ *    WHEEL_STALL     every driven wheel is below wheel_stall_rate, the
+ *                    robot is pushing against something that did not
+ *                    press a bumper.  motor_power_limit drops to
+ *                    wheel_stall_power until a wheel turns again
+ *    WHEEL_ENCODER   a driven wheel counts nothing while the other one
+ *                    turns, or counts against the direction it is
+ *                    driven in: its A or B channel is dead
+ *    WHEEL_SLIP      both wheels turn, but their speed per unit power
+ *                    differs by more than wheel_slip_ratio
+ *
+ *  The program polls wheel_event() from its main loop, which returns each
+ *  new condition once.  wheel_monitor shows the current state and how
+ *  often each condition was seen.  The thresholds are globals, like the
+ *  Motor.c tuning, so they can be changed from the debugger.
+ */
+#ifndef WHEELMONITOR_H_
+#define WHEELMONITOR_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define WHEEL_WINDOW_MS     100
+
+#define WHEEL_LEFT          0x01        // wheel_monitor.sides
+#define WHEEL_RIGHT         0x02
+
+typedef enum
+{
+    WHEEL_OK = 0,
+    WHEEL_STALL,
+    WHEEL_ENCODER,
+    WHEEL_SLIP,
+    NUM_WHEEL_CONDITIONS
+} wheel_condition_t;
+
+typedef struct
+{
+    int32_t rate[2];            // counts/s over the last window, left and right
+    float power[2];             // power driven with at the end of the window
+    wheel_condition_t condition;    // reported and still present
+    uint8_t sides;              // WHEEL_LEFT, WHEEL_RIGHT: the wheels it is about
+    uint32_t seen[NUM_WHEEL_CONDITIONS];    // times each was reported
+} wheel_monitor_t;
+
+extern float wheel_min_power;
+extern int32_t wheel_stall_rate;
+extern float wheel_slip_ratio;
+extern uint8_t wheel_confirm_windows;
+extern float wheel_stall_power;
+
+extern wheel_monitor_t wheel_monitor;
+
+void wheel_init(void);
+void wheel_tick(void);
+wheel_condition_t wheel_event(void);
+
+#endif /* WHEELMONITOR_H_ */